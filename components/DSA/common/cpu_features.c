@@ -0,0 +1,56 @@
+#include "cpu_features.h"
+
+#ifdef CPU_FEATURES_X86
+#include <cpuid.h>
+
+#define CPU_DETECTED 1
+#define CPU_AVX2     2
+#define CPU_SHANI    4
+
+/* Detected on first use, which may be on several threads at once (SPHINCS+
+ * signs on two). They all detect and store the same value, so relaxed
+ * atomics are enough to make that race well defined. */
+static int cpu_features;
+
+static int cpu_detect(void) {
+    unsigned int a, b, c, d;
+    unsigned int xcr0_lo, xcr0_hi;
+    int features = CPU_DETECTED;
+    int avx = 0, ssse3_sse41 = 0;
+
+    if (__get_cpuid(1, &a, &b, &c, &d)) {
+        ssse3_sse41 = (c & bit_SSSE3) && (c & bit_SSE4_1);
+        if ((c & bit_OSXSAVE) && (c & bit_AVX)) {
+            __asm__("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+            avx = (xcr0_lo & 6) == 6; /* XMM and YMM state */
+        }
+    }
+    if (__get_cpuid_count(7, 0, &a, &b, &c, &d)) {
+        if (avx && (b & bit_AVX2)) {
+            features |= CPU_AVX2;
+        }
+        if (ssse3_sse41 && (b & bit_SHA)) {
+            features |= CPU_SHANI;
+        }
+    }
+    return features;
+}
+
+static int cpu_get_features(void) {
+    int features = __atomic_load_n(&cpu_features, __ATOMIC_RELAXED);
+
+    if (features == 0) {
+        features = cpu_detect();
+        __atomic_store_n(&cpu_features, features, __ATOMIC_RELAXED);
+    }
+    return features;
+}
+
+int cpu_has_avx2(void) {
+    return (cpu_get_features() & CPU_AVX2) != 0;
+}
+
+int cpu_has_shani(void) {
+    return (cpu_get_features() & CPU_SHANI) != 0;
+}
+#endif
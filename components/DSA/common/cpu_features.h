@@ -0,0 +1,17 @@
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+/* Instruction set extensions of the CPU, for the kernels that pick an
+ * implementation at run time. Only x86_64 host builds have any. */
+
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(ESP_PLATFORM)
+#define CPU_FEATURES_X86
+
+/* Nonzero if the CPU has AVX2 and the OS saves the YMM registers */
+int cpu_has_avx2(void);
+
+/* Nonzero if the CPU has the SHA extensions, with SSSE3 and SSE4.1 */
+int cpu_has_shani(void);
+#endif
+
+#endif
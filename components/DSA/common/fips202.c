@@ -10,10 +10,42 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "cpu_features.h"
 #include "fips202.h"
 
 #define NROUNDS 24
+
+#ifdef CONFIG_DSA_KECCAK_HEAP_STATE
+#define KECCAK_CTX_ALLOC(state, bytes)      \
+    do {                                    \
+        (state)->ctx = malloc(bytes);       \
+        if ((state)->ctx == NULL) {         \
+            exit(111);                      \
+        }                                   \
+    } while (0)
+#define KECCAK_CTX_FREE(state) free((state)->ctx)
+#else
+#define KECCAK_CTX_ALLOC(state, bytes) ((void)(state))
+#define KECCAK_CTX_FREE(state) ((void)(state))
+#endif
 #define ROL(a, offset) (((a) << (offset)) ^ ((a) >> (64 - (offset))))
+#define ROL32(a, offset) (((a) << (offset)) ^ ((a) >> (32 - (offset))))
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+/* Lanes are stored little-endian, so on little-endian targets (Xtensa,
+ * RISC-V and x86 all are) a lane is just the next 8 bytes of the buffer. */
+#define KECCAK_LITTLE_ENDIAN
+#endif
+
+#ifdef CPU_FEATURES_X86
+/* 4-way permutation with AVX2, chosen at run time; see the x4 API below */
+#define KECCAK_X4_AVX2
+#include <immintrin.h>
+#endif
+
+/* Buffers aligned on this many bytes take the word-wise paths below. A
+ * 32-bit core loads a lane as two words, so 4 is enough there. */
+#define KECCAK_WORD_ALIGN 4
 
 /*************************************************
  * Name:        load64
@@ -26,9 +58,13 @@
  **************************************************/
 static uint64_t load64(const uint8_t *x) {
     uint64_t r = 0;
+#ifdef KECCAK_LITTLE_ENDIAN
+    memcpy(&r, x, sizeof(r));
+#else
     for (size_t i = 0; i < 8; ++i) {
         r |= (uint64_t)x[i] << 8 * i;
     }
+#endif
 
     return r;
 }
@@ -42,11 +78,73 @@ static uint64_t load64(const uint8_t *x) {
  *              - uint64_t u: input 64-bit unsigned integer
  **************************************************/
 static void store64(uint8_t *x, uint64_t u) {
+#ifdef KECCAK_LITTLE_ENDIAN
+    memcpy(x, &u, sizeof(u));
+#else
     for (size_t i = 0; i < 8; ++i) {
         x[i] = (uint8_t) (u >> 8 * i);
     }
+#endif
+}
+
+/*************************************************
+ * Name:        xor_lanes
+ *
+ * Description: XOR nlanes little-endian 64-bit words from m into s. When m
+ *              is word-aligned on a little-endian target the words are
+ *              loaded directly; otherwise byte by byte.
+ *
+ * Arguments:   - uint64_t *s: pointer to the first state lane to update
+ *              - const uint8_t *m: pointer to 8 * nlanes input bytes
+ *              - size_t nlanes: number of lanes
+ **************************************************/
+static void xor_lanes(uint64_t *s, const uint8_t *m, size_t nlanes) {
+    size_t i;
+
+#ifdef KECCAK_LITTLE_ENDIAN
+    if (((uintptr_t)m % KECCAK_WORD_ALIGN) == 0) {
+        const uint8_t *w = __builtin_assume_aligned(m, KECCAK_WORD_ALIGN);
+        for (i = 0; i < nlanes; ++i) {
+            uint64_t t;
+            memcpy(&t, w + 8 * i, sizeof(t));
+            s[i] ^= t;
+        }
+        return;
+    }
+#endif
+    for (i = 0; i < nlanes; ++i) {
+        s[i] ^= load64(m + 8 * i);
+    }
 }
 
+/*************************************************
+ * Name:        store_lanes
+ *
+ * Description: Write nlanes state lanes to h in little-endian order, word
+ *              by word when h is word-aligned on a little-endian target.
+ *
+ * Arguments:   - uint8_t *h: pointer to 8 * nlanes output bytes
+ *              - const uint64_t *s: pointer to the first state lane
+ *              - size_t nlanes: number of lanes
+ **************************************************/
+static void store_lanes(uint8_t *h, const uint64_t *s, size_t nlanes) {
+    size_t i;
+
+#ifdef KECCAK_LITTLE_ENDIAN
+    if (((uintptr_t)h % KECCAK_WORD_ALIGN) == 0) {
+        uint8_t *w = __builtin_assume_aligned(h, KECCAK_WORD_ALIGN);
+        for (i = 0; i < nlanes; ++i) {
+            memcpy(w + 8 * i, &s[i], sizeof(s[i]));
+        }
+        return;
+    }
+#endif
+    for (i = 0; i < nlanes; ++i) {
+        store64(h + 8 * i, s[i]);
+    }
+}
+
+#if !defined(CONFIG_DSA_KECCAK_INTERLEAVED) || defined(KECCAK_X4_AVX2)
 /* Keccak round constants */
 static const uint64_t KeccakF_RoundConstants[NROUNDS] = {
     0x0000000000000001ULL, 0x0000000000008082ULL,
@@ -62,6 +160,504 @@ static const uint64_t KeccakF_RoundConstants[NROUNDS] = {
     0x8000000080008081ULL, 0x8000000000008080ULL,
     0x0000000080000001ULL, 0x8000000080008008ULL
 };
+#endif
+
+#ifdef CONFIG_DSA_KECCAK_INTERLEAVED
+/* Keccak round constants, bit-interleaved: {even bits, odd bits} */
+static const uint32_t KeccakF_RoundConstants32[NROUNDS][2] = {
+    {0x00000001UL, 0x00000000UL}, {0x00000000UL, 0x00000089UL},
+    {0x00000000UL, 0x8000008bUL}, {0x00000000UL, 0x80008080UL},
+    {0x00000001UL, 0x0000008bUL}, {0x00000001UL, 0x00008000UL},
+    {0x00000001UL, 0x80008088UL}, {0x00000001UL, 0x80000082UL},
+    {0x00000000UL, 0x0000000bUL}, {0x00000000UL, 0x0000000aUL},
+    {0x00000001UL, 0x00008082UL}, {0x00000000UL, 0x00008003UL},
+    {0x00000001UL, 0x0000808bUL}, {0x00000001UL, 0x8000000bUL},
+    {0x00000001UL, 0x8000008aUL}, {0x00000001UL, 0x80000081UL},
+    {0x00000000UL, 0x80000081UL}, {0x00000000UL, 0x80000008UL},
+    {0x00000000UL, 0x00000083UL}, {0x00000000UL, 0x80008003UL},
+    {0x00000001UL, 0x80008088UL}, {0x00000000UL, 0x80000088UL},
+    {0x00000001UL, 0x00008000UL}, {0x00000000UL, 0x80008082UL}
+};
+
+/*************************************************
+ * Name:        to_interleaved
+ *
+ * Description: Split a 64-bit lane into its even bits (*even) and odd bits
+ *              (*odd). In this form a 64-bit rotation is two 32-bit
+ *              rotations, which is what makes the permutation cheap on
+ *              32-bit cores.
+ **************************************************/
+static void to_interleaved(uint32_t *even, uint32_t *odd, uint64_t lane) {
+    uint32_t lo = (uint32_t)lane;
+    uint32_t hi = (uint32_t)(lane >> 32);
+    uint32_t t;
+
+    t = (lo ^ (lo >> 1)) & 0x22222222UL; lo ^= t ^ (t << 1);
+    t = (lo ^ (lo >> 2)) & 0x0C0C0C0CUL; lo ^= t ^ (t << 2);
+    t = (lo ^ (lo >> 4)) & 0x00F000F0UL; lo ^= t ^ (t << 4);
+    t = (lo ^ (lo >> 8)) & 0x0000FF00UL; lo ^= t ^ (t << 8);
+    t = (hi ^ (hi >> 1)) & 0x22222222UL; hi ^= t ^ (t << 1);
+    t = (hi ^ (hi >> 2)) & 0x0C0C0C0CUL; hi ^= t ^ (t << 2);
+    t = (hi ^ (hi >> 4)) & 0x00F000F0UL; hi ^= t ^ (t << 4);
+    t = (hi ^ (hi >> 8)) & 0x0000FF00UL; hi ^= t ^ (t << 8);
+    *even = (lo & 0x0000FFFFUL) | (hi << 16);
+    *odd = (lo >> 16) | (hi & 0xFFFF0000UL);
+}
+
+/*************************************************
+ * Name:        from_interleaved
+ *
+ * Description: Inverse of to_interleaved.
+ **************************************************/
+static uint64_t from_interleaved(uint32_t even, uint32_t odd) {
+    uint32_t lo = (even & 0x0000FFFFUL) | (odd << 16);
+    uint32_t hi = (even >> 16) | (odd & 0xFFFF0000UL);
+    uint32_t t;
+
+    t = (lo ^ (lo >> 8)) & 0x0000FF00UL; lo ^= t ^ (t << 8);
+    t = (lo ^ (lo >> 4)) & 0x00F000F0UL; lo ^= t ^ (t << 4);
+    t = (lo ^ (lo >> 2)) & 0x0C0C0C0CUL; lo ^= t ^ (t << 2);
+    t = (lo ^ (lo >> 1)) & 0x22222222UL; lo ^= t ^ (t << 1);
+    t = (hi ^ (hi >> 8)) & 0x0000FF00UL; hi ^= t ^ (t << 8);
+    t = (hi ^ (hi >> 4)) & 0x00F000F0UL; hi ^= t ^ (t << 4);
+    t = (hi ^ (hi >> 2)) & 0x0C0C0C0CUL; hi ^= t ^ (t << 2);
+    t = (hi ^ (hi >> 1)) & 0x22222222UL; hi ^= t ^ (t << 1);
+    return (uint64_t)lo | ((uint64_t)hi << 32);
+}
+
+/*************************************************
+ * Name:        KeccakF1600_StatePermute
+ *
+ * Description: The Keccak F1600 Permutation, bit-interleaved 32-bit
+ *              implementation. The state stays in the standard 64-bit
+ *              lane layout between calls; lanes are converted on entry and
+ *              exit, and each of them is held as an (even, odd) pair of
+ *              32-bit words in between.
+ *
+ * Arguments:   - uint64_t *state: pointer to input/output Keccak state
+ **************************************************/
+static void KeccakF1600_StatePermute(uint64_t *state) {
+    int round;
+
+    uint32_t Aba0, Aba1, Abe0, Abe1, Abi0, Abi1, Abo0, Abo1, Abu0, Abu1;
+    uint32_t Aga0, Aga1, Age0, Age1, Agi0, Agi1, Ago0, Ago1, Agu0, Agu1;
+    uint32_t Aka0, Aka1, Ake0, Ake1, Aki0, Aki1, Ako0, Ako1, Aku0, Aku1;
+    uint32_t Ama0, Ama1, Ame0, Ame1, Ami0, Ami1, Amo0, Amo1, Amu0, Amu1;
+    uint32_t Asa0, Asa1, Ase0, Ase1, Asi0, Asi1, Aso0, Aso1, Asu0, Asu1;
+    uint32_t BCa0, BCa1, BCe0, BCe1, BCi0, BCi1, BCo0, BCo1, BCu0, BCu1;
+    uint32_t Da0, Da1, De0, De1, Di0, Di1, Do0, Do1, Du0, Du1;
+    uint32_t Eba0, Eba1, Ebe0, Ebe1, Ebi0, Ebi1, Ebo0, Ebo1, Ebu0, Ebu1;
+    uint32_t Ega0, Ega1, Ege0, Ege1, Egi0, Egi1, Ego0, Ego1, Egu0, Egu1;
+    uint32_t Eka0, Eka1, Eke0, Eke1, Eki0, Eki1, Eko0, Eko1, Eku0, Eku1;
+    uint32_t Ema0, Ema1, Eme0, Eme1, Emi0, Emi1, Emo0, Emo1, Emu0, Emu1;
+    uint32_t Esa0, Esa1, Ese0, Ese1, Esi0, Esi1, Eso0, Eso1, Esu0, Esu1;
+
+    // copyFromState(A, state), converting each lane to bit-interleaved form
+    to_interleaved(&Aba0, &Aba1, state[0]);
+    to_interleaved(&Abe0, &Abe1, state[1]);
+    to_interleaved(&Abi0, &Abi1, state[2]);
+    to_interleaved(&Abo0, &Abo1, state[3]);
+    to_interleaved(&Abu0, &Abu1, state[4]);
+    to_interleaved(&Aga0, &Aga1, state[5]);
+    to_interleaved(&Age0, &Age1, state[6]);
+    to_interleaved(&Agi0, &Agi1, state[7]);
+    to_interleaved(&Ago0, &Ago1, state[8]);
+    to_interleaved(&Agu0, &Agu1, state[9]);
+    to_interleaved(&Aka0, &Aka1, state[10]);
+    to_interleaved(&Ake0, &Ake1, state[11]);
+    to_interleaved(&Aki0, &Aki1, state[12]);
+    to_interleaved(&Ako0, &Ako1, state[13]);
+    to_interleaved(&Aku0, &Aku1, state[14]);
+    to_interleaved(&Ama0, &Ama1, state[15]);
+    to_interleaved(&Ame0, &Ame1, state[16]);
+    to_interleaved(&Ami0, &Ami1, state[17]);
+    to_interleaved(&Amo0, &Amo1, state[18]);
+    to_interleaved(&Amu0, &Amu1, state[19]);
+    to_interleaved(&Asa0, &Asa1, state[20]);
+    to_interleaved(&Ase0, &Ase1, state[21]);
+    to_interleaved(&Asi0, &Asi1, state[22]);
+    to_interleaved(&Aso0, &Aso1, state[23]);
+    to_interleaved(&Asu0, &Asu1, state[24]);
+
+    for (round = 0; round < NROUNDS; round += 2) {
+        // thetaRhoPiChiIotaPrepareTheta(round, A, E)
+        BCa0 = Aba0 ^ Aga0 ^ Aka0 ^ Ama0 ^ Asa0;
+        BCa1 = Aba1 ^ Aga1 ^ Aka1 ^ Ama1 ^ Asa1;
+        BCe0 = Abe0 ^ Age0 ^ Ake0 ^ Ame0 ^ Ase0;
+        BCe1 = Abe1 ^ Age1 ^ Ake1 ^ Ame1 ^ Ase1;
+        BCi0 = Abi0 ^ Agi0 ^ Aki0 ^ Ami0 ^ Asi0;
+        BCi1 = Abi1 ^ Agi1 ^ Aki1 ^ Ami1 ^ Asi1;
+        BCo0 = Abo0 ^ Ago0 ^ Ako0 ^ Amo0 ^ Aso0;
+        BCo1 = Abo1 ^ Ago1 ^ Ako1 ^ Amo1 ^ Aso1;
+        BCu0 = Abu0 ^ Agu0 ^ Aku0 ^ Amu0 ^ Asu0;
+        BCu1 = Abu1 ^ Agu1 ^ Aku1 ^ Amu1 ^ Asu1;
+        Da0 = BCu0 ^ ROL32(BCe1, 1);
+        Da1 = BCu1 ^ BCe0;
+        De0 = BCa0 ^ ROL32(BCi1, 1);
+        De1 = BCa1 ^ BCi0;
+        Di0 = BCe0 ^ ROL32(BCo1, 1);
+        Di1 = BCe1 ^ BCo0;
+        Do0 = BCi0 ^ ROL32(BCu1, 1);
+        Do1 = BCi1 ^ BCu0;
+        Du0 = BCo0 ^ ROL32(BCa1, 1);
+        Du1 = BCo1 ^ BCa0;
+        Aba0 ^= Da0;
+        Aba1 ^= Da1;
+        BCa0 = Aba0;
+        BCa1 = Aba1;
+        Age0 ^= De0;
+        Age1 ^= De1;
+        BCe0 = ROL32(Age0, 22);
+        BCe1 = ROL32(Age1, 22);
+        Aki0 ^= Di0;
+        Aki1 ^= Di1;
+        BCi0 = ROL32(Aki1, 22);
+        BCi1 = ROL32(Aki0, 21);
+        Amo0 ^= Do0;
+        Amo1 ^= Do1;
+        BCo0 = ROL32(Amo1, 11);
+        BCo1 = ROL32(Amo0, 10);
+        Asu0 ^= Du0;
+        Asu1 ^= Du1;
+        BCu0 = ROL32(Asu0, 7);
+        BCu1 = ROL32(Asu1, 7);
+        Eba0 = BCa0 ^ ((~BCe0) & BCi0);
+        Eba1 = BCa1 ^ ((~BCe1) & BCi1);
+        Ebe0 = BCe0 ^ ((~BCi0) & BCo0);
+        Ebe1 = BCe1 ^ ((~BCi1) & BCo1);
+        Ebi0 = BCi0 ^ ((~BCo0) & BCu0);
+        Ebi1 = BCi1 ^ ((~BCo1) & BCu1);
+        Ebo0 = BCo0 ^ ((~BCu0) & BCa0);
+        Ebo1 = BCo1 ^ ((~BCu1) & BCa1);
+        Ebu0 = BCu0 ^ ((~BCa0) & BCe0);
+        Ebu1 = BCu1 ^ ((~BCa1) & BCe1);
+        Eba0 ^= KeccakF_RoundConstants32[round][0];
+        Eba1 ^= KeccakF_RoundConstants32[round][1];
+        Abo0 ^= Do0;
+        Abo1 ^= Do1;
+        BCa0 = ROL32(Abo0, 14);
+        BCa1 = ROL32(Abo1, 14);
+        Agu0 ^= Du0;
+        Agu1 ^= Du1;
+        BCe0 = ROL32(Agu0, 10);
+        BCe1 = ROL32(Agu1, 10);
+        Aka0 ^= Da0;
+        Aka1 ^= Da1;
+        BCi0 = ROL32(Aka1, 2);
+        BCi1 = ROL32(Aka0, 1);
+        Ame0 ^= De0;
+        Ame1 ^= De1;
+        BCo0 = ROL32(Ame1, 23);
+        BCo1 = ROL32(Ame0, 22);
+        Asi0 ^= Di0;
+        Asi1 ^= Di1;
+        BCu0 = ROL32(Asi1, 31);
+        BCu1 = ROL32(Asi0, 30);
+        Ega0 = BCa0 ^ ((~BCe0) & BCi0);
+        Ega1 = BCa1 ^ ((~BCe1) & BCi1);
+        Ege0 = BCe0 ^ ((~BCi0) & BCo0);
+        Ege1 = BCe1 ^ ((~BCi1) & BCo1);
+        Egi0 = BCi0 ^ ((~BCo0) & BCu0);
+        Egi1 = BCi1 ^ ((~BCo1) & BCu1);
+        Ego0 = BCo0 ^ ((~BCu0) & BCa0);
+        Ego1 = BCo1 ^ ((~BCu1) & BCa1);
+        Egu0 = BCu0 ^ ((~BCa0) & BCe0);
+        Egu1 = BCu1 ^ ((~BCa1) & BCe1);
+        Abe0 ^= De0;
+        Abe1 ^= De1;
+        BCa0 = ROL32(Abe1, 1);
+        BCa1 = Abe0;
+        Agi0 ^= Di0;
+        Agi1 ^= Di1;
+        BCe0 = ROL32(Agi0, 3);
+        BCe1 = ROL32(Agi1, 3);
+        Ako0 ^= Do0;
+        Ako1 ^= Do1;
+        BCi0 = ROL32(Ako1, 13);
+        BCi1 = ROL32(Ako0, 12);
+        Amu0 ^= Du0;
+        Amu1 ^= Du1;
+        BCo0 = ROL32(Amu0, 4);
+        BCo1 = ROL32(Amu1, 4);
+        Asa0 ^= Da0;
+        Asa1 ^= Da1;
+        BCu0 = ROL32(Asa0, 9);
+        BCu1 = ROL32(Asa1, 9);
+        Eka0 = BCa0 ^ ((~BCe0) & BCi0);
+        Eka1 = BCa1 ^ ((~BCe1) & BCi1);
+        Eke0 = BCe0 ^ ((~BCi0) & BCo0);
+        Eke1 = BCe1 ^ ((~BCi1) & BCo1);
+        Eki0 = BCi0 ^ ((~BCo0) & BCu0);
+        Eki1 = BCi1 ^ ((~BCo1) & BCu1);
+        Eko0 = BCo0 ^ ((~BCu0) & BCa0);
+        Eko1 = BCo1 ^ ((~BCu1) & BCa1);
+        Eku0 = BCu0 ^ ((~BCa0) & BCe0);
+        Eku1 = BCu1 ^ ((~BCa1) & BCe1);
+        Abu0 ^= Du0;
+        Abu1 ^= Du1;
+        BCa0 = ROL32(Abu1, 14);
+        BCa1 = ROL32(Abu0, 13);
+        Aga0 ^= Da0;
+        Aga1 ^= Da1;
+        BCe0 = ROL32(Aga0, 18);
+        BCe1 = ROL32(Aga1, 18);
+        Ake0 ^= De0;
+        Ake1 ^= De1;
+        BCi0 = ROL32(Ake0, 5);
+        BCi1 = ROL32(Ake1, 5);
+        Ami0 ^= Di0;
+        Ami1 ^= Di1;
+        BCo0 = ROL32(Ami1, 8);
+        BCo1 = ROL32(Ami0, 7);
+        Aso0 ^= Do0;
+        Aso1 ^= Do1;
+        BCu0 = ROL32(Aso0, 28);
+        BCu1 = ROL32(Aso1, 28);
+        Ema0 = BCa0 ^ ((~BCe0) & BCi0);
+        Ema1 = BCa1 ^ ((~BCe1) & BCi1);
+        Eme0 = BCe0 ^ ((~BCi0) & BCo0);
+        Eme1 = BCe1 ^ ((~BCi1) & BCo1);
+        Emi0 = BCi0 ^ ((~BCo0) & BCu0);
+        Emi1 = BCi1 ^ ((~BCo1) & BCu1);
+        Emo0 = BCo0 ^ ((~BCu0) & BCa0);
+        Emo1 = BCo1 ^ ((~BCu1) & BCa1);
+        Emu0 = BCu0 ^ ((~BCa0) & BCe0);
+        Emu1 = BCu1 ^ ((~BCa1) & BCe1);
+        Abi0 ^= Di0;
+        Abi1 ^= Di1;
+        BCa0 = ROL32(Abi0, 31);
+        BCa1 = ROL32(Abi1, 31);
+        Ago0 ^= Do0;
+        Ago1 ^= Do1;
+        BCe0 = ROL32(Ago1, 28);
+        BCe1 = ROL32(Ago0, 27);
+        Aku0 ^= Du0;
+        Aku1 ^= Du1;
+        BCi0 = ROL32(Aku1, 20);
+        BCi1 = ROL32(Aku0, 19);
+        Ama0 ^= Da0;
+        Ama1 ^= Da1;
+        BCo0 = ROL32(Ama1, 21);
+        BCo1 = ROL32(Ama0, 20);
+        Ase0 ^= De0;
+        Ase1 ^= De1;
+        BCu0 = ROL32(Ase0, 1);
+        BCu1 = ROL32(Ase1, 1);
+        Esa0 = BCa0 ^ ((~BCe0) & BCi0);
+        Esa1 = BCa1 ^ ((~BCe1) & BCi1);
+        Ese0 = BCe0 ^ ((~BCi0) & BCo0);
+        Ese1 = BCe1 ^ ((~BCi1) & BCo1);
+        Esi0 = BCi0 ^ ((~BCo0) & BCu0);
+        Esi1 = BCi1 ^ ((~BCo1) & BCu1);
+        Eso0 = BCo0 ^ ((~BCu0) & BCa0);
+        Eso1 = BCo1 ^ ((~BCu1) & BCa1);
+        Esu0 = BCu0 ^ ((~BCa0) & BCe0);
+        Esu1 = BCu1 ^ ((~BCa1) & BCe1);
+
+        // thetaRhoPiChiIotaPrepareTheta(round+1, E, A)
+        BCa0 = Eba0 ^ Ega0 ^ Eka0 ^ Ema0 ^ Esa0;
+        BCa1 = Eba1 ^ Ega1 ^ Eka1 ^ Ema1 ^ Esa1;
+        BCe0 = Ebe0 ^ Ege0 ^ Eke0 ^ Eme0 ^ Ese0;
+        BCe1 = Ebe1 ^ Ege1 ^ Eke1 ^ Eme1 ^ Ese1;
+        BCi0 = Ebi0 ^ Egi0 ^ Eki0 ^ Emi0 ^ Esi0;
+        BCi1 = Ebi1 ^ Egi1 ^ Eki1 ^ Emi1 ^ Esi1;
+        BCo0 = Ebo0 ^ Ego0 ^ Eko0 ^ Emo0 ^ Eso0;
+        BCo1 = Ebo1 ^ Ego1 ^ Eko1 ^ Emo1 ^ Eso1;
+        BCu0 = Ebu0 ^ Egu0 ^ Eku0 ^ Emu0 ^ Esu0;
+        BCu1 = Ebu1 ^ Egu1 ^ Eku1 ^ Emu1 ^ Esu1;
+        Da0 = BCu0 ^ ROL32(BCe1, 1);
+        Da1 = BCu1 ^ BCe0;
+        De0 = BCa0 ^ ROL32(BCi1, 1);
+        De1 = BCa1 ^ BCi0;
+        Di0 = BCe0 ^ ROL32(BCo1, 1);
+        Di1 = BCe1 ^ BCo0;
+        Do0 = BCi0 ^ ROL32(BCu1, 1);
+        Do1 = BCi1 ^ BCu0;
+        Du0 = BCo0 ^ ROL32(BCa1, 1);
+        Du1 = BCo1 ^ BCa0;
+        Eba0 ^= Da0;
+        Eba1 ^= Da1;
+        BCa0 = Eba0;
+        BCa1 = Eba1;
+        Ege0 ^= De0;
+        Ege1 ^= De1;
+        BCe0 = ROL32(Ege0, 22);
+        BCe1 = ROL32(Ege1, 22);
+        Eki0 ^= Di0;
+        Eki1 ^= Di1;
+        BCi0 = ROL32(Eki1, 22);
+        BCi1 = ROL32(Eki0, 21);
+        Emo0 ^= Do0;
+        Emo1 ^= Do1;
+        BCo0 = ROL32(Emo1, 11);
+        BCo1 = ROL32(Emo0, 10);
+        Esu0 ^= Du0;
+        Esu1 ^= Du1;
+        BCu0 = ROL32(Esu0, 7);
+        BCu1 = ROL32(Esu1, 7);
+        Aba0 = BCa0 ^ ((~BCe0) & BCi0);
+        Aba1 = BCa1 ^ ((~BCe1) & BCi1);
+        Abe0 = BCe0 ^ ((~BCi0) & BCo0);
+        Abe1 = BCe1 ^ ((~BCi1) & BCo1);
+        Abi0 = BCi0 ^ ((~BCo0) & BCu0);
+        Abi1 = BCi1 ^ ((~BCo1) & BCu1);
+        Abo0 = BCo0 ^ ((~BCu0) & BCa0);
+        Abo1 = BCo1 ^ ((~BCu1) & BCa1);
+        Abu0 = BCu0 ^ ((~BCa0) & BCe0);
+        Abu1 = BCu1 ^ ((~BCa1) & BCe1);
+        Aba0 ^= KeccakF_RoundConstants32[round + 1][0];
+        Aba1 ^= KeccakF_RoundConstants32[round + 1][1];
+        Ebo0 ^= Do0;
+        Ebo1 ^= Do1;
+        BCa0 = ROL32(Ebo0, 14);
+        BCa1 = ROL32(Ebo1, 14);
+        Egu0 ^= Du0;
+        Egu1 ^= Du1;
+        BCe0 = ROL32(Egu0, 10);
+        BCe1 = ROL32(Egu1, 10);
+        Eka0 ^= Da0;
+        Eka1 ^= Da1;
+        BCi0 = ROL32(Eka1, 2);
+        BCi1 = ROL32(Eka0, 1);
+        Eme0 ^= De0;
+        Eme1 ^= De1;
+        BCo0 = ROL32(Eme1, 23);
+        BCo1 = ROL32(Eme0, 22);
+        Esi0 ^= Di0;
+        Esi1 ^= Di1;
+        BCu0 = ROL32(Esi1, 31);
+        BCu1 = ROL32(Esi0, 30);
+        Aga0 = BCa0 ^ ((~BCe0) & BCi0);
+        Aga1 = BCa1 ^ ((~BCe1) & BCi1);
+        Age0 = BCe0 ^ ((~BCi0) & BCo0);
+        Age1 = BCe1 ^ ((~BCi1) & BCo1);
+        Agi0 = BCi0 ^ ((~BCo0) & BCu0);
+        Agi1 = BCi1 ^ ((~BCo1) & BCu1);
+        Ago0 = BCo0 ^ ((~BCu0) & BCa0);
+        Ago1 = BCo1 ^ ((~BCu1) & BCa1);
+        Agu0 = BCu0 ^ ((~BCa0) & BCe0);
+        Agu1 = BCu1 ^ ((~BCa1) & BCe1);
+        Ebe0 ^= De0;
+        Ebe1 ^= De1;
+        BCa0 = ROL32(Ebe1, 1);
+        BCa1 = Ebe0;
+        Egi0 ^= Di0;
+        Egi1 ^= Di1;
+        BCe0 = ROL32(Egi0, 3);
+        BCe1 = ROL32(Egi1, 3);
+        Eko0 ^= Do0;
+        Eko1 ^= Do1;
+        BCi0 = ROL32(Eko1, 13);
+        BCi1 = ROL32(Eko0, 12);
+        Emu0 ^= Du0;
+        Emu1 ^= Du1;
+        BCo0 = ROL32(Emu0, 4);
+        BCo1 = ROL32(Emu1, 4);
+        Esa0 ^= Da0;
+        Esa1 ^= Da1;
+        BCu0 = ROL32(Esa0, 9);
+        BCu1 = ROL32(Esa1, 9);
+        Aka0 = BCa0 ^ ((~BCe0) & BCi0);
+        Aka1 = BCa1 ^ ((~BCe1) & BCi1);
+        Ake0 = BCe0 ^ ((~BCi0) & BCo0);
+        Ake1 = BCe1 ^ ((~BCi1) & BCo1);
+        Aki0 = BCi0 ^ ((~BCo0) & BCu0);
+        Aki1 = BCi1 ^ ((~BCo1) & BCu1);
+        Ako0 = BCo0 ^ ((~BCu0) & BCa0);
+        Ako1 = BCo1 ^ ((~BCu1) & BCa1);
+        Aku0 = BCu0 ^ ((~BCa0) & BCe0);
+        Aku1 = BCu1 ^ ((~BCa1) & BCe1);
+        Ebu0 ^= Du0;
+        Ebu1 ^= Du1;
+        BCa0 = ROL32(Ebu1, 14);
+        BCa1 = ROL32(Ebu0, 13);
+        Ega0 ^= Da0;
+        Ega1 ^= Da1;
+        BCe0 = ROL32(Ega0, 18);
+        BCe1 = ROL32(Ega1, 18);
+        Eke0 ^= De0;
+        Eke1 ^= De1;
+        BCi0 = ROL32(Eke0, 5);
+        BCi1 = ROL32(Eke1, 5);
+        Emi0 ^= Di0;
+        Emi1 ^= Di1;
+        BCo0 = ROL32(Emi1, 8);
+        BCo1 = ROL32(Emi0, 7);
+        Eso0 ^= Do0;
+        Eso1 ^= Do1;
+        BCu0 = ROL32(Eso0, 28);
+        BCu1 = ROL32(Eso1, 28);
+        Ama0 = BCa0 ^ ((~BCe0) & BCi0);
+        Ama1 = BCa1 ^ ((~BCe1) & BCi1);
+        Ame0 = BCe0 ^ ((~BCi0) & BCo0);
+        Ame1 = BCe1 ^ ((~BCi1) & BCo1);
+        Ami0 = BCi0 ^ ((~BCo0) & BCu0);
+        Ami1 = BCi1 ^ ((~BCo1) & BCu1);
+        Amo0 = BCo0 ^ ((~BCu0) & BCa0);
+        Amo1 = BCo1 ^ ((~BCu1) & BCa1);
+        Amu0 = BCu0 ^ ((~BCa0) & BCe0);
+        Amu1 = BCu1 ^ ((~BCa1) & BCe1);
+        Ebi0 ^= Di0;
+        Ebi1 ^= Di1;
+        BCa0 = ROL32(Ebi0, 31);
+        BCa1 = ROL32(Ebi1, 31);
+        Ego0 ^= Do0;
+        Ego1 ^= Do1;
+        BCe0 = ROL32(Ego1, 28);
+        BCe1 = ROL32(Ego0, 27);
+        Eku0 ^= Du0;
+        Eku1 ^= Du1;
+        BCi0 = ROL32(Eku1, 20);
+        BCi1 = ROL32(Eku0, 19);
+        Ema0 ^= Da0;
+        Ema1 ^= Da1;
+        BCo0 = ROL32(Ema1, 21);
+        BCo1 = ROL32(Ema0, 20);
+        Ese0 ^= De0;
+        Ese1 ^= De1;
+        BCu0 = ROL32(Ese0, 1);
+        BCu1 = ROL32(Ese1, 1);
+        Asa0 = BCa0 ^ ((~BCe0) & BCi0);
+        Asa1 = BCa1 ^ ((~BCe1) & BCi1);
+        Ase0 = BCe0 ^ ((~BCi0) & BCo0);
+        Ase1 = BCe1 ^ ((~BCi1) & BCo1);
+        Asi0 = BCi0 ^ ((~BCo0) & BCu0);
+        Asi1 = BCi1 ^ ((~BCo1) & BCu1);
+        Aso0 = BCo0 ^ ((~BCu0) & BCa0);
+        Aso1 = BCo1 ^ ((~BCu1) & BCa1);
+        Asu0 = BCu0 ^ ((~BCa0) & BCe0);
+        Asu1 = BCu1 ^ ((~BCa1) & BCe1);
+    }
+
+    // copyToState(state, A), back to the standard lane representation
+    state[0] = from_interleaved(Aba0, Aba1);
+    state[1] = from_interleaved(Abe0, Abe1);
+    state[2] = from_interleaved(Abi0, Abi1);
+    state[3] = from_interleaved(Abo0, Abo1);
+    state[4] = from_interleaved(Abu0, Abu1);
+    state[5] = from_interleaved(Aga0, Aga1);
+    state[6] = from_interleaved(Age0, Age1);
+    state[7] = from_interleaved(Agi0, Agi1);
+    state[8] = from_interleaved(Ago0, Ago1);
+    state[9] = from_interleaved(Agu0, Agu1);
+    state[10] = from_interleaved(Aka0, Aka1);
+    state[11] = from_interleaved(Ake0, Ake1);
+    state[12] = from_interleaved(Aki0, Aki1);
+    state[13] = from_interleaved(Ako0, Ako1);
+    state[14] = from_interleaved(Aku0, Aku1);
+    state[15] = from_interleaved(Ama0, Ama1);
+    state[16] = from_interleaved(Ame0, Ame1);
+    state[17] = from_interleaved(Ami0, Ami1);
+    state[18] = from_interleaved(Amo0, Amo1);
+    state[19] = from_interleaved(Amu0, Amu1);
+    state[20] = from_interleaved(Asa0, Asa1);
+    state[21] = from_interleaved(Ase0, Ase1);
+    state[22] = from_interleaved(Asi0, Asi1);
+    state[23] = from_interleaved(Aso0, Aso1);
+    state[24] = from_interleaved(Asu0, Asu1);
+}
+
+#else
 
 /*************************************************
  * Name:        KeccakF1600_StatePermute
@@ -333,6 +929,8 @@ static void KeccakF1600_StatePermute(uint64_t *state) {
     state[24] = Asu;
 }
 
+#endif // CONFIG_DSA_KECCAK_INTERLEAVED
+
 /*************************************************
  * Name:        keccak_absorb
  *
@@ -349,7 +947,6 @@ static void KeccakF1600_StatePermute(uint64_t *state) {
 static void keccak_absorb(uint64_t *s, uint32_t r, const uint8_t *m,
                           size_t mlen, uint8_t p) {
     size_t i;
-    uint8_t t[200];
 
     /* Zero state */
     for (i = 0; i < 25; ++i) {
@@ -357,26 +954,20 @@ static void keccak_absorb(uint64_t *s, uint32_t r, const uint8_t *m,
     }
 
     while (mlen >= r) {
-        for (i = 0; i < r / 8; ++i) {
-            s[i] ^= load64(m + 8 * i);
-        }
+        xor_lanes(s, m, r / 8);
 
         KeccakF1600_StatePermute(s);
         mlen -= r;
         m += r;
     }
 
-    for (i = 0; i < r; ++i) {
-        t[i] = 0;
-    }
-    for (i = 0; i < mlen; ++i) {
-        t[i] = m[i];
-    }
-    t[i] = p;
-    t[r - 1] |= 128;
-    for (i = 0; i < r / 8; ++i) {
-        s[i] ^= load64(t + 8 * i);
+    /* Last, partial block: whole lanes, then the remaining bytes */
+    xor_lanes(s, m, mlen / 8);
+    for (i = mlen & ~(size_t)7; i < mlen; ++i) {
+        s[i >> 3] ^= (uint64_t)m[i] << (8 * (i & 0x07));
     }
+    s[i >> 3] ^= (uint64_t)p << (8 * (i & 0x07));
+    s[(r - 1) >> 3] ^= (uint64_t)128 << (8 * ((r - 1) & 0x07));
 }
 
 /*************************************************
@@ -396,9 +987,7 @@ static void keccak_squeezeblocks(uint8_t *h, size_t nblocks,
                                  uint64_t *s, uint32_t r) {
     while (nblocks > 0) {
         KeccakF1600_StatePermute(s);
-        for (size_t i = 0; i < (r >> 3); i++) {
-            store64(h + 8 * i, s[i]);
-        }
+        store_lanes(h, s, r >> 3);
         h += r;
         nblocks--;
     }
@@ -439,26 +1028,34 @@ static void keccak_inc_init(uint64_t *s_inc) {
  **************************************************/
 static void keccak_inc_absorb(uint64_t *s_inc, uint32_t r, const uint8_t *m,
                               size_t mlen) {
-    size_t i;
-
     /* Recall that s_inc[25] is the non-absorbed bytes xored into the state */
-    while (mlen + s_inc[25] >= r) {
-        for (i = 0; i < r - (uint32_t)s_inc[25]; i++) {
-            /* Take the i'th byte from message
-               xor with the s_inc[25] + i'th byte of the state; little-endian */
-            s_inc[(s_inc[25] + i) >> 3] ^= (uint64_t)m[i] << (8 * ((s_inc[25] + i) & 0x07));
+    size_t pos = (size_t)s_inc[25];
+
+    while (mlen > 0) {
+        if ((pos & 0x07) == 0 && mlen >= 8) {
+            /* Lane-aligned position: XOR whole lanes up to the block end */
+            size_t n = (r - pos) / 8;
+            if (n > mlen / 8) {
+                n = mlen / 8;
+            }
+            xor_lanes(s_inc + (pos >> 3), m, n);
+            pos += 8 * n;
+            m += 8 * n;
+            mlen -= 8 * n;
+        } else {
+            /* Take the next byte from message
+               xor with the pos'th byte of the state; little-endian */
+            s_inc[pos >> 3] ^= (uint64_t)*m << (8 * (pos & 0x07));
+            pos++;
+            m++;
+            mlen--;
+        }
+        if (pos == r) {
+            KeccakF1600_StatePermute(s_inc);
+            pos = 0;
         }
-        mlen -= (size_t)(r - s_inc[25]);
-        m += r - s_inc[25];
-        s_inc[25] = 0;
-
-        KeccakF1600_StatePermute(s_inc);
-    }
-
-    for (i = 0; i < mlen; i++) {
-        s_inc[(s_inc[25] + i) >> 3] ^= (uint64_t)m[i] << (8 * ((s_inc[25] + i) & 0x07));
     }
-    s_inc[25] += mlen;
+    s_inc[25] = pos;
 }
 
 /*************************************************
@@ -513,7 +1110,9 @@ static void keccak_inc_squeeze(uint8_t *h, size_t outlen,
     while (outlen > 0) {
         KeccakF1600_StatePermute(s_inc);
 
-        for (i = 0; i < outlen && i < r; i++) {
+        i = (outlen < r ? outlen : r) & ~(size_t)7;
+        store_lanes(h, s_inc, i >> 3);
+        for (; i < outlen && i < r; i++) {
             h[i] = (uint8_t)(s_inc[i >> 3] >> (8 * (i & 0x07)));
         }
         h += i;
@@ -523,10 +1122,7 @@ static void keccak_inc_squeeze(uint8_t *h, size_t outlen,
 }
 
 void shake128_inc_init(shake128incctx *state) {
-    state->ctx = malloc(PQC_SHAKEINCCTX_BYTES);
-    if (state->ctx == NULL) {
-        exit(111);
-    }
+    KECCAK_CTX_ALLOC(state, PQC_SHAKEINCCTX_BYTES);
     keccak_inc_init(state->ctx);
 }
 
@@ -543,22 +1139,16 @@ void shake128_inc_squeeze(uint8_t *output, size_t outlen, shake128incctx *state)
 }
 
 void shake128_inc_ctx_clone(shake128incctx *dest, const shake128incctx *src) {
-    dest->ctx = malloc(PQC_SHAKEINCCTX_BYTES);
-    if (dest->ctx == NULL) {
-        exit(111);
-    }
+    KECCAK_CTX_ALLOC(dest, PQC_SHAKEINCCTX_BYTES);
     memcpy(dest->ctx, src->ctx, PQC_SHAKEINCCTX_BYTES);
 }
 
 void shake128_inc_ctx_release(shake128incctx *state) {
-    free(state->ctx);
+    KECCAK_CTX_FREE(state);
 }
 
 void shake256_inc_init(shake256incctx *state) {
-    state->ctx = malloc(PQC_SHAKEINCCTX_BYTES);
-    if (state->ctx == NULL) {
-        exit(111);
-    }
+    KECCAK_CTX_ALLOC(state, PQC_SHAKEINCCTX_BYTES);
     keccak_inc_init(state->ctx);
 }
 
@@ -575,15 +1165,12 @@ void shake256_inc_squeeze(uint8_t *output, size_t outlen, shake256incctx *state)
 }
 
 void shake256_inc_ctx_clone(shake256incctx *dest, const shake256incctx *src) {
-    dest->ctx = malloc(PQC_SHAKEINCCTX_BYTES);
-    if (dest->ctx == NULL) {
-        exit(111);
-    }
+    KECCAK_CTX_ALLOC(dest, PQC_SHAKEINCCTX_BYTES);
     memcpy(dest->ctx, src->ctx, PQC_SHAKEINCCTX_BYTES);
 }
 
 void shake256_inc_ctx_release(shake256incctx *state) {
-    free(state->ctx);
+    KECCAK_CTX_FREE(state);
 }
 
 /*************************************************
@@ -598,10 +1185,7 @@ void shake256_inc_ctx_release(shake256incctx *state) {
  *              - size_t inlen: length of input in bytes
  **************************************************/
 void shake128_absorb(shake128ctx *state, const uint8_t *input, size_t inlen) {
-    state->ctx = malloc(PQC_SHAKECTX_BYTES);
-    if (state->ctx == NULL) {
-        exit(111);
-    }
+    KECCAK_CTX_ALLOC(state, PQC_SHAKECTX_BYTES);
     keccak_absorb(state->ctx, SHAKE128_RATE, input, inlen, 0x1F);
 }
 
@@ -622,16 +1206,13 @@ void shake128_squeezeblocks(uint8_t *output, size_t nblocks, shake128ctx *state)
 }
 
 void shake128_ctx_clone(shake128ctx *dest, const shake128ctx *src) {
-    dest->ctx = malloc(PQC_SHAKECTX_BYTES);
-    if (dest->ctx == NULL) {
-        exit(111);
-    }
+    KECCAK_CTX_ALLOC(dest, PQC_SHAKECTX_BYTES);
     memcpy(dest->ctx, src->ctx, PQC_SHAKECTX_BYTES);
 }
 
 /** Release the allocated state. Call only once. */
 void shake128_ctx_release(shake128ctx *state) {
-    free(state->ctx);
+    KECCAK_CTX_FREE(state);
 }
 
 /*************************************************
@@ -646,10 +1227,7 @@ void shake128_ctx_release(shake128ctx *state) {
  *              - size_t inlen: length of input in bytes
  **************************************************/
 void shake256_absorb(shake256ctx *state, const uint8_t *input, size_t inlen) {
-    state->ctx = malloc(PQC_SHAKECTX_BYTES);
-    if (state->ctx == NULL) {
-        exit(111);
-    }
+    KECCAK_CTX_ALLOC(state, PQC_SHAKECTX_BYTES);
     keccak_absorb(state->ctx, SHAKE256_RATE, input, inlen, 0x1F);
 }
 
@@ -670,16 +1248,13 @@ void shake256_squeezeblocks(uint8_t *output, size_t nblocks, shake256ctx *state)
 }
 
 void shake256_ctx_clone(shake256ctx *dest, const shake256ctx *src) {
-    dest->ctx = malloc(PQC_SHAKECTX_BYTES);
-    if (dest->ctx == NULL) {
-        exit(111);
-    }
+    KECCAK_CTX_ALLOC(dest, PQC_SHAKECTX_BYTES);
     memcpy(dest->ctx, src->ctx, PQC_SHAKECTX_BYTES);
 }
 
 /** Release the allocated state. Call only once. */
 void shake256_ctx_release(shake256ctx *state) {
-    free(state->ctx);
+    KECCAK_CTX_FREE(state);
 }
 
 /*************************************************
@@ -745,23 +1320,17 @@ void shake256(uint8_t *output, size_t outlen,
 }
 
 void sha3_256_inc_init(sha3_256incctx *state) {
-    state->ctx = malloc(PQC_SHAKEINCCTX_BYTES);
-    if (state->ctx == NULL) {
-        exit(111);
-    }
+    KECCAK_CTX_ALLOC(state, PQC_SHAKEINCCTX_BYTES);
     keccak_inc_init(state->ctx);
 }
 
 void sha3_256_inc_ctx_clone(sha3_256incctx *dest, const sha3_256incctx *src) {
-    dest->ctx = malloc(PQC_SHAKEINCCTX_BYTES);
-    if (dest->ctx == NULL) {
-        exit(111);
-    }
+    KECCAK_CTX_ALLOC(dest, PQC_SHAKEINCCTX_BYTES);
     memcpy(dest->ctx, src->ctx, PQC_SHAKEINCCTX_BYTES);
 }
 
 void sha3_256_inc_ctx_release(sha3_256incctx *state) {
-    free(state->ctx);
+    KECCAK_CTX_FREE(state);
 }
 
 void sha3_256_inc_absorb(sha3_256incctx *state, const uint8_t *input, size_t inlen) {
@@ -806,18 +1375,12 @@ void sha3_256(uint8_t *output, const uint8_t *input, size_t inlen) {
 }
 
 void sha3_384_inc_init(sha3_384incctx *state) {
-    state->ctx = malloc(PQC_SHAKEINCCTX_BYTES);
-    if (state->ctx == NULL) {
-        exit(111);
-    }
+    KECCAK_CTX_ALLOC(state, PQC_SHAKEINCCTX_BYTES);
     keccak_inc_init(state->ctx);
 }
 
 void sha3_384_inc_ctx_clone(sha3_384incctx *dest, const sha3_384incctx *src) {
-    dest->ctx = malloc(PQC_SHAKEINCCTX_BYTES);
-    if (dest->ctx == NULL) {
-        exit(111);
-    }
+    KECCAK_CTX_ALLOC(dest, PQC_SHAKEINCCTX_BYTES);
     memcpy(dest->ctx, src->ctx, PQC_SHAKEINCCTX_BYTES);
 }
 
@@ -826,7 +1389,7 @@ void sha3_384_inc_absorb(sha3_384incctx *state, const uint8_t *input, size_t inl
 }
 
 void sha3_384_inc_ctx_release(sha3_384incctx *state) {
-    free(state->ctx);
+    KECCAK_CTX_FREE(state);
 }
 
 void sha3_384_inc_finalize(uint8_t *output, sha3_384incctx *state) {
@@ -867,18 +1430,12 @@ void sha3_384(uint8_t *output, const uint8_t *input, size_t inlen) {
 }
 
 void sha3_512_inc_init(sha3_512incctx *state) {
-    state->ctx = malloc(PQC_SHAKEINCCTX_BYTES);
-    if (state->ctx == NULL) {
-        exit(111);
-    }
+    KECCAK_CTX_ALLOC(state, PQC_SHAKEINCCTX_BYTES);
     keccak_inc_init(state->ctx);
 }
 
 void sha3_512_inc_ctx_clone(sha3_512incctx *dest, const sha3_512incctx *src) {
-    dest->ctx = malloc(PQC_SHAKEINCCTX_BYTES);
-    if (dest->ctx == NULL) {
-        exit(111);
-    }
+    KECCAK_CTX_ALLOC(dest, PQC_SHAKEINCCTX_BYTES);
     memcpy(dest->ctx, src->ctx, PQC_SHAKEINCCTX_BYTES);
 }
 
@@ -887,7 +1444,7 @@ void sha3_512_inc_absorb(sha3_512incctx *state, const uint8_t *input, size_t inl
 }
 
 void sha3_512_inc_ctx_release(sha3_512incctx *state) {
-    free(state->ctx);
+    KECCAK_CTX_FREE(state);
 }
 
 void sha3_512_inc_finalize(uint8_t *output, sha3_512incctx *state) {
@@ -926,3 +1483,456 @@ void sha3_512(uint8_t *output, const uint8_t *input, size_t inlen) {
         output[i] = t[i];
     }
 }
+
+/*
+ * 4-way API: four independent SHAKE instances in one state, lane i of
+ * instance j at state[4 * i + j]. With AVX2 the four permutations run in
+ * one pass over 256-bit vectors; otherwise they run one after the other.
+ */
+
+#ifdef KECCAK_X4_AVX2
+#define XOR256(a, b) _mm256_xor_si256(a, b)
+#define ANDNOT256(a, b) _mm256_andnot_si256(a, b)
+#define ROL256(a, offset) \
+    _mm256_or_si256(_mm256_slli_epi64(a, offset), _mm256_srli_epi64(a, 64 - (offset)))
+
+/*************************************************
+ * Name:        KeccakF1600_StatePermute4x_avx2
+ *
+ * Description: Four Keccak F1600 permutations on 256-bit vectors
+ *
+ * Arguments:   - uint64_t *state: pointer to input/output 4-way state
+ **************************************************/
+__attribute__((target("avx2")))
+static void KeccakF1600_StatePermute4x_avx2(uint64_t *state) {
+    int round;
+
+    __m256i Aba, Abe, Abi, Abo, Abu;
+    __m256i Aga, Age, Agi, Ago, Agu;
+    __m256i Aka, Ake, Aki, Ako, Aku;
+    __m256i Ama, Ame, Ami, Amo, Amu;
+    __m256i Asa, Ase, Asi, Aso, Asu;
+    __m256i BCa, BCe, BCi, BCo, BCu;
+    __m256i Da, De, Di, Do, Du;
+    __m256i Eba, Ebe, Ebi, Ebo, Ebu;
+    __m256i Ega, Ege, Egi, Ego, Egu;
+    __m256i Eka, Eke, Eki, Eko, Eku;
+    __m256i Ema, Eme, Emi, Emo, Emu;
+    __m256i Esa, Ese, Esi, Eso, Esu;
+
+    Aba = _mm256_loadu_si256((const __m256i *)(const void *)&state[4 * 0]);
+    Abe = _mm256_loadu_si256((const __m256i *)(const void *)&state[4 * 1]);
+    Abi = _mm256_loadu_si256((const __m256i *)(const void *)&state[4 * 2]);
+    Abo = _mm256_loadu_si256((const __m256i *)(const void *)&state[4 * 3]);
+    Abu = _mm256_loadu_si256((const __m256i *)(const void *)&state[4 * 4]);
+    Aga = _mm256_loadu_si256((const __m256i *)(const void *)&state[4 * 5]);
+    Age = _mm256_loadu_si256((const __m256i *)(const void *)&state[4 * 6]);
+    Agi = _mm256_loadu_si256((const __m256i *)(const void *)&state[4 * 7]);
+    Ago = _mm256_loadu_si256((const __m256i *)(const void *)&state[4 * 8]);
+    Agu = _mm256_loadu_si256((const __m256i *)(const void *)&state[4 * 9]);
+    Aka = _mm256_loadu_si256((const __m256i *)(const void *)&state[4 * 10]);
+    Ake = _mm256_loadu_si256((const __m256i *)(const void *)&state[4 * 11]);
+    Aki = _mm256_loadu_si256((const __m256i *)(const void *)&state[4 * 12]);
+    Ako = _mm256_loadu_si256((const __m256i *)(const void *)&state[4 * 13]);
+    Aku = _mm256_loadu_si256((const __m256i *)(const void *)&state[4 * 14]);
+    Ama = _mm256_loadu_si256((const __m256i *)(const void *)&state[4 * 15]);
+    Ame = _mm256_loadu_si256((const __m256i *)(const void *)&state[4 * 16]);
+    Ami = _mm256_loadu_si256((const __m256i *)(const void *)&state[4 * 17]);
+    Amo = _mm256_loadu_si256((const __m256i *)(const void *)&state[4 * 18]);
+    Amu = _mm256_loadu_si256((const __m256i *)(const void *)&state[4 * 19]);
+    Asa = _mm256_loadu_si256((const __m256i *)(const void *)&state[4 * 20]);
+    Ase = _mm256_loadu_si256((const __m256i *)(const void *)&state[4 * 21]);
+    Asi = _mm256_loadu_si256((const __m256i *)(const void *)&state[4 * 22]);
+    Aso = _mm256_loadu_si256((const __m256i *)(const void *)&state[4 * 23]);
+    Asu = _mm256_loadu_si256((const __m256i *)(const void *)&state[4 * 24]);
+
+    for (round = 0; round < NROUNDS; round += 2) {
+        // thetaRhoPiChiIotaPrepareTheta(round, A, E)
+        BCa = XOR256(XOR256(XOR256(XOR256(Aba, Aga), Aka), Ama), Asa);
+        BCe = XOR256(XOR256(XOR256(XOR256(Abe, Age), Ake), Ame), Ase);
+        BCi = XOR256(XOR256(XOR256(XOR256(Abi, Agi), Aki), Ami), Asi);
+        BCo = XOR256(XOR256(XOR256(XOR256(Abo, Ago), Ako), Amo), Aso);
+        BCu = XOR256(XOR256(XOR256(XOR256(Abu, Agu), Aku), Amu), Asu);
+        Da = XOR256(BCu, ROL256(BCe, 1));
+        De = XOR256(BCa, ROL256(BCi, 1));
+        Di = XOR256(BCe, ROL256(BCo, 1));
+        Do = XOR256(BCi, ROL256(BCu, 1));
+        Du = XOR256(BCo, ROL256(BCa, 1));
+        Aba = XOR256(Aba, Da);
+        BCa = Aba;
+        Age = XOR256(Age, De);
+        BCe = ROL256(Age, 44);
+        Aki = XOR256(Aki, Di);
+        BCi = ROL256(Aki, 43);
+        Amo = XOR256(Amo, Do);
+        BCo = ROL256(Amo, 21);
+        Asu = XOR256(Asu, Du);
+        BCu = ROL256(Asu, 14);
+        Eba = XOR256(BCa, ANDNOT256(BCe, BCi));
+        Ebe = XOR256(BCe, ANDNOT256(BCi, BCo));
+        Ebi = XOR256(BCi, ANDNOT256(BCo, BCu));
+        Ebo = XOR256(BCo, ANDNOT256(BCu, BCa));
+        Ebu = XOR256(BCu, ANDNOT256(BCa, BCe));
+        Eba = XOR256(Eba, _mm256_set1_epi64x((long long)KeccakF_RoundConstants[round]));
+        Abo = XOR256(Abo, Do);
+        BCa = ROL256(Abo, 28);
+        Agu = XOR256(Agu, Du);
+        BCe = ROL256(Agu, 20);
+        Aka = XOR256(Aka, Da);
+        BCi = ROL256(Aka, 3);
+        Ame = XOR256(Ame, De);
+        BCo = ROL256(Ame, 45);
+        Asi = XOR256(Asi, Di);
+        BCu = ROL256(Asi, 61);
+        Ega = XOR256(BCa, ANDNOT256(BCe, BCi));
+        Ege = XOR256(BCe, ANDNOT256(BCi, BCo));
+        Egi = XOR256(BCi, ANDNOT256(BCo, BCu));
+        Ego = XOR256(BCo, ANDNOT256(BCu, BCa));
+        Egu = XOR256(BCu, ANDNOT256(BCa, BCe));
+        Abe = XOR256(Abe, De);
+        BCa = ROL256(Abe, 1);
+        Agi = XOR256(Agi, Di);
+        BCe = ROL256(Agi, 6);
+        Ako = XOR256(Ako, Do);
+        BCi = ROL256(Ako, 25);
+        Amu = XOR256(Amu, Du);
+        BCo = ROL256(Amu, 8);
+        Asa = XOR256(Asa, Da);
+        BCu = ROL256(Asa, 18);
+        Eka = XOR256(BCa, ANDNOT256(BCe, BCi));
+        Eke = XOR256(BCe, ANDNOT256(BCi, BCo));
+        Eki = XOR256(BCi, ANDNOT256(BCo, BCu));
+        Eko = XOR256(BCo, ANDNOT256(BCu, BCa));
+        Eku = XOR256(BCu, ANDNOT256(BCa, BCe));
+        Abu = XOR256(Abu, Du);
+        BCa = ROL256(Abu, 27);
+        Aga = XOR256(Aga, Da);
+        BCe = ROL256(Aga, 36);
+        Ake = XOR256(Ake, De);
+        BCi = ROL256(Ake, 10);
+        Ami = XOR256(Ami, Di);
+        BCo = ROL256(Ami, 15);
+        Aso = XOR256(Aso, Do);
+        BCu = ROL256(Aso, 56);
+        Ema = XOR256(BCa, ANDNOT256(BCe, BCi));
+        Eme = XOR256(BCe, ANDNOT256(BCi, BCo));
+        Emi = XOR256(BCi, ANDNOT256(BCo, BCu));
+        Emo = XOR256(BCo, ANDNOT256(BCu, BCa));
+        Emu = XOR256(BCu, ANDNOT256(BCa, BCe));
+        Abi = XOR256(Abi, Di);
+        BCa = ROL256(Abi, 62);
+        Ago = XOR256(Ago, Do);
+        BCe = ROL256(Ago, 55);
+        Aku = XOR256(Aku, Du);
+        BCi = ROL256(Aku, 39);
+        Ama = XOR256(Ama, Da);
+        BCo = ROL256(Ama, 41);
+        Ase = XOR256(Ase, De);
+        BCu = ROL256(Ase, 2);
+        Esa = XOR256(BCa, ANDNOT256(BCe, BCi));
+        Ese = XOR256(BCe, ANDNOT256(BCi, BCo));
+        Esi = XOR256(BCi, ANDNOT256(BCo, BCu));
+        Eso = XOR256(BCo, ANDNOT256(BCu, BCa));
+        Esu = XOR256(BCu, ANDNOT256(BCa, BCe));
+
+        // thetaRhoPiChiIotaPrepareTheta(round+1, E, A)
+        BCa = XOR256(XOR256(XOR256(XOR256(Eba, Ega), Eka), Ema), Esa);
+        BCe = XOR256(XOR256(XOR256(XOR256(Ebe, Ege), Eke), Eme), Ese);
+        BCi = XOR256(XOR256(XOR256(XOR256(Ebi, Egi), Eki), Emi), Esi);
+        BCo = XOR256(XOR256(XOR256(XOR256(Ebo, Ego), Eko), Emo), Eso);
+        BCu = XOR256(XOR256(XOR256(XOR256(Ebu, Egu), Eku), Emu), Esu);
+        Da = XOR256(BCu, ROL256(BCe, 1));
+        De = XOR256(BCa, ROL256(BCi, 1));
+        Di = XOR256(BCe, ROL256(BCo, 1));
+        Do = XOR256(BCi, ROL256(BCu, 1));
+        Du = XOR256(BCo, ROL256(BCa, 1));
+        Eba = XOR256(Eba, Da);
+        BCa = Eba;
+        Ege = XOR256(Ege, De);
+        BCe = ROL256(Ege, 44);
+        Eki = XOR256(Eki, Di);
+        BCi = ROL256(Eki, 43);
+        Emo = XOR256(Emo, Do);
+        BCo = ROL256(Emo, 21);
+        Esu = XOR256(Esu, Du);
+        BCu = ROL256(Esu, 14);
+        Aba = XOR256(BCa, ANDNOT256(BCe, BCi));
+        Abe = XOR256(BCe, ANDNOT256(BCi, BCo));
+        Abi = XOR256(BCi, ANDNOT256(BCo, BCu));
+        Abo = XOR256(BCo, ANDNOT256(BCu, BCa));
+        Abu = XOR256(BCu, ANDNOT256(BCa, BCe));
+        Aba = XOR256(Aba, _mm256_set1_epi64x((long long)KeccakF_RoundConstants[round + 1]));
+        Ebo = XOR256(Ebo, Do);
+        BCa = ROL256(Ebo, 28);
+        Egu = XOR256(Egu, Du);
+        BCe = ROL256(Egu, 20);
+        Eka = XOR256(Eka, Da);
+        BCi = ROL256(Eka, 3);
+        Eme = XOR256(Eme, De);
+        BCo = ROL256(Eme, 45);
+        Esi = XOR256(Esi, Di);
+        BCu = ROL256(Esi, 61);
+        Aga = XOR256(BCa, ANDNOT256(BCe, BCi));
+        Age = XOR256(BCe, ANDNOT256(BCi, BCo));
+        Agi = XOR256(BCi, ANDNOT256(BCo, BCu));
+        Ago = XOR256(BCo, ANDNOT256(BCu, BCa));
+        Agu = XOR256(BCu, ANDNOT256(BCa, BCe));
+        Ebe = XOR256(Ebe, De);
+        BCa = ROL256(Ebe, 1);
+        Egi = XOR256(Egi, Di);
+        BCe = ROL256(Egi, 6);
+        Eko = XOR256(Eko, Do);
+        BCi = ROL256(Eko, 25);
+        Emu = XOR256(Emu, Du);
+        BCo = ROL256(Emu, 8);
+        Esa = XOR256(Esa, Da);
+        BCu = ROL256(Esa, 18);
+        Aka = XOR256(BCa, ANDNOT256(BCe, BCi));
+        Ake = XOR256(BCe, ANDNOT256(BCi, BCo));
+        Aki = XOR256(BCi, ANDNOT256(BCo, BCu));
+        Ako = XOR256(BCo, ANDNOT256(BCu, BCa));
+        Aku = XOR256(BCu, ANDNOT256(BCa, BCe));
+        Ebu = XOR256(Ebu, Du);
+        BCa = ROL256(Ebu, 27);
+        Ega = XOR256(Ega, Da);
+        BCe = ROL256(Ega, 36);
+        Eke = XOR256(Eke, De);
+        BCi = ROL256(Eke, 10);
+        Emi = XOR256(Emi, Di);
+        BCo = ROL256(Emi, 15);
+        Eso = XOR256(Eso, Do);
+        BCu = ROL256(Eso, 56);
+        Ama = XOR256(BCa, ANDNOT256(BCe, BCi));
+        Ame = XOR256(BCe, ANDNOT256(BCi, BCo));
+        Ami = XOR256(BCi, ANDNOT256(BCo, BCu));
+        Amo = XOR256(BCo, ANDNOT256(BCu, BCa));
+        Amu = XOR256(BCu, ANDNOT256(BCa, BCe));
+        Ebi = XOR256(Ebi, Di);
+        BCa = ROL256(Ebi, 62);
+        Ego = XOR256(Ego, Do);
+        BCe = ROL256(Ego, 55);
+        Eku = XOR256(Eku, Du);
+        BCi = ROL256(Eku, 39);
+        Ema = XOR256(Ema, Da);
+        BCo = ROL256(Ema, 41);
+        Ese = XOR256(Ese, De);
+        BCu = ROL256(Ese, 2);
+        Asa = XOR256(BCa, ANDNOT256(BCe, BCi));
+        Ase = XOR256(BCe, ANDNOT256(BCi, BCo));
+        Asi = XOR256(BCi, ANDNOT256(BCo, BCu));
+        Aso = XOR256(BCo, ANDNOT256(BCu, BCa));
+        Asu = XOR256(BCu, ANDNOT256(BCa, BCe));
+    }
+
+    _mm256_storeu_si256((__m256i *)(void *)&state[4 * 0], Aba);
+    _mm256_storeu_si256((__m256i *)(void *)&state[4 * 1], Abe);
+    _mm256_storeu_si256((__m256i *)(void *)&state[4 * 2], Abi);
+    _mm256_storeu_si256((__m256i *)(void *)&state[4 * 3], Abo);
+    _mm256_storeu_si256((__m256i *)(void *)&state[4 * 4], Abu);
+    _mm256_storeu_si256((__m256i *)(void *)&state[4 * 5], Aga);
+    _mm256_storeu_si256((__m256i *)(void *)&state[4 * 6], Age);
+    _mm256_storeu_si256((__m256i *)(void *)&state[4 * 7], Agi);
+    _mm256_storeu_si256((__m256i *)(void *)&state[4 * 8], Ago);
+    _mm256_storeu_si256((__m256i *)(void *)&state[4 * 9], Agu);
+    _mm256_storeu_si256((__m256i *)(void *)&state[4 * 10], Aka);
+    _mm256_storeu_si256((__m256i *)(void *)&state[4 * 11], Ake);
+    _mm256_storeu_si256((__m256i *)(void *)&state[4 * 12], Aki);
+    _mm256_storeu_si256((__m256i *)(void *)&state[4 * 13], Ako);
+    _mm256_storeu_si256((__m256i *)(void *)&state[4 * 14], Aku);
+    _mm256_storeu_si256((__m256i *)(void *)&state[4 * 15], Ama);
+    _mm256_storeu_si256((__m256i *)(void *)&state[4 * 16], Ame);
+    _mm256_storeu_si256((__m256i *)(void *)&state[4 * 17], Ami);
+    _mm256_storeu_si256((__m256i *)(void *)&state[4 * 18], Amo);
+    _mm256_storeu_si256((__m256i *)(void *)&state[4 * 19], Amu);
+    _mm256_storeu_si256((__m256i *)(void *)&state[4 * 20], Asa);
+    _mm256_storeu_si256((__m256i *)(void *)&state[4 * 21], Ase);
+    _mm256_storeu_si256((__m256i *)(void *)&state[4 * 22], Asi);
+    _mm256_storeu_si256((__m256i *)(void *)&state[4 * 23], Aso);
+    _mm256_storeu_si256((__m256i *)(void *)&state[4 * 24], Asu);
+}
+#endif
+
+/*************************************************
+ * Name:        KeccakF1600_StatePermute4x
+ *
+ * Description: Four independent Keccak F1600 permutations
+ *
+ * Arguments:   - uint64_t *state: pointer to input/output 4-way state
+ **************************************************/
+static void KeccakF1600_StatePermute4x(uint64_t *state) {
+    uint64_t t[25];
+    size_t i, j;
+
+#ifdef KECCAK_X4_AVX2
+    if (cpu_has_avx2()) {
+        KeccakF1600_StatePermute4x_avx2(state);
+        return;
+    }
+#endif
+    for (j = 0; j < 4; ++j) {
+        for (i = 0; i < 25; ++i) {
+            t[i] = state[4 * i + j];
+        }
+        KeccakF1600_StatePermute(t);
+        for (i = 0; i < 25; ++i) {
+            state[4 * i + j] = t[i];
+        }
+    }
+}
+
+void keccakf1600_permute(uint64_t state[25]) {
+    KeccakF1600_StatePermute(state);
+}
+
+void keccakf1600x4_permute(keccakx4_state *state) {
+    KeccakF1600_StatePermute4x(state->s);
+}
+
+void keccakf1600_load_lanes(uint64_t *s, size_t stride, const uint8_t *m, size_t nlanes) {
+    size_t i;
+
+#ifdef KECCAK_LITTLE_ENDIAN
+    if (((uintptr_t)m % KECCAK_WORD_ALIGN) == 0) {
+        const uint8_t *w = __builtin_assume_aligned(m, KECCAK_WORD_ALIGN);
+        for (i = 0; i < nlanes; ++i) {
+            memcpy(&s[stride * i], w + 8 * i, sizeof(s[0]));
+        }
+        return;
+    }
+#endif
+    for (i = 0; i < nlanes; ++i) {
+        s[stride * i] = load64(m + 8 * i);
+    }
+}
+
+void keccakf1600_store_lanes(uint8_t *h, const uint64_t *s, size_t stride, size_t nlanes) {
+    size_t i;
+
+#ifdef KECCAK_LITTLE_ENDIAN
+    if (((uintptr_t)h % KECCAK_WORD_ALIGN) == 0) {
+        uint8_t *w = __builtin_assume_aligned(h, KECCAK_WORD_ALIGN);
+        for (i = 0; i < nlanes; ++i) {
+            memcpy(w + 8 * i, &s[stride * i], sizeof(s[0]));
+        }
+        return;
+    }
+#endif
+    for (i = 0; i < nlanes; ++i) {
+        store64(h + 8 * i, s[stride * i]);
+    }
+}
+
+static void keccakx4_absorb_once(uint64_t *s, uint32_t r,
+                                 const uint8_t *in0, const uint8_t *in1,
+                                 const uint8_t *in2, const uint8_t *in3,
+                                 size_t inlen, uint8_t p) {
+    const uint8_t *in[4] = {in0, in1, in2, in3};
+    size_t i, j, pos = 0;
+
+    for (i = 0; i < 100; ++i) {
+        s[i] = 0;
+    }
+
+    while (inlen - pos >= r) {
+        for (i = 0; i < r / 8; ++i) {
+            for (j = 0; j < 4; ++j) {
+                s[4 * i + j] ^= load64(in[j] + pos + 8 * i);
+            }
+        }
+        KeccakF1600_StatePermute4x(s);
+        pos += r;
+    }
+
+    for (i = 0; pos + 8 * i + 8 <= inlen; ++i) {
+        for (j = 0; j < 4; ++j) {
+            s[4 * i + j] ^= load64(in[j] + pos + 8 * i);
+        }
+    }
+    for (i *= 8; pos + i < inlen; ++i) {
+        for (j = 0; j < 4; ++j) {
+            s[4 * (i >> 3) + j] ^= (uint64_t)in[j][pos + i] << (8 * (i & 0x07));
+        }
+    }
+    for (j = 0; j < 4; ++j) {
+        s[4 * (i >> 3) + j] ^= (uint64_t)p << (8 * (i & 0x07));
+        s[4 * ((r - 1) >> 3) + j] ^= (uint64_t)128 << (8 * ((r - 1) & 0x07));
+    }
+}
+
+static void keccakx4_squeezeblocks(uint8_t *out0, uint8_t *out1,
+                                   uint8_t *out2, uint8_t *out3,
+                                   size_t nblocks, uint64_t *s, uint32_t r) {
+    uint8_t *out[4] = {out0, out1, out2, out3};
+    size_t i, j;
+
+    while (nblocks > 0) {
+        KeccakF1600_StatePermute4x(s);
+        for (i = 0; i < r / 8; ++i) {
+            for (j = 0; j < 4; ++j) {
+                store64(out[j] + 8 * i, s[4 * i + j]);
+            }
+        }
+        for (j = 0; j < 4; ++j) {
+            out[j] += r;
+        }
+        nblocks--;
+    }
+}
+
+void shake128x4_absorb_once(keccakx4_state *state,
+                            const uint8_t *in0, const uint8_t *in1,
+                            const uint8_t *in2, const uint8_t *in3, size_t inlen) {
+    keccakx4_absorb_once(state->s, SHAKE128_RATE, in0, in1, in2, in3, inlen, 0x1F);
+}
+
+void shake128x4_squeezeblocks(uint8_t *out0, uint8_t *out1, uint8_t *out2, uint8_t *out3,
+                              size_t nblocks, keccakx4_state *state) {
+    keccakx4_squeezeblocks(out0, out1, out2, out3, nblocks, state->s, SHAKE128_RATE);
+}
+
+void shake256x4_absorb_once(keccakx4_state *state,
+                            const uint8_t *in0, const uint8_t *in1,
+                            const uint8_t *in2, const uint8_t *in3, size_t inlen) {
+    keccakx4_absorb_once(state->s, SHAKE256_RATE, in0, in1, in2, in3, inlen, 0x1F);
+}
+
+void shake256x4_squeezeblocks(uint8_t *out0, uint8_t *out1, uint8_t *out2, uint8_t *out3,
+                              size_t nblocks, keccakx4_state *state) {
+    keccakx4_squeezeblocks(out0, out1, out2, out3, nblocks, state->s, SHAKE256_RATE);
+}
+
+static void keccakx4(uint8_t *out0, uint8_t *out1, uint8_t *out2, uint8_t *out3,
+                     size_t outlen, uint32_t r,
+                     const uint8_t *in0, const uint8_t *in1,
+                     const uint8_t *in2, const uint8_t *in3, size_t inlen) {
+    uint8_t *out[4] = {out0, out1, out2, out3};
+    keccakx4_state state;
+    size_t nblocks = outlen / r;
+    uint8_t t[4][SHAKE128_RATE];
+    size_t i, j;
+
+    keccakx4_absorb_once(state.s, r, in0, in1, in2, in3, inlen, 0x1F);
+    keccakx4_squeezeblocks(out0, out1, out2, out3, nblocks, state.s, r);
+
+    outlen -= nblocks * r;
+    if (outlen) {
+        keccakx4_squeezeblocks(t[0], t[1], t[2], t[3], 1, state.s, r);
+        for (j = 0; j < 4; ++j) {
+            for (i = 0; i < outlen; ++i) {
+                out[j][nblocks * r + i] = t[j][i];
+            }
+        }
+    }
+}
+
+void shake128x4(uint8_t *out0, uint8_t *out1, uint8_t *out2, uint8_t *out3, size_t outlen,
+                const uint8_t *in0, const uint8_t *in1,
+                const uint8_t *in2, const uint8_t *in3, size_t inlen) {
+    keccakx4(out0, out1, out2, out3, outlen, SHAKE128_RATE, in0, in1, in2, in3, inlen);
+}
+
+void shake256x4(uint8_t *out0, uint8_t *out1, uint8_t *out2, uint8_t *out3, size_t outlen,
+                const uint8_t *in0, const uint8_t *in1,
+                const uint8_t *in2, const uint8_t *in3, size_t inlen) {
+    keccakx4(out0, out1, out2, out3, outlen, SHAKE256_RATE, in0, in1, in2, in3, inlen);
+}
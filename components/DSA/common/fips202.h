@@ -4,6 +4,8 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include "dsa_config.h"
+
 #define SHAKE128_RATE 168
 #define SHAKE256_RATE 136
 #define SHA3_256_RATE 136
@@ -13,41 +15,63 @@
 #define PQC_SHAKEINCCTX_BYTES (sizeof(uint64_t)*26)
 #define PQC_SHAKECTX_BYTES (sizeof(uint64_t)*25)
 
+/*
+ * By default the Keccak state lives inside the context struct, so
+ * init/absorb/clone/release never touch the heap and a context costs 200
+ * (or 208, incremental) bytes wherever it is declared. With
+ * CONFIG_DSA_KECCAK_HEAP_STATE the contexts only hold a pointer to a state
+ * that init/absorb/clone malloc and release frees, as in upstream PQClean.
+ * Either way callers must pair every init/absorb/clone with a release.
+ */
+#ifdef CONFIG_DSA_KECCAK_HEAP_STATE
+#define PQC_SHAKEINCCTX_STATE uint64_t *ctx
+#define PQC_SHAKECTX_STATE uint64_t *ctx
+#else
+#define PQC_SHAKEINCCTX_STATE uint64_t ctx[26]
+#define PQC_SHAKECTX_STATE uint64_t ctx[25]
+#endif
+
 // Context for incremental API
 typedef struct {
-    uint64_t *ctx;
+    PQC_SHAKEINCCTX_STATE;
 } shake128incctx;
 
 // Context for non-incremental API
 typedef struct {
-    uint64_t *ctx;
+    PQC_SHAKECTX_STATE;
 } shake128ctx;
 
 // Context for incremental API
 typedef struct {
-    uint64_t *ctx;
+    PQC_SHAKEINCCTX_STATE;
 } shake256incctx;
 
 // Context for non-incremental API
 typedef struct {
-    uint64_t *ctx;
+    PQC_SHAKECTX_STATE;
 } shake256ctx;
 
 // Context for incremental API
 typedef struct {
-    uint64_t *ctx;
+    PQC_SHAKEINCCTX_STATE;
 } sha3_256incctx;
 
 // Context for incremental API
 typedef struct {
-    uint64_t *ctx;
+    PQC_SHAKEINCCTX_STATE;
 } sha3_384incctx;
 
 // Context for incremental API
 typedef struct {
-    uint64_t *ctx;
+    PQC_SHAKEINCCTX_STATE;
 } sha3_512incctx;
 
+// Context for the 4-way API: four independent instances, lane-interleaved.
+// Always held inline; there is nothing to release.
+typedef struct {
+    uint64_t s[100];
+} keccakx4_state;
+
 /* Initialize the state and absorb the provided input.
  *
  * This function does not support being called multiple times
@@ -163,4 +187,41 @@ void sha3_512_inc_ctx_release(sha3_512incctx *state);
 /* One-stop SHA3-512 shop */
 void sha3_512(uint8_t *output, const uint8_t *input, size_t inlen);
 
+/* 4-way SHAKE: the same as four calls of the single-instance functions on
+ * independent inputs of equal length, but the four permutations share one
+ * pass, with AVX2 where the host has it. */
+void shake128x4_absorb_once(keccakx4_state *state,
+                            const uint8_t *in0, const uint8_t *in1,
+                            const uint8_t *in2, const uint8_t *in3, size_t inlen);
+void shake128x4_squeezeblocks(uint8_t *out0, uint8_t *out1, uint8_t *out2, uint8_t *out3,
+                              size_t nblocks, keccakx4_state *state);
+void shake256x4_absorb_once(keccakx4_state *state,
+                            const uint8_t *in0, const uint8_t *in1,
+                            const uint8_t *in2, const uint8_t *in3, size_t inlen);
+void shake256x4_squeezeblocks(uint8_t *out0, uint8_t *out1, uint8_t *out2, uint8_t *out3,
+                              size_t nblocks, keccakx4_state *state);
+
+void shake128x4(uint8_t *out0, uint8_t *out1, uint8_t *out2, uint8_t *out3, size_t outlen,
+                const uint8_t *in0, const uint8_t *in1,
+                const uint8_t *in2, const uint8_t *in3, size_t inlen);
+void shake256x4(uint8_t *out0, uint8_t *out1, uint8_t *out2, uint8_t *out3, size_t outlen,
+                const uint8_t *in0, const uint8_t *in1,
+                const uint8_t *in2, const uint8_t *in3, size_t inlen);
+
+/* The Keccak-f[1600] permutation itself, for callers that lay a one-block
+ * input out in the lanes themselves and read the output back from them, as
+ * the SPHINCS+-SHAKE thash does. Lanes are in the standard order, bytes
+ * little-endian within a lane; keccakf1600x4_permute() takes the four
+ * states lane-interleaved as in keccakx4_state (lane i of instance j at
+ * s[4 * i + j]). */
+void keccakf1600_permute(uint64_t state[25]);
+void keccakf1600x4_permute(keccakx4_state *state);
+
+/* Set nlanes lanes of such a state, s[0], s[stride], ..., from 8 * nlanes
+ * bytes of m, and write them back out to h, with the word-wise loads and
+ * stores of the sponge where the buffer allows them. Pass stride 4 and
+ * state->s + j for instance j of a keccakx4_state. */
+void keccakf1600_load_lanes(uint64_t *s, size_t stride, const uint8_t *m, size_t nlanes);
+void keccakf1600_store_lanes(uint8_t *h, const uint64_t *s, size_t stride, size_t nlanes);
+
 #endif
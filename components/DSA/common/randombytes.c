@@ -1,7 +1,34 @@
 #include "randombytes.h"
+
+#if defined(ESP_PLATFORM)
+
 #include "esp_random.h"  // for esp_random()
 
 int randombytes(uint8_t *output, size_t n) {
     esp_fill_random(output, n);
     return 0;
-}
\ No newline at end of file
+}
+
+#else
+
+// Host builds draw from the kernel CSPRNG.
+#include <errno.h>
+#include <sys/random.h>
+#include <sys/types.h>
+
+int randombytes(uint8_t *output, size_t n) {
+    while (n > 0) {
+        ssize_t ret = getrandom(output, n, 0);
+        if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        output += ret;
+        n -= (size_t)ret;
+    }
+    return 0;
+}
+
+#endif
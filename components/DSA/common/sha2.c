@@ -7,21 +7,52 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "cpu_features.h"
 #include "sha2.h"
 
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+/* Word loads and stores are one unaligned access plus a byte swap rather
+ * than four byte accesses and shifts. */
+#define SHA2_LITTLE_ENDIAN
+#endif
+
+#ifdef CPU_FEATURES_X86
+/* SHA-256 compression with the SHA extensions, and the multi-buffer
+ * compression with AVX2, chosen at run time */
+#define SHA2_SHANI
+#define SHA2_AVX2
+#include <immintrin.h>
+#endif
+
 static uint32_t load_bigendian_32(const uint8_t *x) {
+#ifdef SHA2_LITTLE_ENDIAN
+    uint32_t r;
+    memcpy(&r, x, sizeof(r));
+    return __builtin_bswap32(r);
+#else
     return (uint32_t)(x[3]) | (((uint32_t)(x[2])) << 8) |
            (((uint32_t)(x[1])) << 16) | (((uint32_t)(x[0])) << 24);
+#endif
 }
 
 static uint64_t load_bigendian_64(const uint8_t *x) {
+#ifdef SHA2_LITTLE_ENDIAN
+    uint64_t r;
+    memcpy(&r, x, sizeof(r));
+    return __builtin_bswap64(r);
+#else
     return (uint64_t)(x[7]) | (((uint64_t)(x[6])) << 8) |
            (((uint64_t)(x[5])) << 16) | (((uint64_t)(x[4])) << 24) |
            (((uint64_t)(x[3])) << 32) | (((uint64_t)(x[2])) << 40) |
            (((uint64_t)(x[1])) << 48) | (((uint64_t)(x[0])) << 56);
+#endif
 }
 
 static void store_bigendian_32(uint8_t *x, uint64_t u) {
+#ifdef SHA2_LITTLE_ENDIAN
+    uint32_t r = __builtin_bswap32((uint32_t) u);
+    memcpy(x, &r, sizeof(r));
+#else
     x[3] = (uint8_t) u;
     u >>= 8;
     x[2] = (uint8_t) u;
@@ -29,9 +60,14 @@ static void store_bigendian_32(uint8_t *x, uint64_t u) {
     x[1] = (uint8_t) u;
     u >>= 8;
     x[0] = (uint8_t) u;
+#endif
 }
 
 static void store_bigendian_64(uint8_t *x, uint64_t u) {
+#ifdef SHA2_LITTLE_ENDIAN
+    u = __builtin_bswap64(u);
+    memcpy(x, &u, sizeof(u));
+#else
     x[7] = (uint8_t) u;
     u >>= 8;
     x[6] = (uint8_t) u;
@@ -47,6 +83,7 @@ static void store_bigendian_64(uint8_t *x, uint64_t u) {
     x[1] = (uint8_t) u;
     u >>= 8;
     x[0] = (uint8_t) u;
+#endif
 }
 
 #define SHR(x, c) ((x) >> (c))
@@ -129,9 +166,78 @@ static void store_bigendian_64(uint8_t *x, uint64_t u) {
     b = a;                                           \
     a = T1 + T2;
 
-static size_t crypto_hashblocks_sha256(uint8_t *statebytes,
-                                       const uint8_t *in, size_t inlen) {
-    uint32_t state[8];
+/* The 64 rounds over the message words w0..w15, expanding them in place */
+#define ROUNDS_32            \
+    F_32(w0, 0x428a2f98)     \
+    F_32(w1, 0x71374491)     \
+    F_32(w2, 0xb5c0fbcf)     \
+    F_32(w3, 0xe9b5dba5)     \
+    F_32(w4, 0x3956c25b)     \
+    F_32(w5, 0x59f111f1)     \
+    F_32(w6, 0x923f82a4)     \
+    F_32(w7, 0xab1c5ed5)     \
+    F_32(w8, 0xd807aa98)     \
+    F_32(w9, 0x12835b01)     \
+    F_32(w10, 0x243185be)    \
+    F_32(w11, 0x550c7dc3)    \
+    F_32(w12, 0x72be5d74)    \
+    F_32(w13, 0x80deb1fe)    \
+    F_32(w14, 0x9bdc06a7)    \
+    F_32(w15, 0xc19bf174)    \
+    EXPAND_32                \
+    F_32(w0, 0xe49b69c1)     \
+    F_32(w1, 0xefbe4786)     \
+    F_32(w2, 0x0fc19dc6)     \
+    F_32(w3, 0x240ca1cc)     \
+    F_32(w4, 0x2de92c6f)     \
+    F_32(w5, 0x4a7484aa)     \
+    F_32(w6, 0x5cb0a9dc)     \
+    F_32(w7, 0x76f988da)     \
+    F_32(w8, 0x983e5152)     \
+    F_32(w9, 0xa831c66d)     \
+    F_32(w10, 0xb00327c8)    \
+    F_32(w11, 0xbf597fc7)    \
+    F_32(w12, 0xc6e00bf3)    \
+    F_32(w13, 0xd5a79147)    \
+    F_32(w14, 0x06ca6351)    \
+    F_32(w15, 0x14292967)    \
+    EXPAND_32                \
+    F_32(w0, 0x27b70a85)     \
+    F_32(w1, 0x2e1b2138)     \
+    F_32(w2, 0x4d2c6dfc)     \
+    F_32(w3, 0x53380d13)     \
+    F_32(w4, 0x650a7354)     \
+    F_32(w5, 0x766a0abb)     \
+    F_32(w6, 0x81c2c92e)     \
+    F_32(w7, 0x92722c85)     \
+    F_32(w8, 0xa2bfe8a1)     \
+    F_32(w9, 0xa81a664b)     \
+    F_32(w10, 0xc24b8b70)    \
+    F_32(w11, 0xc76c51a3)    \
+    F_32(w12, 0xd192e819)    \
+    F_32(w13, 0xd6990624)    \
+    F_32(w14, 0xf40e3585)    \
+    F_32(w15, 0x106aa070)    \
+    EXPAND_32                \
+    F_32(w0, 0x19a4c116)     \
+    F_32(w1, 0x1e376c08)     \
+    F_32(w2, 0x2748774c)     \
+    F_32(w3, 0x34b0bcb5)     \
+    F_32(w4, 0x391c0cb3)     \
+    F_32(w5, 0x4ed8aa4a)     \
+    F_32(w6, 0x5b9cca4f)     \
+    F_32(w7, 0x682e6ff3)     \
+    F_32(w8, 0x748f82ee)     \
+    F_32(w9, 0x78a5636f)     \
+    F_32(w10, 0x84c87814)    \
+    F_32(w11, 0x8cc70208)    \
+    F_32(w12, 0x90befffa)    \
+    F_32(w13, 0xa4506ceb)    \
+    F_32(w14, 0xbef9a3f7)    \
+    F_32(w15, 0xc67178f2)
+
+static size_t hashblocks_sha256_portable(uint32_t state[8],
+        const uint8_t *in, size_t inlen) {
     uint32_t a;
     uint32_t b;
     uint32_t c;
@@ -143,22 +249,14 @@ static size_t crypto_hashblocks_sha256(uint8_t *statebytes,
     uint32_t T1;
     uint32_t T2;
 
-    a = load_bigendian_32(statebytes + 0);
-    state[0] = a;
-    b = load_bigendian_32(statebytes + 4);
-    state[1] = b;
-    c = load_bigendian_32(statebytes + 8);
-    state[2] = c;
-    d = load_bigendian_32(statebytes + 12);
-    state[3] = d;
-    e = load_bigendian_32(statebytes + 16);
-    state[4] = e;
-    f = load_bigendian_32(statebytes + 20);
-    state[5] = f;
-    g = load_bigendian_32(statebytes + 24);
-    state[6] = g;
-    h = load_bigendian_32(statebytes + 28);
-    state[7] = h;
+    a = state[0];
+    b = state[1];
+    c = state[2];
+    d = state[3];
+    e = state[4];
+    f = state[5];
+    g = state[6];
+    h = state[7];
 
     while (inlen >= 64) {
         uint32_t w0  = load_bigendian_32(in + 0);
@@ -178,79 +276,7 @@ static size_t crypto_hashblocks_sha256(uint8_t *statebytes,
         uint32_t w14 = load_bigendian_32(in + 56);
         uint32_t w15 = load_bigendian_32(in + 60);
 
-        F_32(w0, 0x428a2f98)
-        F_32(w1, 0x71374491)
-        F_32(w2, 0xb5c0fbcf)
-        F_32(w3, 0xe9b5dba5)
-        F_32(w4, 0x3956c25b)
-        F_32(w5, 0x59f111f1)
-        F_32(w6, 0x923f82a4)
-        F_32(w7, 0xab1c5ed5)
-        F_32(w8, 0xd807aa98)
-        F_32(w9, 0x12835b01)
-        F_32(w10, 0x243185be)
-        F_32(w11, 0x550c7dc3)
-        F_32(w12, 0x72be5d74)
-        F_32(w13, 0x80deb1fe)
-        F_32(w14, 0x9bdc06a7)
-        F_32(w15, 0xc19bf174)
-
-        EXPAND_32
-
-        F_32(w0, 0xe49b69c1)
-        F_32(w1, 0xefbe4786)
-        F_32(w2, 0x0fc19dc6)
-        F_32(w3, 0x240ca1cc)
-        F_32(w4, 0x2de92c6f)
-        F_32(w5, 0x4a7484aa)
-        F_32(w6, 0x5cb0a9dc)
-        F_32(w7, 0x76f988da)
-        F_32(w8, 0x983e5152)
-        F_32(w9, 0xa831c66d)
-        F_32(w10, 0xb00327c8)
-        F_32(w11, 0xbf597fc7)
-        F_32(w12, 0xc6e00bf3)
-        F_32(w13, 0xd5a79147)
-        F_32(w14, 0x06ca6351)
-        F_32(w15, 0x14292967)
-
-        EXPAND_32
-
-        F_32(w0, 0x27b70a85)
-        F_32(w1, 0x2e1b2138)
-        F_32(w2, 0x4d2c6dfc)
-        F_32(w3, 0x53380d13)
-        F_32(w4, 0x650a7354)
-        F_32(w5, 0x766a0abb)
-        F_32(w6, 0x81c2c92e)
-        F_32(w7, 0x92722c85)
-        F_32(w8, 0xa2bfe8a1)
-        F_32(w9, 0xa81a664b)
-        F_32(w10, 0xc24b8b70)
-        F_32(w11, 0xc76c51a3)
-        F_32(w12, 0xd192e819)
-        F_32(w13, 0xd6990624)
-        F_32(w14, 0xf40e3585)
-        F_32(w15, 0x106aa070)
-
-        EXPAND_32
-
-        F_32(w0, 0x19a4c116)
-        F_32(w1, 0x1e376c08)
-        F_32(w2, 0x2748774c)
-        F_32(w3, 0x34b0bcb5)
-        F_32(w4, 0x391c0cb3)
-        F_32(w5, 0x4ed8aa4a)
-        F_32(w6, 0x5b9cca4f)
-        F_32(w7, 0x682e6ff3)
-        F_32(w8, 0x748f82ee)
-        F_32(w9, 0x78a5636f)
-        F_32(w10, 0x84c87814)
-        F_32(w11, 0x8cc70208)
-        F_32(w12, 0x90befffa)
-        F_32(w13, 0xa4506ceb)
-        F_32(w14, 0xbef9a3f7)
-        F_32(w15, 0xc67178f2)
+        ROUNDS_32
 
         a += state[0];
         b += state[1];
@@ -274,21 +300,224 @@ static size_t crypto_hashblocks_sha256(uint8_t *statebytes,
         inlen -= 64;
     }
 
-    store_bigendian_32(statebytes + 0, state[0]);
-    store_bigendian_32(statebytes + 4, state[1]);
-    store_bigendian_32(statebytes + 8, state[2]);
-    store_bigendian_32(statebytes + 12, state[3]);
-    store_bigendian_32(statebytes + 16, state[4]);
-    store_bigendian_32(statebytes + 20, state[5]);
-    store_bigendian_32(statebytes + 24, state[6]);
-    store_bigendian_32(statebytes + 28, state[7]);
+    return inlen;
+}
+
+#ifdef SHA2_SHANI
+static const uint32_t sha256_round_constants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+/*
+ * Same as hashblocks_sha256_portable() with the SHA extensions. The
+ * instructions keep the state as ABEF/CDGH halves and do two rounds each;
+ * the message schedule is carried in w[], four words per vector.
+ */
+__attribute__((target("sha,sse4.1")))
+static size_t hashblocks_sha256_shani(uint32_t state[8],
+                                      const uint8_t *in, size_t inlen) {
+    const __m128i bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    __m128i abef, cdgh, abef_save, cdgh_save, t, k;
+    __m128i w[4];
+    size_t j;
+
+    t = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)(const void *)&state[0]), 0xB1);
+    cdgh = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)(const void *)&state[4]), 0x1B);
+    abef = _mm_alignr_epi8(t, cdgh, 8);
+    cdgh = _mm_blend_epi16(cdgh, t, 0xF0);
+
+    while (inlen >= 64) {
+        abef_save = abef;
+        cdgh_save = cdgh;
+
+        for (j = 0; j < 16; ++j) {
+            if (j < 4) {
+                w[j] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(const void *)(in + 16 * j)), bswap);
+            } else {
+                t = _mm_add_epi32(_mm_sha256msg1_epu32(w[j & 3], w[(j + 1) & 3]),
+                                  _mm_alignr_epi8(w[(j + 3) & 3], w[(j + 2) & 3], 4));
+                w[j & 3] = _mm_sha256msg2_epu32(t, w[(j + 3) & 3]);
+            }
+            k = _mm_loadu_si128((const __m128i *)(const void *)&sha256_round_constants[4 * j]);
+            t = _mm_add_epi32(w[j & 3], k);
+            cdgh = _mm_sha256rnds2_epu32(cdgh, abef, t);
+            abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(t, 0x0E));
+        }
+
+        abef = _mm_add_epi32(abef, abef_save);
+        cdgh = _mm_add_epi32(cdgh, cdgh_save);
+
+        in += 64;
+        inlen -= 64;
+    }
+
+    t = _mm_shuffle_epi32(abef, 0x1B);
+    cdgh = _mm_shuffle_epi32(cdgh, 0xB1);
+    _mm_storeu_si128((__m128i *)(void *)&state[0], _mm_blend_epi16(t, cdgh, 0xF0));
+    _mm_storeu_si128((__m128i *)(void *)&state[4], _mm_alignr_epi8(cdgh, t, 8));
 
     return inlen;
 }
 
-static size_t crypto_hashblocks_sha512(uint8_t *statebytes,
+#endif
+
+/*
+ * Runs the compression function over the whole 64-byte blocks of in[] with
+ * the chaining value held as words in state[]. Returns the number of
+ * trailing bytes left over.
+ */
+static size_t hashblocks_sha256(uint32_t state[8],
+                                const uint8_t *in, size_t inlen) {
+#ifdef SHA2_SHANI
+    if (cpu_has_shani()) {
+        return hashblocks_sha256_shani(state, in, inlen);
+    }
+#endif
+    return hashblocks_sha256_portable(state, in, inlen);
+}
+
+#ifdef SHA2_AVX2
+typedef uint32_t sha256_v8 __attribute__((vector_size(32)));
+
+/*
+ * Loads the eight big-endian words at offset off of each lane and
+ * transposes them, so that w[i] holds word i of every lane.
+ */
+__attribute__((target("avx2")))
+static void load_transpose_sha256x8(sha256_v8 w[8], const uint8_t *const p[8], size_t off) {
+    const __m256i bswap = _mm256_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL,
+                                            0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    __m256i r[8], t[8];
+    size_t l;
+
+    for (l = 0; l < 8; ++l) {
+        r[l] = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(const void *)(p[l] + off)), bswap);
+    }
+    for (l = 0; l < 8; l += 2) {
+        t[l] = _mm256_unpacklo_epi32(r[l], r[l + 1]);
+        t[l + 1] = _mm256_unpackhi_epi32(r[l], r[l + 1]);
+    }
+    for (l = 0; l < 8; l += 4) {
+        r[l] = _mm256_unpacklo_epi64(t[l], t[l + 2]);
+        r[l + 1] = _mm256_unpackhi_epi64(t[l], t[l + 2]);
+        r[l + 2] = _mm256_unpacklo_epi64(t[l + 1], t[l + 3]);
+        r[l + 3] = _mm256_unpackhi_epi64(t[l + 1], t[l + 3]);
+    }
+    for (l = 0; l < 4; ++l) {
+        w[l] = (sha256_v8)_mm256_permute2x128_si256(r[l], r[l + 4], 0x20);
+        w[l + 4] = (sha256_v8)_mm256_permute2x128_si256(r[l], r[l + 4], 0x31);
+    }
+}
+
+/*
+ * hashblocks_sha256_portable() on eight lanes at once, one lane per 32-bit
+ * element: the same rounds run on vectors. Lanes past `lanes` repeat lane 0
+ * and are dropped.
+ */
+__attribute__((target("avx2")))
+static void hashblocks_sha256x8_avx2(uint32_t state[][8], const uint8_t *const in[],
+                                     size_t lanes, size_t inlen) {
+    const uint8_t *p[8];
+    sha256_v8 s[8];
+    sha256_v8 a, b, c, d, e, f, g, h, T1, T2;
+    size_t i, l;
+
+    for (l = 0; l < 8; ++l) {
+        p[l] = in[l < lanes ? l : 0];
+        for (i = 0; i < 8; ++i) {
+            s[i][l] = state[l < lanes ? l : 0][i];
+        }
+    }
+
+    while (inlen >= 64) {
+        sha256_v8 w[16];
+
+        for (i = 0; i < 2; ++i) {
+            load_transpose_sha256x8(&w[8 * i], p, 32 * i);
+        }
+        sha256_v8 w0 = w[0], w1 = w[1], w2 = w[2], w3 = w[3];
+        sha256_v8 w4 = w[4], w5 = w[5], w6 = w[6], w7 = w[7];
+        sha256_v8 w8 = w[8], w9 = w[9], w10 = w[10], w11 = w[11];
+        sha256_v8 w12 = w[12], w13 = w[13], w14 = w[14], w15 = w[15];
+
+        a = s[0];
+        b = s[1];
+        c = s[2];
+        d = s[3];
+        e = s[4];
+        f = s[5];
+        g = s[6];
+        h = s[7];
+
+        ROUNDS_32
+
+        s[0] += a;
+        s[1] += b;
+        s[2] += c;
+        s[3] += d;
+        s[4] += e;
+        s[5] += f;
+        s[6] += g;
+        s[7] += h;
+
+        for (l = 0; l < 8; ++l) {
+            p[l] += 64;
+        }
+        inlen -= 64;
+    }
+
+    for (l = 0; l < lanes; ++l) {
+        for (i = 0; i < 8; ++i) {
+            state[l][i] = s[i][l];
+        }
+    }
+}
+#endif
+
+/*
+ * hashblocks_sha256() on up to eight independent lanes of inlen bytes each.
+ * Where SHA-NI is available one lane at a time is faster than the
+ * multi-buffer form, so that is only used without it.
+ */
+static void hashblocks_sha256_lanes(uint32_t state[][8], const uint8_t *const in[],
+                                    size_t lanes, size_t inlen) {
+    size_t l;
+
+#ifdef SHA2_AVX2
+    if (!cpu_has_shani() && cpu_has_avx2()) {
+        hashblocks_sha256x8_avx2(state, in, lanes, inlen);
+        return;
+    }
+#endif
+    for (l = 0; l < lanes; ++l) {
+        hashblocks_sha256(state[l], in[l], inlen);
+    }
+}
+
+static size_t crypto_hashblocks_sha256(uint8_t *statebytes,
                                        const uint8_t *in, size_t inlen) {
-    uint64_t state[8];
+    uint32_t state[8];
+
+    for (size_t i = 0; i < 8; ++i) {
+        state[i] = load_bigendian_32(statebytes + 4 * i);
+    }
+    inlen = hashblocks_sha256(state, in, inlen);
+    for (size_t i = 0; i < 8; ++i) {
+        store_bigendian_32(statebytes + 4 * i, state[i]);
+    }
+
+    return inlen;
+}
+
+static size_t hashblocks_sha512(uint64_t state[8],
+                                const uint8_t *in, size_t inlen) {
     uint64_t a;
     uint64_t b;
     uint64_t c;
@@ -300,22 +529,14 @@ static size_t crypto_hashblocks_sha512(uint8_t *statebytes,
     uint64_t T1;
     uint64_t T2;
 
-    a = load_bigendian_64(statebytes + 0);
-    state[0] = a;
-    b = load_bigendian_64(statebytes + 8);
-    state[1] = b;
-    c = load_bigendian_64(statebytes + 16);
-    state[2] = c;
-    d = load_bigendian_64(statebytes + 24);
-    state[3] = d;
-    e = load_bigendian_64(statebytes + 32);
-    state[4] = e;
-    f = load_bigendian_64(statebytes + 40);
-    state[5] = f;
-    g = load_bigendian_64(statebytes + 48);
-    state[6] = g;
-    h = load_bigendian_64(statebytes + 56);
-    state[7] = h;
+    a = state[0];
+    b = state[1];
+    c = state[2];
+    d = state[3];
+    e = state[4];
+    f = state[5];
+    g = state[6];
+    h = state[7];
 
     while (inlen >= 128) {
         uint64_t w0 = load_bigendian_64(in + 0);
@@ -450,14 +671,20 @@ static size_t crypto_hashblocks_sha512(uint8_t *statebytes,
         inlen -= 128;
     }
 
-    store_bigendian_64(statebytes + 0, state[0]);
-    store_bigendian_64(statebytes + 8, state[1]);
-    store_bigendian_64(statebytes + 16, state[2]);
-    store_bigendian_64(statebytes + 24, state[3]);
-    store_bigendian_64(statebytes + 32, state[4]);
-    store_bigendian_64(statebytes + 40, state[5]);
-    store_bigendian_64(statebytes + 48, state[6]);
-    store_bigendian_64(statebytes + 56, state[7]);
+    return inlen;
+}
+
+static size_t crypto_hashblocks_sha512(uint8_t *statebytes,
+                                       const uint8_t *in, size_t inlen) {
+    uint64_t state[8];
+
+    for (size_t i = 0; i < 8; ++i) {
+        state[i] = load_bigendian_64(statebytes + 8 * i);
+    }
+    inlen = hashblocks_sha512(state, in, inlen);
+    for (size_t i = 0; i < 8; ++i) {
+        store_bigendian_64(statebytes + 8 * i, state[i]);
+    }
 
     return inlen;
 }
@@ -740,6 +967,165 @@ void sha384_inc_finalize(uint8_t *out, sha384ctx *state, const uint8_t *in, size
     }
 }
 
+/*
+ * Pads the inlen trailing message bytes held at the start of block[] in
+ * place, and compresses the result into state. bytes is the length of the
+ * whole message. block[] must have room for one block, or two if the length
+ * field does not fit after the message bytes. pad_sha256() only pads, and
+ * returns the padded length.
+ */
+static size_t pad_sha256(uint8_t *block, size_t inlen, uint64_t bytes) {
+    size_t padlen = inlen < 56 ? 64 : 128;
+
+    block[inlen] = 0x80;
+    memset(block + inlen + 1, 0, padlen - 8 - (inlen + 1));
+    store_bigendian_64(block + padlen - 8, bytes << 3);
+    return padlen;
+}
+
+static void pad_hashblocks_sha256(uint32_t state[8], uint8_t *block,
+                                  size_t inlen, uint64_t bytes) {
+    hashblocks_sha256(state, block, pad_sha256(block, inlen, bytes));
+}
+
+static void pad_hashblocks_sha512(uint64_t state[8], uint8_t *block,
+                                  size_t inlen, uint64_t bytes) {
+    size_t padlen = inlen < 112 ? 128 : 256;
+
+    block[inlen] = 0x80;
+    memset(block + inlen + 1, 0, padlen - 8 - (inlen + 1));
+    block[padlen - 9] = (uint8_t) (bytes >> 61);
+    store_bigendian_64(block + padlen - 8, bytes << 3);
+    hashblocks_sha512(state, block, padlen);
+}
+
+void sha256_midstate_init(uint32_t state[8], const uint8_t *in, size_t inblocks) {
+    for (size_t i = 0; i < 8; ++i) {
+        state[i] = load_bigendian_32(iv_256 + 4 * i);
+    }
+    hashblocks_sha256(state, in, 64 * inblocks);
+}
+
+void sha256_midstate_finalize(uint8_t *out, const uint32_t midstate[8],
+                              uint64_t prefixlen, const uint8_t *in, size_t inlen) {
+    uint8_t padded[128];
+    uint32_t state[8];
+    size_t tail;
+
+    memcpy(state, midstate, sizeof(state));
+    tail = hashblocks_sha256(state, in, inlen);
+    memcpy(padded, in + inlen - tail, tail);
+    pad_hashblocks_sha256(state, padded, tail, prefixlen + inlen);
+
+    for (size_t i = 0; i < 8; ++i) {
+        store_bigendian_32(out + 4 * i, state[i]);
+    }
+}
+
+void sha256_midstate_finalize_block(uint8_t *out, const uint32_t midstate[8],
+                                    uint64_t prefixlen, uint8_t *block, size_t inlen) {
+    uint32_t state[8];
+
+    memcpy(state, midstate, sizeof(state));
+    pad_hashblocks_sha256(state, block, inlen, prefixlen + inlen);
+
+    for (size_t i = 0; i < 8; ++i) {
+        store_bigendian_32(out + 4 * i, state[i]);
+    }
+}
+
+void sha256_midstate_pad_block(uint8_t *block, size_t inlen, uint64_t prefixlen) {
+    pad_sha256(block, inlen, prefixlen + inlen);
+}
+
+void sha256_midstate_compress_block(uint8_t *out, size_t outlen, const uint32_t midstate[8],
+                                    const uint8_t *block) {
+    uint32_t state[8];
+
+    memcpy(state, midstate, sizeof(state));
+    hashblocks_sha256(state, block, 64);
+
+    for (size_t i = 0; i < outlen / 4; ++i) {
+        store_bigendian_32(out + 4 * i, state[i]);
+    }
+}
+
+void sha256x4_midstate_compress_block(uint8_t *const out[4], size_t outlen,
+                                      const uint32_t midstate[8],
+                                      const uint8_t *const block[4]) {
+    uint32_t state[4][8];
+    size_t i, l;
+
+    for (l = 0; l < 4; ++l) {
+        memcpy(state[l], midstate, sizeof(state[l]));
+    }
+    hashblocks_sha256_lanes(state, block, 4, 64);
+
+    for (l = 0; l < 4; ++l) {
+        for (i = 0; i < outlen / 4; ++i) {
+            store_bigendian_32(out[l] + 4 * i, state[l][i]);
+        }
+    }
+}
+
+static void sha256_lanes_midstate_finalize(uint8_t *const out[], const uint32_t midstate[8],
+        uint64_t prefixlen, const uint8_t *const in[], size_t lanes, size_t inlen) {
+    uint8_t padded[8][128];
+    uint32_t state[8][8];
+    const uint8_t *p[8];
+    size_t tail = inlen & 63;
+    size_t padlen = 0;
+    size_t i, l;
+
+    for (l = 0; l < lanes; ++l) {
+        memcpy(state[l], midstate, sizeof(state[l]));
+        memcpy(padded[l], in[l] + inlen - tail, tail);
+        padlen = pad_sha256(padded[l], tail, prefixlen + inlen);
+        p[l] = padded[l];
+    }
+    hashblocks_sha256_lanes(state, in, lanes, inlen - tail);
+    hashblocks_sha256_lanes(state, p, lanes, padlen);
+
+    for (l = 0; l < lanes; ++l) {
+        for (i = 0; i < 8; ++i) {
+            store_bigendian_32(out[l] + 4 * i, state[l][i]);
+        }
+    }
+}
+
+void sha256x4_midstate_finalize(uint8_t *const out[4], const uint32_t midstate[8],
+                                uint64_t prefixlen, const uint8_t *const in[4], size_t inlen) {
+    sha256_lanes_midstate_finalize(out, midstate, prefixlen, in, 4, inlen);
+}
+
+void sha256x8_midstate_finalize(uint8_t *const out[8], const uint32_t midstate[8],
+                                uint64_t prefixlen, const uint8_t *const in[8], size_t inlen) {
+    sha256_lanes_midstate_finalize(out, midstate, prefixlen, in, 8, inlen);
+}
+
+void sha512_midstate_init(uint64_t state[8], const uint8_t *in, size_t inblocks) {
+    for (size_t i = 0; i < 8; ++i) {
+        state[i] = load_bigendian_64(iv_512 + 8 * i);
+    }
+    hashblocks_sha512(state, in, 128 * inblocks);
+}
+
+void sha512_midstate_finalize(uint8_t *out, const uint64_t midstate[8],
+                              uint64_t prefixlen, const uint8_t *in, size_t inlen) {
+    uint8_t padded[256];
+    uint64_t state[8];
+    size_t tail;
+
+    memcpy(state, midstate, sizeof(state));
+    tail = hashblocks_sha512(state, in, inlen);
+    memcpy(padded, in + inlen - tail, tail);
+    pad_hashblocks_sha512(state, padded, tail, prefixlen + inlen);
+
+    for (size_t i = 0; i < 8; ++i) {
+        store_bigendian_64(out + 8 * i, state[i]);
+    }
+}
+
 void sha224(uint8_t *out, const uint8_t *in, size_t inlen) {
     sha224ctx state;
 
@@ -102,6 +102,59 @@ void sha256_inc_ctx_release(sha256ctx *state);
  */
 void sha256(uint8_t *out, const uint8_t *in, size_t inlen);
 
+/**
+ * Midstate API: the chaining value after a prefix of whole blocks, kept as
+ * plain words so that it can be stored in a caller structure and reused for
+ * many messages sharing that prefix, with no allocation or copy of an
+ * incremental context.
+ *
+ * sha256_midstate_init() compresses inblocks 64-byte blocks starting from
+ * the IV. sha256_midstate_finalize() hashes the rest of a message whose
+ * first prefixlen bytes went into midstate.
+ */
+void sha256_midstate_init(uint32_t state[8], const uint8_t *in, size_t inblocks);
+
+void sha256_midstate_finalize(uint8_t *out, const uint32_t midstate[8],
+                              uint64_t prefixlen, const uint8_t *in, size_t inlen);
+
+/**
+ * Same as sha256_midstate_finalize() for inlen < 56, with the remaining
+ * message bytes already at the start of the 64-byte buffer block[], which is
+ * padded in place (and so clobbered) and compressed once.
+ */
+void sha256_midstate_finalize_block(uint8_t *out, const uint32_t midstate[8],
+                                    uint64_t prefixlen, uint8_t *block, size_t inlen);
+
+/**
+ * Single-block midstate API for hashing the same block over and over with a
+ * few bytes changed (a WOTS chain): sha256_midstate_pad_block() writes the
+ * padding of a message whose last inlen < 56 bytes are at the start of
+ * block[] and whose first prefixlen bytes went into the midstate, once.
+ * sha256_midstate_compress_block() then compresses the padded block from
+ * midstate and stores the first outlen bytes (a multiple of 4) of the digest
+ * to out, which may point into block[] itself.
+ */
+void sha256_midstate_pad_block(uint8_t *block, size_t inlen, uint64_t prefixlen);
+
+void sha256_midstate_compress_block(uint8_t *out, size_t outlen, const uint32_t midstate[8],
+                                    const uint8_t *block);
+
+void sha256x4_midstate_compress_block(uint8_t *const out[4], size_t outlen,
+                                      const uint32_t midstate[8],
+                                      const uint8_t *const block[4]);
+
+/**
+ * Multi-buffer midstate API: sha256_midstate_finalize() on four or eight
+ * messages of the same length inlen, all continuing from midstate. On hosts
+ * with AVX2 but no SHA extensions the lanes are compressed together;
+ * elsewhere they are hashed one after the other.
+ */
+void sha256x4_midstate_finalize(uint8_t *const out[4], const uint32_t midstate[8],
+                                uint64_t prefixlen, const uint8_t *const in[4], size_t inlen);
+
+void sha256x8_midstate_finalize(uint8_t *const out[8], const uint32_t midstate[8],
+                                uint64_t prefixlen, const uint8_t *const in[8], size_t inlen);
+
 /* ====== SHA384 API ==== */
 
 /**
@@ -170,4 +223,12 @@ void sha512_inc_ctx_release(sha512ctx *state);
  */
 void sha512(uint8_t *out, const uint8_t *in, size_t inlen);
 
+/**
+ * Midstate API, see sha256_midstate_init(); blocks are 128 bytes.
+ */
+void sha512_midstate_init(uint64_t state[8], const uint8_t *in, size_t inblocks);
+
+void sha512_midstate_finalize(uint8_t *out, const uint64_t midstate[8],
+                              uint64_t prefixlen, const uint8_t *in, size_t inlen);
+
 #endif
@@ -79,4 +79,28 @@ int PQCLEAN_FALCON1024_CLEAN_crypto_sign_open(
     uint8_t *m, size_t *mlen,
     const uint8_t *sm, size_t smlen, const uint8_t *pk);
 
+/*
+ * Variants of crypto_sign_keypair(), crypto_sign_signature() and
+ * crypto_sign_verify() that take their large temporaries from the
+ * caller-provided buffer ws[] instead of the stack. ws[] must be aligned
+ * on 8 bytes and hold at least as many bytes as the matching *_wsbytes()
+ * function returns; its contents on entry and exit are unspecified.
+ */
+size_t PQCLEAN_FALCON1024_CLEAN_crypto_sign_keypair_wsbytes(void);
+
+size_t PQCLEAN_FALCON1024_CLEAN_crypto_sign_signature_wsbytes(void);
+
+size_t PQCLEAN_FALCON1024_CLEAN_crypto_sign_verify_wsbytes(void);
+
+int PQCLEAN_FALCON1024_CLEAN_crypto_sign_keypair_ws(
+    uint8_t *pk, uint8_t *sk, void *ws);
+
+int PQCLEAN_FALCON1024_CLEAN_crypto_sign_signature_ws(
+    uint8_t *sig, size_t *siglen,
+    const uint8_t *m, size_t mlen, const uint8_t *sk, void *ws);
+
+int PQCLEAN_FALCON1024_CLEAN_crypto_sign_verify_ws(
+    const uint8_t *sig, size_t siglen,
+    const uint8_t *m, size_t mlen, const uint8_t *pk, void *ws);
+
 #endif
@@ -36,10 +36,12 @@
  *      message
  */
 
-/* see api.h */
-int
-PQCLEAN_FALCONPADDED512_CLEAN_crypto_sign_keypair(
-    uint8_t *pk, uint8_t *sk) {
+/*
+ * Large temporaries of key generation, signing and verification. The
+ * regular API functions keep them on the stack; the *_ws() variants take
+ * them from a caller-provided buffer instead (see api.h).
+ */
+typedef struct {
     union {
         uint8_t b[FALCON_KEYGEN_TEMP_9];
         uint64_t dummy_u64;
@@ -47,6 +49,35 @@ PQCLEAN_FALCONPADDED512_CLEAN_crypto_sign_keypair(
     } tmp;
     int8_t f[512], g[512], F[512];
     uint16_t h[512];
+} keygen_workspace;
+
+typedef struct {
+    union {
+        uint8_t b[72 * 512];
+        uint64_t dummy_u64;
+        fpr dummy_fpr;
+    } tmp;
+    int8_t f[512], g[512], F[512], G[512];
+    struct {
+        int16_t sig[512];
+        uint16_t hm[512];
+    } r;
+} sign_workspace;
+
+typedef struct {
+    union {
+        uint8_t b[2 * 512];
+        uint64_t dummy_u64;
+        fpr dummy_fpr;
+    } tmp;
+    uint16_t h[512], hm[512];
+    int16_t sig[512];
+} verify_workspace;
+
+static int
+do_keypair(uint8_t *pk, uint8_t *sk, keygen_workspace *ws) {
+    int8_t *f = ws->f, *g = ws->g, *F = ws->F;
+    uint16_t *h = ws->h;
     unsigned char seed[48];
     inner_shake256_context rng;
     size_t u, v;
@@ -58,7 +89,7 @@ PQCLEAN_FALCONPADDED512_CLEAN_crypto_sign_keypair(
     inner_shake256_init(&rng);
     inner_shake256_inject(&rng, seed, sizeof seed);
     inner_shake256_flip(&rng);
-    PQCLEAN_FALCONPADDED512_CLEAN_keygen(&rng, f, g, F, NULL, h, 9, tmp.b);
+    PQCLEAN_FALCONPADDED512_CLEAN_keygen(&rng, f, g, F, NULL, h, 9, ws->tmp.b);
     inner_shake256_ctx_release(&rng);
 
     /*
@@ -105,6 +136,22 @@ PQCLEAN_FALCONPADDED512_CLEAN_crypto_sign_keypair(
     return 0;
 }
 
+/* see api.h */
+int
+PQCLEAN_FALCONPADDED512_CLEAN_crypto_sign_keypair(
+    uint8_t *pk, uint8_t *sk) {
+    keygen_workspace ws;
+
+    return do_keypair(pk, sk, &ws);
+}
+
+/* see api.h */
+int
+PQCLEAN_FALCONPADDED512_CLEAN_crypto_sign_keypair_ws(
+    uint8_t *pk, uint8_t *sk, void *ws) {
+    return do_keypair(pk, sk, (keygen_workspace *)ws);
+}
+
 /*
  * Compute the signature. nonce[] receives the nonce and must have length
  * NONCELEN bytes. sigbuf[] receives the signature value (without nonce
@@ -120,17 +167,8 @@ PQCLEAN_FALCONPADDED512_CLEAN_crypto_sign_keypair(
  */
 static int
 do_sign(uint8_t *nonce, uint8_t *sigbuf, size_t sigbuflen,
-        const uint8_t *m, size_t mlen, const uint8_t *sk) {
-    union {
-        uint8_t b[72 * 512];
-        uint64_t dummy_u64;
-        fpr dummy_fpr;
-    } tmp;
-    int8_t f[512], g[512], F[512], G[512];
-    struct {
-        int16_t sig[512];
-        uint16_t hm[512];
-    } r;
+        const uint8_t *m, size_t mlen, const uint8_t *sk, sign_workspace *ws) {
+    int8_t *f = ws->f, *g = ws->g, *F = ws->F, *G = ws->G;
     unsigned char seed[48];
     inner_shake256_context sc;
     size_t u, v;
@@ -166,7 +204,7 @@ do_sign(uint8_t *nonce, uint8_t *sigbuf, size_t sigbuflen,
     if (u != PQCLEAN_FALCONPADDED512_CLEAN_CRYPTO_SECRETKEYBYTES) {
         return -1;
     }
-    if (!PQCLEAN_FALCONPADDED512_CLEAN_complete_private(G, f, g, F, 9, tmp.b)) {
+    if (!PQCLEAN_FALCONPADDED512_CLEAN_complete_private(G, f, g, F, 9, ws->tmp.b)) {
         return -1;
     }
 
@@ -182,7 +220,7 @@ do_sign(uint8_t *nonce, uint8_t *sigbuf, size_t sigbuflen,
     inner_shake256_inject(&sc, nonce, NONCELEN);
     inner_shake256_inject(&sc, m, mlen);
     inner_shake256_flip(&sc);
-    PQCLEAN_FALCONPADDED512_CLEAN_hash_to_point_ct(&sc, r.hm, 9, tmp.b);
+    PQCLEAN_FALCONPADDED512_CLEAN_hash_to_point_ct(&sc, ws->r.hm, 9, ws->tmp.b);
     inner_shake256_ctx_release(&sc);
 
     /*
@@ -198,8 +236,8 @@ do_sign(uint8_t *nonce, uint8_t *sigbuf, size_t sigbuflen,
      * value is found that fits in the provided buffer.
      */
     for (;;) {
-        PQCLEAN_FALCONPADDED512_CLEAN_sign_dyn(r.sig, &sc, f, g, F, G, r.hm, 9, tmp.b);
-        v = PQCLEAN_FALCONPADDED512_CLEAN_comp_encode(sigbuf, sigbuflen, r.sig, 9);
+        PQCLEAN_FALCONPADDED512_CLEAN_sign_dyn(ws->r.sig, &sc, f, g, F, G, ws->r.hm, 9, ws->tmp.b);
+        v = PQCLEAN_FALCONPADDED512_CLEAN_comp_encode(sigbuf, sigbuflen, ws->r.sig, 9);
         if (v != 0) {
             inner_shake256_ctx_release(&sc);
             memset(sigbuf + v, 0, sigbuflen - v);
@@ -216,14 +254,9 @@ do_sign(uint8_t *nonce, uint8_t *sigbuf, size_t sigbuflen,
 static int
 do_verify(
     const uint8_t *nonce, const uint8_t *sigbuf, size_t sigbuflen,
-    const uint8_t *m, size_t mlen, const uint8_t *pk) {
-    union {
-        uint8_t b[2 * 512];
-        uint64_t dummy_u64;
-        fpr dummy_fpr;
-    } tmp;
-    uint16_t h[512], hm[512];
-    int16_t sig[512];
+    const uint8_t *m, size_t mlen, const uint8_t *pk, verify_workspace *ws) {
+    uint16_t *h = ws->h, *hm = ws->hm;
+    int16_t *sig = ws->sig;
     inner_shake256_context sc;
     size_t v;
 
@@ -270,27 +303,25 @@ do_verify(
     inner_shake256_inject(&sc, nonce, NONCELEN);
     inner_shake256_inject(&sc, m, mlen);
     inner_shake256_flip(&sc);
-    PQCLEAN_FALCONPADDED512_CLEAN_hash_to_point_ct(&sc, hm, 9, tmp.b);
+    PQCLEAN_FALCONPADDED512_CLEAN_hash_to_point_ct(&sc, hm, 9, ws->tmp.b);
     inner_shake256_ctx_release(&sc);
 
     /*
      * Verify signature.
      */
-    if (!PQCLEAN_FALCONPADDED512_CLEAN_verify_raw(hm, sig, h, 9, tmp.b)) {
+    if (!PQCLEAN_FALCONPADDED512_CLEAN_verify_raw(hm, sig, h, 9, ws->tmp.b)) {
         return -1;
     }
     return 0;
 }
 
-/* see api.h */
-int
-PQCLEAN_FALCONPADDED512_CLEAN_crypto_sign_signature(
-    uint8_t *sig, size_t *siglen,
-    const uint8_t *m, size_t mlen, const uint8_t *sk) {
+static int
+do_signature(uint8_t *sig, size_t *siglen,
+             const uint8_t *m, size_t mlen, const uint8_t *sk, sign_workspace *ws) {
     size_t vlen;
 
     vlen = PQCLEAN_FALCONPADDED512_CLEAN_CRYPTO_BYTES - NONCELEN - 1;
-    if (do_sign(sig + 1, sig + 1 + NONCELEN, vlen, m, mlen, sk) < 0) {
+    if (do_sign(sig + 1, sig + 1 + NONCELEN, vlen, m, mlen, sk, ws) < 0) {
         return -1;
     }
     sig[0] = 0x30 + 9;
@@ -300,9 +331,25 @@ PQCLEAN_FALCONPADDED512_CLEAN_crypto_sign_signature(
 
 /* see api.h */
 int
-PQCLEAN_FALCONPADDED512_CLEAN_crypto_sign_verify(
-    const uint8_t *sig, size_t siglen,
-    const uint8_t *m, size_t mlen, const uint8_t *pk) {
+PQCLEAN_FALCONPADDED512_CLEAN_crypto_sign_signature(
+    uint8_t *sig, size_t *siglen,
+    const uint8_t *m, size_t mlen, const uint8_t *sk) {
+    sign_workspace ws;
+
+    return do_signature(sig, siglen, m, mlen, sk, &ws);
+}
+
+/* see api.h */
+int
+PQCLEAN_FALCONPADDED512_CLEAN_crypto_sign_signature_ws(
+    uint8_t *sig, size_t *siglen,
+    const uint8_t *m, size_t mlen, const uint8_t *sk, void *ws) {
+    return do_signature(sig, siglen, m, mlen, sk, (sign_workspace *)ws);
+}
+
+static int
+do_verify_sig(const uint8_t *sig, size_t siglen,
+              const uint8_t *m, size_t mlen, const uint8_t *pk, verify_workspace *ws) {
     if (siglen < 1 + NONCELEN) {
         return -1;
     }
@@ -310,7 +357,43 @@ PQCLEAN_FALCONPADDED512_CLEAN_crypto_sign_verify(
         return -1;
     }
     return do_verify(sig + 1,
-                     sig + 1 + NONCELEN, siglen - 1 - NONCELEN, m, mlen, pk);
+                     sig + 1 + NONCELEN, siglen - 1 - NONCELEN, m, mlen, pk, ws);
+}
+
+/* see api.h */
+int
+PQCLEAN_FALCONPADDED512_CLEAN_crypto_sign_verify(
+    const uint8_t *sig, size_t siglen,
+    const uint8_t *m, size_t mlen, const uint8_t *pk) {
+    verify_workspace ws;
+
+    return do_verify_sig(sig, siglen, m, mlen, pk, &ws);
+}
+
+/* see api.h */
+int
+PQCLEAN_FALCONPADDED512_CLEAN_crypto_sign_verify_ws(
+    const uint8_t *sig, size_t siglen,
+    const uint8_t *m, size_t mlen, const uint8_t *pk, void *ws) {
+    return do_verify_sig(sig, siglen, m, mlen, pk, (verify_workspace *)ws);
+}
+
+/* see api.h */
+size_t
+PQCLEAN_FALCONPADDED512_CLEAN_crypto_sign_keypair_wsbytes(void) {
+    return sizeof(keygen_workspace);
+}
+
+/* see api.h */
+size_t
+PQCLEAN_FALCONPADDED512_CLEAN_crypto_sign_signature_wsbytes(void) {
+    return sizeof(sign_workspace);
+}
+
+/* see api.h */
+size_t
+PQCLEAN_FALCONPADDED512_CLEAN_crypto_sign_verify_wsbytes(void) {
+    return sizeof(verify_workspace);
 }
 
 /* see api.h */
@@ -318,6 +401,7 @@ int
 PQCLEAN_FALCONPADDED512_CLEAN_crypto_sign(
     uint8_t *sm, size_t *smlen,
     const uint8_t *m, size_t mlen, const uint8_t *sk) {
+    sign_workspace ws;
     uint8_t *sigbuf;
     size_t sigbuflen;
 
@@ -328,7 +412,7 @@ PQCLEAN_FALCONPADDED512_CLEAN_crypto_sign(
     memmove(sm + PQCLEAN_FALCONPADDED512_CLEAN_CRYPTO_BYTES, m, mlen);
     sigbuf = sm + 1 + NONCELEN;
     sigbuflen = PQCLEAN_FALCONPADDED512_CLEAN_CRYPTO_BYTES - NONCELEN - 1;
-    if (do_sign(sm + 1, sigbuf, sigbuflen, m, mlen, sk) < 0) {
+    if (do_sign(sm + 1, sigbuf, sigbuflen, m, mlen, sk, &ws) < 0) {
         return -1;
     }
     sm[0] = 0x30 + 9;
@@ -342,6 +426,7 @@ int
 PQCLEAN_FALCONPADDED512_CLEAN_crypto_sign_open(
     uint8_t *m, size_t *mlen,
     const uint8_t *sm, size_t smlen, const uint8_t *pk) {
+    verify_workspace ws;
     const uint8_t *sigbuf;
     size_t pmlen, sigbuflen;
 
@@ -361,7 +446,7 @@ PQCLEAN_FALCONPADDED512_CLEAN_crypto_sign_open(
      * follows the signature value.
      */
     if (do_verify(sm + 1, sigbuf, sigbuflen,
-                  sm + PQCLEAN_FALCONPADDED512_CLEAN_CRYPTO_BYTES, pmlen, pk) < 0) {
+                  sm + PQCLEAN_FALCONPADDED512_CLEAN_CRYPTO_BYTES, pmlen, pk, &ws) < 0) {
         return -1;
     }
 
@@ -27,6 +27,9 @@ int PQCLEAN_MLDSA44_CLEAN_poly_chknorm(const poly *a, int32_t B);
 void PQCLEAN_MLDSA44_CLEAN_poly_uniform(poly *a,
                                         const uint8_t seed[SEEDBYTES],
                                         uint16_t nonce);
+void PQCLEAN_MLDSA44_CLEAN_poly_uniform_4x(poly *a0, poly *a1, poly *a2, poly *a3,
+        const uint8_t seed[SEEDBYTES],
+        uint16_t nonce0, uint16_t nonce1, uint16_t nonce2, uint16_t nonce3);
 void PQCLEAN_MLDSA44_CLEAN_poly_uniform_eta(poly *a,
         const uint8_t seed[CRHBYTES],
         uint16_t nonce);
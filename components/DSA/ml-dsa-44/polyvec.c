@@ -1,3 +1,4 @@
+#include "dsa_config.h"
 #include "params.h"
 #include "poly.h"
 #include "polyvec.h"
@@ -16,11 +17,33 @@
 void PQCLEAN_MLDSA44_CLEAN_polyvec_matrix_expand(polyvecl mat[K], const uint8_t rho[SEEDBYTES]) {
     unsigned int i, j;
 
+#ifdef CONFIG_DSA_HASH_X4
+    /* Collect entries four at a time; the last few go one by one */
+    poly *a[4];
+    uint16_t nonce[4];
+    unsigned int n = 0;
+
+    for (i = 0; i < K; ++i) {
+        for (j = 0; j < L; ++j) {
+            a[n] = &mat[i].vec[j];
+            nonce[n] = (uint16_t) ((i << 8) + j);
+            if (++n == 4) {
+                PQCLEAN_MLDSA44_CLEAN_poly_uniform_4x(a[0], a[1], a[2], a[3], rho,
+                                                      nonce[0], nonce[1], nonce[2], nonce[3]);
+                n = 0;
+            }
+        }
+    }
+    for (i = 0; i < n; ++i) {
+        PQCLEAN_MLDSA44_CLEAN_poly_uniform(a[i], rho, nonce[i]);
+    }
+#else
     for (i = 0; i < K; ++i) {
         for (j = 0; j < L; ++j) {
             PQCLEAN_MLDSA44_CLEAN_poly_uniform(&mat[i].vec[j], rho, (uint16_t) ((i << 8) + j));
         }
     }
+#endif
 }
 
 void PQCLEAN_MLDSA44_CLEAN_polyvec_matrix_pointwise_montgomery(polyveck *t, const polyvecl mat[K], const polyvecl *v) {
@@ -31,6 +54,33 @@ void PQCLEAN_MLDSA44_CLEAN_polyvec_matrix_pointwise_montgomery(polyveck *t, cons
     }
 }
 
+/*************************************************
+* Name:        PQCLEAN_MLDSA44_CLEAN_polyvec_matrix_stream_pointwise_montgomery
+*
+* Description: Same product as polyvec_matrix_pointwise_montgomery() with
+*              the matrix A given by its seed. Each entry a_{i,j} is sampled
+*              as in expand_mat, multiplied into the row sum and dropped, so
+*              only one polynomial of A exists at a time.
+*
+* Arguments:   - polyveck *t: output vector
+*              - const uint8_t rho[]: byte array containing seed rho
+*              - const polyvecl *v: input vector in NTT domain
+**************************************************/
+void PQCLEAN_MLDSA44_CLEAN_polyvec_matrix_stream_pointwise_montgomery(polyveck *t, const uint8_t rho[SEEDBYTES], const polyvecl *v) {
+    unsigned int i, j;
+    poly a;
+
+    for (i = 0; i < K; ++i) {
+        PQCLEAN_MLDSA44_CLEAN_poly_uniform(&a, rho, (uint16_t) (i << 8));
+        PQCLEAN_MLDSA44_CLEAN_poly_pointwise_montgomery(&t->vec[i], &a, &v->vec[0]);
+        for (j = 1; j < L; ++j) {
+            PQCLEAN_MLDSA44_CLEAN_poly_uniform(&a, rho, (uint16_t) ((i << 8) + j));
+            PQCLEAN_MLDSA44_CLEAN_poly_pointwise_montgomery(&a, &a, &v->vec[j]);
+            PQCLEAN_MLDSA44_CLEAN_poly_add(&t->vec[i], &t->vec[i], &a);
+        }
+    }
+}
+
 /**************************************************************/
 /************ Vectors of polynomials of length L **************/
 /**************************************************************/
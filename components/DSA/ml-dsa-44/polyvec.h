@@ -62,4 +62,6 @@ void PQCLEAN_MLDSA44_CLEAN_polyvec_matrix_expand(polyvecl mat[K], const uint8_t
 
 void PQCLEAN_MLDSA44_CLEAN_polyvec_matrix_pointwise_montgomery(polyveck *t, const polyvecl mat[K], const polyvecl *v);
 
+void PQCLEAN_MLDSA44_CLEAN_polyvec_matrix_stream_pointwise_montgomery(polyveck *t, const uint8_t rho[SEEDBYTES], const polyvecl *v);
+
 #endif
@@ -1,3 +1,4 @@
+#include "dsa_config.h"
 #include "fips202.h"
 #include "packing.h"
 #include "params.h"
@@ -7,26 +8,106 @@
 #include "sign.h"
 #include "symmetric.h"
 #include <stdint.h>
+#include <string.h>
+
+/*
+ * The matrix A as key generation, signing and verification hold it. With
+ * CONFIG_DSA_ML_DSA_STREAM_MATRIX only its seed rho is kept and each
+ * matrix-vector product samples A again one polynomial at a time, which
+ * saves K * L KB at the price of an ExpandA per product.
+ */
+#ifdef CONFIG_DSA_ML_DSA_STREAM_MATRIX
+typedef uint8_t matrix[SEEDBYTES];
+#else
+typedef polyvecl matrix[K];
+#endif
+
+static void matrix_expand(matrix mat, const uint8_t rho[SEEDBYTES]) {
+#ifdef CONFIG_DSA_ML_DSA_STREAM_MATRIX
+    memcpy(mat, rho, SEEDBYTES);
+#else
+    PQCLEAN_MLDSA44_CLEAN_polyvec_matrix_expand(mat, rho);
+#endif
+}
 
-/*************************************************
-* Name:        PQCLEAN_MLDSA44_CLEAN_crypto_sign_keypair
-*
-* Description: Generates public and private key.
-*
-* Arguments:   - uint8_t *pk: pointer to output public key (allocated
-*                             array of PQCLEAN_MLDSA44_CLEAN_CRYPTO_PUBLICKEYBYTES bytes)
-*              - uint8_t *sk: pointer to output private key (allocated
-*                             array of PQCLEAN_MLDSA44_CLEAN_CRYPTO_SECRETKEYBYTES bytes)
-*
-* Returns 0 (success)
-**************************************************/
-int PQCLEAN_MLDSA44_CLEAN_crypto_sign_keypair(uint8_t *pk, uint8_t *sk) {
+static void matrix_pointwise_montgomery(polyveck *t, const matrix mat, const polyvecl *v) {
+#ifdef CONFIG_DSA_ML_DSA_STREAM_MATRIX
+    PQCLEAN_MLDSA44_CLEAN_polyvec_matrix_stream_pointwise_montgomery(t, mat, v);
+#else
+    PQCLEAN_MLDSA44_CLEAN_polyvec_matrix_pointwise_montgomery(t, mat, v);
+#endif
+}
+
+/*
+ * Large temporaries of key generation, signing and verification. The
+ * regular API functions keep them on the stack; the *_ws() variants take
+ * them from a caller-provided buffer instead (see api.h).
+ */
+typedef struct {
+    matrix mat;
+    polyvecl s1, s1hat;
+    polyveck s2, t1, t0;
+} keypair_workspace;
+
+/*
+ * What signing derives from the secret key alone: tr, key, the matrix A
+ * (see above), and s1, s2 and t0 in the NTT domain. It is built on
+ * every signature, or once per key in a key context (see api.h).
+ */
+typedef struct {
+    uint8_t tr[TRBYTES];
+    uint8_t key[SEEDBYTES];
+    matrix mat;
+    polyvecl s1;
+    polyveck s2, t0;
+} expanded_sk;
+
+/* The temporaries of the rejection sampling loop */
+typedef struct {
+    polyvecl y, z;
+    polyveck w1, w0, h;
+    poly cp;
+} rejection_workspace;
+
+typedef struct {
+    expanded_sk esk;
+    rejection_workspace rej;
+} signature_workspace;
+
+/* The temporaries of checking a signature against a prepared public key */
+typedef struct {
+    polyvecl z;
+    polyveck w1, h;
+    poly cp, ct1;
+} check_workspace;
+
+/*
+ * Besides tr and the matrix A, verification derives t1 * 2^d in the NTT
+ * domain from the public key alone.
+ */
+typedef struct {
+    matrix mat;
+    polyveck t1;
+    check_workspace chk;
+} verify_workspace;
+
+/*
+ * Key context. tr and A are the same for both halves of a key pair, so
+ * esk.tr and esk.mat serve verification too; the rest of esk is only set
+ * with has_sk, and t1 with has_pk.
+ */
+typedef struct {
+    int has_sk, has_pk;
+    expanded_sk esk;
+    polyveck t1;
+} key_context;
+
+static int keypair_ws(uint8_t *pk, uint8_t *sk, keypair_workspace *ws) {
     uint8_t seedbuf[2 * SEEDBYTES + CRHBYTES];
     uint8_t tr[TRBYTES];
     const uint8_t *rho, *rhoprime, *key;
-    polyvecl mat[K];
-    polyvecl s1, s1hat;
-    polyveck s2, t1, t0;
+    polyvecl *s1 = &ws->s1, *s1hat = &ws->s1hat;
+    polyveck *s2 = &ws->s2, *t1 = &ws->t1, *t0 = &ws->t0;
 
     /* Get randomness for rho, rhoprime and key */
     randombytes(seedbuf, SEEDBYTES);
@@ -38,82 +119,110 @@ int PQCLEAN_MLDSA44_CLEAN_crypto_sign_keypair(uint8_t *pk, uint8_t *sk) {
     key = rhoprime + CRHBYTES;
 
     /* Expand matrix */
-    PQCLEAN_MLDSA44_CLEAN_polyvec_matrix_expand(mat, rho);
+    matrix_expand(ws->mat, rho);
 
     /* Sample short vectors s1 and s2 */
-    PQCLEAN_MLDSA44_CLEAN_polyvecl_uniform_eta(&s1, rhoprime, 0);
-    PQCLEAN_MLDSA44_CLEAN_polyveck_uniform_eta(&s2, rhoprime, L);
+    PQCLEAN_MLDSA44_CLEAN_polyvecl_uniform_eta(s1, rhoprime, 0);
+    PQCLEAN_MLDSA44_CLEAN_polyveck_uniform_eta(s2, rhoprime, L);
 
     /* Matrix-vector multiplication */
-    s1hat = s1;
-    PQCLEAN_MLDSA44_CLEAN_polyvecl_ntt(&s1hat);
-    PQCLEAN_MLDSA44_CLEAN_polyvec_matrix_pointwise_montgomery(&t1, mat, &s1hat);
-    PQCLEAN_MLDSA44_CLEAN_polyveck_reduce(&t1);
-    PQCLEAN_MLDSA44_CLEAN_polyveck_invntt_tomont(&t1);
+    *s1hat = *s1;
+    PQCLEAN_MLDSA44_CLEAN_polyvecl_ntt(s1hat);
+    matrix_pointwise_montgomery(t1, ws->mat, s1hat);
+    PQCLEAN_MLDSA44_CLEAN_polyveck_reduce(t1);
+    PQCLEAN_MLDSA44_CLEAN_polyveck_invntt_tomont(t1);
 
     /* Add error vector s2 */
-    PQCLEAN_MLDSA44_CLEAN_polyveck_add(&t1, &t1, &s2);
+    PQCLEAN_MLDSA44_CLEAN_polyveck_add(t1, t1, s2);
 
     /* Extract t1 and write public key */
-    PQCLEAN_MLDSA44_CLEAN_polyveck_caddq(&t1);
-    PQCLEAN_MLDSA44_CLEAN_polyveck_power2round(&t1, &t0, &t1);
-    PQCLEAN_MLDSA44_CLEAN_pack_pk(pk, rho, &t1);
+    PQCLEAN_MLDSA44_CLEAN_polyveck_caddq(t1);
+    PQCLEAN_MLDSA44_CLEAN_polyveck_power2round(t1, t0, t1);
+    PQCLEAN_MLDSA44_CLEAN_pack_pk(pk, rho, t1);
 
     /* Compute H(rho, t1) and write secret key */
     shake256(tr, TRBYTES, pk, PQCLEAN_MLDSA44_CLEAN_CRYPTO_PUBLICKEYBYTES);
-    PQCLEAN_MLDSA44_CLEAN_pack_sk(sk, rho, tr, key, &t0, &s1, &s2);
+    PQCLEAN_MLDSA44_CLEAN_pack_sk(sk, rho, tr, key, t0, s1, s2);
 
     return 0;
 }
 
 /*************************************************
-* Name:        crypto_sign_signature
+* Name:        PQCLEAN_MLDSA44_CLEAN_crypto_sign_keypair
 *
-* Description: Computes signature.
+* Description: Generates public and private key.
 *
-* Arguments:   - uint8_t *sig:   pointer to output signature (of length PQCLEAN_MLDSA44_CLEAN_CRYPTO_BYTES)
-*              - size_t *siglen: pointer to output length of signature
-*              - uint8_t *m:     pointer to message to be signed
-*              - size_t mlen:    length of message
-*              - uint8_t *ctx:   pointer to context string
-*              - size_t ctxlen:  length of context string
-*              - uint8_t *sk:    pointer to bit-packed secret key
+* Arguments:   - uint8_t *pk: pointer to output public key (allocated
+*                             array of PQCLEAN_MLDSA44_CLEAN_CRYPTO_PUBLICKEYBYTES bytes)
+*              - uint8_t *sk: pointer to output private key (allocated
+*                             array of PQCLEAN_MLDSA44_CLEAN_CRYPTO_SECRETKEYBYTES bytes)
 *
-* Returns 0 (success) or -1 (context string too long)
+* Returns 0 (success)
 **************************************************/
-int PQCLEAN_MLDSA44_CLEAN_crypto_sign_signature_ctx(uint8_t *sig,
-        size_t *siglen,
-        const uint8_t *m,
-        size_t mlen,
-        const uint8_t *ctx,
-        size_t ctxlen,
-        const uint8_t *sk) {
+int PQCLEAN_MLDSA44_CLEAN_crypto_sign_keypair(uint8_t *pk, uint8_t *sk) {
+    keypair_workspace ws;
+
+    return keypair_ws(pk, sk, &ws);
+}
+
+static void expand_sk(expanded_sk *esk, const uint8_t *sk) {
+    uint8_t rho[SEEDBYTES];
+
+    PQCLEAN_MLDSA44_CLEAN_unpack_sk(rho, esk->tr, esk->key, &esk->t0, &esk->s1, &esk->s2, sk);
+
+    /* Expand matrix and transform vectors */
+    matrix_expand(esk->mat, rho);
+    PQCLEAN_MLDSA44_CLEAN_polyvecl_ntt(&esk->s1);
+    PQCLEAN_MLDSA44_CLEAN_polyveck_ntt(&esk->s2);
+    PQCLEAN_MLDSA44_CLEAN_polyveck_ntt(&esk->t0);
+}
+
+static void expand_pk(uint8_t tr[TRBYTES], matrix mat, polyveck *t1, const uint8_t *pk) {
+    uint8_t rho[SEEDBYTES];
+
+    PQCLEAN_MLDSA44_CLEAN_unpack_pk(rho, t1, pk);
+    shake256(tr, TRBYTES, pk, PQCLEAN_MLDSA44_CLEAN_CRYPTO_PUBLICKEYBYTES);
+
+    /* Expand matrix and compute NTT(t1 * 2^d) */
+    matrix_expand(mat, rho);
+    PQCLEAN_MLDSA44_CLEAN_polyveck_shiftl(t1);
+    PQCLEAN_MLDSA44_CLEAN_polyveck_ntt(t1);
+}
+
+static int signature_expanded(uint8_t *sig,
+                              size_t *siglen,
+                              const uint8_t *m,
+                              size_t mlen,
+                              const uint8_t *ctx,
+                              size_t ctxlen,
+                              const expanded_sk *esk,
+                              rejection_workspace *ws) {
     unsigned int n;
-    uint8_t seedbuf[2 * SEEDBYTES + TRBYTES + RNDBYTES + 2 * CRHBYTES];
-    uint8_t *rho, *tr, *key, *mu, *rhoprime, *rnd;
+    uint8_t seedbuf[SEEDBYTES + RNDBYTES + 2 * CRHBYTES];
+    uint8_t *key, *mu, *rhoprime, *rnd;
     uint16_t nonce = 0;
-    polyvecl mat[K], s1, y, z;
-    polyveck t0, s2, w1, w0, h;
-    poly cp;
+    const polyvecl *s1 = &esk->s1;
+    const polyveck *t0 = &esk->t0, *s2 = &esk->s2;
+    polyvecl *y = &ws->y, *z = &ws->z;
+    polyveck *w1 = &ws->w1, *w0 = &ws->w0, *h = &ws->h;
+    poly *cp = &ws->cp;
     shake256incctx state;
 
     if (ctxlen > 255) {
         return -1;
     }
 
-    rho = seedbuf;
-    tr = rho + SEEDBYTES;
-    key = tr + TRBYTES;
+    key = seedbuf;
     rnd = key + SEEDBYTES;
     mu = rnd + RNDBYTES;
     rhoprime = mu + CRHBYTES;
-    PQCLEAN_MLDSA44_CLEAN_unpack_sk(rho, tr, key, &t0, &s1, &s2, sk);
+    memcpy(key, esk->key, SEEDBYTES);
 
     /* Compute mu = CRH(tr, 0, ctxlen, ctx, msg) */
     mu[0] = 0;
     mu[1] = (uint8_t)ctxlen;
     shake256_inc_init(&state);
-    shake256_inc_absorb(&state, tr, TRBYTES);
+    shake256_inc_absorb(&state, esk->tr, TRBYTES);
     shake256_inc_absorb(&state, mu, 2);
     shake256_inc_absorb(&state, ctx, ctxlen);
     shake256_inc_absorb(&state, m, mlen);
@@ -124,27 +233,21 @@ int PQCLEAN_MLDSA44_CLEAN_crypto_sign_signature_ctx(uint8_t *sig,
     randombytes(rnd, RNDBYTES);
     shake256(rhoprime, CRHBYTES, key, SEEDBYTES + RNDBYTES + CRHBYTES);
 
-    /* Expand matrix and transform vectors */
-    PQCLEAN_MLDSA44_CLEAN_polyvec_matrix_expand(mat, rho);
-    PQCLEAN_MLDSA44_CLEAN_polyvecl_ntt(&s1);
-    PQCLEAN_MLDSA44_CLEAN_polyveck_ntt(&s2);
-    PQCLEAN_MLDSA44_CLEAN_polyveck_ntt(&t0);
-
 rej:
     /* Sample intermediate vector y */
-    PQCLEAN_MLDSA44_CLEAN_polyvecl_uniform_gamma1(&y, rhoprime, nonce++);
+    PQCLEAN_MLDSA44_CLEAN_polyvecl_uniform_gamma1(y, rhoprime, nonce++);
 
     /* Matrix-vector multiplication */
-    z = y;
-    PQCLEAN_MLDSA44_CLEAN_polyvecl_ntt(&z);
-    PQCLEAN_MLDSA44_CLEAN_polyvec_matrix_pointwise_montgomery(&w1, mat, &z);
-    PQCLEAN_MLDSA44_CLEAN_polyveck_reduce(&w1);
-    PQCLEAN_MLDSA44_CLEAN_polyveck_invntt_tomont(&w1);
+    *z = *y;
+    PQCLEAN_MLDSA44_CLEAN_polyvecl_ntt(z);
+    matrix_pointwise_montgomery(w1, esk->mat, z);
+    PQCLEAN_MLDSA44_CLEAN_polyveck_reduce(w1);
+    PQCLEAN_MLDSA44_CLEAN_polyveck_invntt_tomont(w1);
 
     /* Decompose w and call the random oracle */
-    PQCLEAN_MLDSA44_CLEAN_polyveck_caddq(&w1);
-    PQCLEAN_MLDSA44_CLEAN_polyveck_decompose(&w1, &w0, &w1);
-    PQCLEAN_MLDSA44_CLEAN_polyveck_pack_w1(sig, &w1);
+    PQCLEAN_MLDSA44_CLEAN_polyveck_caddq(w1);
+    PQCLEAN_MLDSA44_CLEAN_polyveck_decompose(w1, w0, w1);
+    PQCLEAN_MLDSA44_CLEAN_polyveck_pack_w1(sig, w1);
 
     shake256_inc_init(&state);
     shake256_inc_absorb(&state, mu, CRHBYTES);
@@ -152,48 +255,91 @@ rej:
     shake256_inc_finalize(&state);
     shake256_inc_squeeze(sig, CTILDEBYTES, &state);
     shake256_inc_ctx_release(&state);
-    PQCLEAN_MLDSA44_CLEAN_poly_challenge(&cp, sig);
-    PQCLEAN_MLDSA44_CLEAN_poly_ntt(&cp);
+    PQCLEAN_MLDSA44_CLEAN_poly_challenge(cp, sig);
+    PQCLEAN_MLDSA44_CLEAN_poly_ntt(cp);
 
     /* Compute z, reject if it reveals secret */
-    PQCLEAN_MLDSA44_CLEAN_polyvecl_pointwise_poly_montgomery(&z, &cp, &s1);
-    PQCLEAN_MLDSA44_CLEAN_polyvecl_invntt_tomont(&z);
-    PQCLEAN_MLDSA44_CLEAN_polyvecl_add(&z, &z, &y);
-    PQCLEAN_MLDSA44_CLEAN_polyvecl_reduce(&z);
-    if (PQCLEAN_MLDSA44_CLEAN_polyvecl_chknorm(&z, GAMMA1 - BETA)) {
+    PQCLEAN_MLDSA44_CLEAN_polyvecl_pointwise_poly_montgomery(z, cp, s1);
+    PQCLEAN_MLDSA44_CLEAN_polyvecl_invntt_tomont(z);
+    PQCLEAN_MLDSA44_CLEAN_polyvecl_add(z, z, y);
+    PQCLEAN_MLDSA44_CLEAN_polyvecl_reduce(z);
+    if (PQCLEAN_MLDSA44_CLEAN_polyvecl_chknorm(z, GAMMA1 - BETA)) {
         goto rej;
     }
 
     /* Check that subtracting cs2 does not change high bits of w and low bits
      * do not reveal secret information */
-    PQCLEAN_MLDSA44_CLEAN_polyveck_pointwise_poly_montgomery(&h, &cp, &s2);
-    PQCLEAN_MLDSA44_CLEAN_polyveck_invntt_tomont(&h);
-    PQCLEAN_MLDSA44_CLEAN_polyveck_sub(&w0, &w0, &h);
-    PQCLEAN_MLDSA44_CLEAN_polyveck_reduce(&w0);
-    if (PQCLEAN_MLDSA44_CLEAN_polyveck_chknorm(&w0, GAMMA2 - BETA)) {
+    PQCLEAN_MLDSA44_CLEAN_polyveck_pointwise_poly_montgomery(h, cp, s2);
+    PQCLEAN_MLDSA44_CLEAN_polyveck_invntt_tomont(h);
+    PQCLEAN_MLDSA44_CLEAN_polyveck_sub(w0, w0, h);
+    PQCLEAN_MLDSA44_CLEAN_polyveck_reduce(w0);
+    if (PQCLEAN_MLDSA44_CLEAN_polyveck_chknorm(w0, GAMMA2 - BETA)) {
         goto rej;
     }
 
     /* Compute hints for w1 */
-    PQCLEAN_MLDSA44_CLEAN_polyveck_pointwise_poly_montgomery(&h, &cp, &t0);
-    PQCLEAN_MLDSA44_CLEAN_polyveck_invntt_tomont(&h);
-    PQCLEAN_MLDSA44_CLEAN_polyveck_reduce(&h);
-    if (PQCLEAN_MLDSA44_CLEAN_polyveck_chknorm(&h, GAMMA2)) {
+    PQCLEAN_MLDSA44_CLEAN_polyveck_pointwise_poly_montgomery(h, cp, t0);
+    PQCLEAN_MLDSA44_CLEAN_polyveck_invntt_tomont(h);
+    PQCLEAN_MLDSA44_CLEAN_polyveck_reduce(h);
+    if (PQCLEAN_MLDSA44_CLEAN_polyveck_chknorm(h, GAMMA2)) {
         goto rej;
     }
 
-    PQCLEAN_MLDSA44_CLEAN_polyveck_add(&w0, &w0, &h);
-    n = PQCLEAN_MLDSA44_CLEAN_polyveck_make_hint(&h, &w0, &w1);
+    PQCLEAN_MLDSA44_CLEAN_polyveck_add(w0, w0, h);
+    n = PQCLEAN_MLDSA44_CLEAN_polyveck_make_hint(h, w0, w1);
     if (n > OMEGA) {
         goto rej;
     }
 
     /* Write signature */
-    PQCLEAN_MLDSA44_CLEAN_pack_sig(sig, sig, &z, &h);
+    PQCLEAN_MLDSA44_CLEAN_pack_sig(sig, sig, z, h);
     *siglen = PQCLEAN_MLDSA44_CLEAN_CRYPTO_BYTES;
     return 0;
 }
 
+static int signature_ctx_ws(uint8_t *sig,
+                            size_t *siglen,
+                            const uint8_t *m,
+                            size_t mlen,
+                            const uint8_t *ctx,
+                            size_t ctxlen,
+                            const uint8_t *sk,
+                            signature_workspace *ws) {
+    if (ctxlen > 255) {
+        return -1;
+    }
+
+    expand_sk(&ws->esk, sk);
+    return signature_expanded(sig, siglen, m, mlen, ctx, ctxlen, &ws->esk, &ws->rej);
+}
+
+/*************************************************
+* Name:        crypto_sign_signature
+*
+* Description: Computes signature.
+*
+* Arguments:   - uint8_t *sig:   pointer to output signature (of length PQCLEAN_MLDSA44_CLEAN_CRYPTO_BYTES)
+*              - size_t *siglen: pointer to output length of signature
+*              - uint8_t *m:     pointer to message to be signed
+*              - size_t mlen:    length of message
+*              - uint8_t *ctx:   pointer to context string
+*              - size_t ctxlen:  length of context string
+*              - uint8_t *sk:    pointer to bit-packed secret key
+*
+* Returns 0 (success) or -1 (context string too long)
+**************************************************/
+int PQCLEAN_MLDSA44_CLEAN_crypto_sign_signature_ctx(uint8_t *sig,
+        size_t *siglen,
+        const uint8_t *m,
+        size_t mlen,
+        const uint8_t *ctx,
+        size_t ctxlen,
+        const uint8_t *sk) {
+    signature_workspace ws;
+
+    return signature_ctx_ws(sig, siglen, m, mlen, ctx, ctxlen, sk, &ws);
+}
+
 /*************************************************
 * Name:        crypto_sign
 *
@@ -230,55 +376,40 @@ int PQCLEAN_MLDSA44_CLEAN_crypto_sign_ctx(uint8_t *sm,
     return ret;
 }
 
-/*************************************************
-* Name:        crypto_sign_verify
-*
-* Description: Verifies signature.
-*
-* Arguments:   - uint8_t *m: pointer to input signature
-*              - size_t siglen: length of signature
-*              - const uint8_t *m: pointer to message
-*              - size_t mlen: length of message
-*              - const uint8_t *ctx: pointer to context string
-*              - size_t ctxlen: length of context string
-*              - const uint8_t *pk: pointer to bit-packed public key
-*
-* Returns 0 if signature could be verified correctly and -1 otherwise
-**************************************************/
-int PQCLEAN_MLDSA44_CLEAN_crypto_sign_verify_ctx(const uint8_t *sig,
-        size_t siglen,
-        const uint8_t *m,
-        size_t mlen,
-        const uint8_t *ctx,
-        size_t ctxlen,
-        const uint8_t *pk) {
+static int verify_expanded(const uint8_t *sig,
+                           size_t siglen,
+                           const uint8_t *m,
+                           size_t mlen,
+                           const uint8_t *ctx,
+                           size_t ctxlen,
+                           const uint8_t tr[TRBYTES],
+                           const matrix mat,
+                           const polyveck *t1,
+                           check_workspace *ws) {
     unsigned int i;
     uint8_t buf[K * POLYW1_PACKEDBYTES];
-    uint8_t rho[SEEDBYTES];
     uint8_t mu[CRHBYTES];
     uint8_t c[CTILDEBYTES];
     uint8_t c2[CTILDEBYTES];
-    poly cp;
-    polyvecl mat[K], z;
-    polyveck t1, w1, h;
+    poly *cp = &ws->cp, *ct1 = &ws->ct1;
+    polyvecl *z = &ws->z;
+    polyveck *w1 = &ws->w1, *h = &ws->h;
     shake256incctx state;
 
     if (ctxlen > 255 || siglen != PQCLEAN_MLDSA44_CLEAN_CRYPTO_BYTES) {
         return -1;
     }
 
-    PQCLEAN_MLDSA44_CLEAN_unpack_pk(rho, &t1, pk);
-    if (PQCLEAN_MLDSA44_CLEAN_unpack_sig(c, &z, &h, sig)) {
+    if (PQCLEAN_MLDSA44_CLEAN_unpack_sig(c, z, h, sig)) {
         return -1;
     }
-    if (PQCLEAN_MLDSA44_CLEAN_polyvecl_chknorm(&z, GAMMA1 - BETA)) {
+    if (PQCLEAN_MLDSA44_CLEAN_polyvecl_chknorm(z, GAMMA1 - BETA)) {
         return -1;
     }
 
     /* Compute CRH(H(rho, t1), msg) */
-    shake256(mu, TRBYTES, pk, PQCLEAN_MLDSA44_CLEAN_CRYPTO_PUBLICKEYBYTES);
     shake256_inc_init(&state);
-    shake256_inc_absorb(&state, mu, TRBYTES);
+    shake256_inc_absorb(&state, tr, TRBYTES);
     mu[0] = 0;
     mu[1] = (uint8_t)ctxlen;
     shake256_inc_absorb(&state, mu, 2);
@@ -289,25 +420,24 @@ int PQCLEAN_MLDSA44_CLEAN_crypto_sign_verify_ctx(const uint8_t *sig,
     shake256_inc_ctx_release(&state);
 
     /* Matrix-vector multiplication; compute Az - c2^dt1 */
-    PQCLEAN_MLDSA44_CLEAN_poly_challenge(&cp, c);
-    PQCLEAN_MLDSA44_CLEAN_polyvec_matrix_expand(mat, rho);
+    PQCLEAN_MLDSA44_CLEAN_poly_challenge(cp, c);
 
-    PQCLEAN_MLDSA44_CLEAN_polyvecl_ntt(&z);
-    PQCLEAN_MLDSA44_CLEAN_polyvec_matrix_pointwise_montgomery(&w1, mat, &z);
+    PQCLEAN_MLDSA44_CLEAN_polyvecl_ntt(z);
+    matrix_pointwise_montgomery(w1, mat, z);
 
-    PQCLEAN_MLDSA44_CLEAN_poly_ntt(&cp);
-    PQCLEAN_MLDSA44_CLEAN_polyveck_shiftl(&t1);
-    PQCLEAN_MLDSA44_CLEAN_polyveck_ntt(&t1);
-    PQCLEAN_MLDSA44_CLEAN_polyveck_pointwise_poly_montgomery(&t1, &cp, &t1);
-
-    PQCLEAN_MLDSA44_CLEAN_polyveck_sub(&w1, &w1, &t1);
-    PQCLEAN_MLDSA44_CLEAN_polyveck_reduce(&w1);
-    PQCLEAN_MLDSA44_CLEAN_polyveck_invntt_tomont(&w1);
+    /* t1 is the caller's; multiply it by c one polynomial at a time */
+    PQCLEAN_MLDSA44_CLEAN_poly_ntt(cp);
+    for (i = 0; i < K; ++i) {
+        PQCLEAN_MLDSA44_CLEAN_poly_pointwise_montgomery(ct1, cp, &t1->vec[i]);
+        PQCLEAN_MLDSA44_CLEAN_poly_sub(&w1->vec[i], &w1->vec[i], ct1);
+    }
+    PQCLEAN_MLDSA44_CLEAN_polyveck_reduce(w1);
+    PQCLEAN_MLDSA44_CLEAN_polyveck_invntt_tomont(w1);
 
     /* Reconstruct w1 */
-    PQCLEAN_MLDSA44_CLEAN_polyveck_caddq(&w1);
-    PQCLEAN_MLDSA44_CLEAN_polyveck_use_hint(&w1, &w1, &h);
-    PQCLEAN_MLDSA44_CLEAN_polyveck_pack_w1(buf, &w1);
+    PQCLEAN_MLDSA44_CLEAN_polyveck_caddq(w1);
+    PQCLEAN_MLDSA44_CLEAN_polyveck_use_hint(w1, w1, h);
+    PQCLEAN_MLDSA44_CLEAN_polyveck_pack_w1(buf, w1);
 
     /* Call random oracle and verify challenge */
     shake256_inc_init(&state);
@@ -325,6 +455,51 @@ int PQCLEAN_MLDSA44_CLEAN_crypto_sign_verify_ctx(const uint8_t *sig,
     return 0;
 }
 
+static int verify_ctx_ws(const uint8_t *sig,
+                         size_t siglen,
+                         const uint8_t *m,
+                         size_t mlen,
+                         const uint8_t *ctx,
+                         size_t ctxlen,
+                         const uint8_t *pk,
+                         verify_workspace *ws) {
+    uint8_t tr[TRBYTES];
+
+    if (ctxlen > 255 || siglen != PQCLEAN_MLDSA44_CLEAN_CRYPTO_BYTES) {
+        return -1;
+    }
+
+    expand_pk(tr, ws->mat, &ws->t1, pk);
+    return verify_expanded(sig, siglen, m, mlen, ctx, ctxlen, tr, ws->mat, &ws->t1, &ws->chk);
+}
+
+/*************************************************
+* Name:        crypto_sign_verify
+*
+* Description: Verifies signature.
+*
+* Arguments:   - uint8_t *m: pointer to input signature
+*              - size_t siglen: length of signature
+*              - const uint8_t *m: pointer to message
+*              - size_t mlen: length of message
+*              - const uint8_t *ctx: pointer to context string
+*              - size_t ctxlen: length of context string
+*              - const uint8_t *pk: pointer to bit-packed public key
+*
+* Returns 0 if signature could be verified correctly and -1 otherwise
+**************************************************/
+int PQCLEAN_MLDSA44_CLEAN_crypto_sign_verify_ctx(const uint8_t *sig,
+        size_t siglen,
+        const uint8_t *m,
+        size_t mlen,
+        const uint8_t *ctx,
+        size_t ctxlen,
+        const uint8_t *pk) {
+    verify_workspace ws;
+
+    return verify_ctx_ws(sig, siglen, m, mlen, ctx, ctxlen, pk, &ws);
+}
+
 /*************************************************
 * Name:        crypto_sign_open
 *
@@ -405,3 +580,92 @@ int PQCLEAN_MLDSA44_CLEAN_crypto_sign_open(uint8_t *m,
         const uint8_t *pk) {
     return PQCLEAN_MLDSA44_CLEAN_crypto_sign_open_ctx(m, mlen, sm, smlen, NULL, 0, pk);
 }
+
+size_t PQCLEAN_MLDSA44_CLEAN_crypto_sign_keypair_wsbytes(void) {
+    return sizeof(keypair_workspace);
+}
+
+size_t PQCLEAN_MLDSA44_CLEAN_crypto_sign_signature_wsbytes(void) {
+    return sizeof(signature_workspace);
+}
+
+size_t PQCLEAN_MLDSA44_CLEAN_crypto_sign_verify_wsbytes(void) {
+    return sizeof(verify_workspace);
+}
+
+int PQCLEAN_MLDSA44_CLEAN_crypto_sign_keypair_ws(uint8_t *pk, uint8_t *sk, void *ws) {
+    return keypair_ws(pk, sk, (keypair_workspace *)ws);
+}
+
+int PQCLEAN_MLDSA44_CLEAN_crypto_sign_signature_ws(uint8_t *sig,
+        size_t *siglen,
+        const uint8_t *m,
+        size_t mlen,
+        const uint8_t *sk,
+        void *ws) {
+    return signature_ctx_ws(sig, siglen, m, mlen, NULL, 0, sk, (signature_workspace *)ws);
+}
+
+int PQCLEAN_MLDSA44_CLEAN_crypto_sign_verify_ws(const uint8_t *sig,
+        size_t siglen,
+        const uint8_t *m,
+        size_t mlen,
+        const uint8_t *pk,
+        void *ws) {
+    return verify_ctx_ws(sig, siglen, m, mlen, NULL, 0, pk, (verify_workspace *)ws);
+}
+
+size_t PQCLEAN_MLDSA44_CLEAN_crypto_sign_keyctxbytes(void) {
+    return sizeof(key_context);
+}
+
+int PQCLEAN_MLDSA44_CLEAN_crypto_sign_keyctx_init(void *key_ctx, const uint8_t *pk, const uint8_t *sk) {
+    key_context *kc = key_ctx;
+
+    kc->has_pk = pk != NULL;
+    if (pk) {
+        expand_pk(kc->esk.tr, kc->esk.mat, &kc->t1, pk);
+    }
+    kc->has_sk = sk != NULL;
+    if (sk) {
+        /* tr and A serve both keys, so sk has to hold the rho and tr of pk */
+        if (pk && (memcmp(sk, pk, SEEDBYTES) != 0
+                   || memcmp(sk + 2 * SEEDBYTES, kc->esk.tr, TRBYTES) != 0)) {
+            return -1;
+        }
+        expand_sk(&kc->esk, sk);
+    }
+    return 0;
+}
+
+void PQCLEAN_MLDSA44_CLEAN_crypto_sign_keyctx_release(void *key_ctx) {
+    (void)key_ctx;
+}
+
+int PQCLEAN_MLDSA44_CLEAN_crypto_sign_signature_keyctx(uint8_t *sig,
+        size_t *siglen,
+        const uint8_t *m,
+        size_t mlen,
+        const void *key_ctx) {
+    const key_context *kc = key_ctx;
+    rejection_workspace ws;
+
+    if (!kc->has_sk) {
+        return -1;
+    }
+    return signature_expanded(sig, siglen, m, mlen, NULL, 0, &kc->esk, &ws);
+}
+
+int PQCLEAN_MLDSA44_CLEAN_crypto_sign_verify_keyctx(const uint8_t *sig,
+        size_t siglen,
+        const uint8_t *m,
+        size_t mlen,
+        const void *key_ctx) {
+    const key_context *kc = key_ctx;
+    check_workspace ws;
+
+    if (!kc->has_pk) {
+        return -1;
+    }
+    return verify_expanded(sig, siglen, m, mlen, NULL, 0, kc->esk.tr, kc->esk.mat, &kc->t1, &ws);
+}
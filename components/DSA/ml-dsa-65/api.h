@@ -47,4 +47,54 @@ int PQCLEAN_MLDSA65_CLEAN_crypto_sign_open(uint8_t *m, size_t *mlen,
         const uint8_t *sm, size_t smlen,
         const uint8_t *pk);
 
+/*
+ * Variants of crypto_sign_keypair(), crypto_sign_signature() and
+ * crypto_sign_verify() that take the matrix and vector temporaries from
+ * the caller-provided buffer ws[] instead of the stack. ws[] must be
+ * aligned on 8 bytes and hold at least as many bytes as the matching
+ * *_wsbytes() function returns; its contents on entry and exit are
+ * unspecified.
+ */
+size_t PQCLEAN_MLDSA65_CLEAN_crypto_sign_keypair_wsbytes(void);
+
+size_t PQCLEAN_MLDSA65_CLEAN_crypto_sign_signature_wsbytes(void);
+
+size_t PQCLEAN_MLDSA65_CLEAN_crypto_sign_verify_wsbytes(void);
+
+int PQCLEAN_MLDSA65_CLEAN_crypto_sign_keypair_ws(uint8_t *pk, uint8_t *sk, void *ws);
+
+int PQCLEAN_MLDSA65_CLEAN_crypto_sign_signature_ws(uint8_t *sig, size_t *siglen,
+        const uint8_t *m, size_t mlen,
+        const uint8_t *sk, void *ws);
+
+int PQCLEAN_MLDSA65_CLEAN_crypto_sign_verify_ws(const uint8_t *sig, size_t siglen,
+        const uint8_t *m, size_t mlen,
+        const uint8_t *pk, void *ws);
+
+/*
+ * Key context: what signing and verification derive from the key alone
+ * (tr, the matrix A expanded from rho, s1, s2 and t0 in the NTT domain
+ * from sk, and NTT(t1 * 2^d) from pk), computed once by
+ * crypto_sign_keyctx_init() into key_ctx[] (of crypto_sign_keyctxbytes()
+ * bytes, aligned on 8) and reused by every crypto_sign_signature_keyctx()
+ * and crypto_sign_verify_keyctx() on that key. Either key may be NULL; the
+ * functions that need the missing one return -1. With both keys,
+ * crypto_sign_keyctx_init() returns -1 unless sk holds the rho and tr of
+ * pk. Results are the same as those of crypto_sign_signature() and
+ * crypto_sign_verify().
+ */
+size_t PQCLEAN_MLDSA65_CLEAN_crypto_sign_keyctxbytes(void);
+
+int PQCLEAN_MLDSA65_CLEAN_crypto_sign_keyctx_init(void *key_ctx, const uint8_t *pk, const uint8_t *sk);
+
+void PQCLEAN_MLDSA65_CLEAN_crypto_sign_keyctx_release(void *key_ctx);
+
+int PQCLEAN_MLDSA65_CLEAN_crypto_sign_signature_keyctx(uint8_t *sig, size_t *siglen,
+        const uint8_t *m, size_t mlen,
+        const void *key_ctx);
+
+int PQCLEAN_MLDSA65_CLEAN_crypto_sign_verify_keyctx(const uint8_t *sig, size_t siglen,
+        const uint8_t *m, size_t mlen,
+        const void *key_ctx);
+
 #endif
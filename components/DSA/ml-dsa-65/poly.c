@@ -1,3 +1,4 @@
+#include "cpu_features.h"
 #include "ntt.h"
 #include "params.h"
 #include "poly.h"
@@ -6,6 +7,13 @@
 #include "symmetric.h"
 #include <stdint.h>
 
+#ifdef CPU_FEATURES_X86
+/* Pointwise multiplication and uniform sampling with AVX2, chosen at run
+ * time; the NTT has its own in ntt.c */
+#define POLY_AVX2
+#include <immintrin.h>
+#endif
+
 #define DBENCH_START()
 #define DBENCH_STOP(t)
 
@@ -152,13 +160,51 @@ void PQCLEAN_MLDSA65_CLEAN_poly_invntt_tomont(poly *a) {
 *              - const poly *a: pointer to first input polynomial
 *              - const poly *b: pointer to second input polynomial
 **************************************************/
-void PQCLEAN_MLDSA65_CLEAN_poly_pointwise_montgomery(poly *c, const poly *a, const poly *b) {
+#ifdef POLY_AVX2
+/*
+ * montgomery_reduce() of eight products on 32-bit lanes: with t the low
+ * word of a*b*QINV, the low words of a*b and t*Q agree and the result is
+ * the difference of the high words.
+ */
+__attribute__((target("avx2")))
+static void pointwise_montgomery_avx2(poly *c, const poly *a, const poly *b) {
+    const __m256i q = _mm256_set1_epi32(Q);
+    const __m256i qinv = _mm256_set1_epi32(QINV);
+    __m256i x, y, t, pe, po, re, ro;
+    unsigned int i;
+
+    for (i = 0; i < N; i += 8) {
+        x = _mm256_loadu_si256((const __m256i *)&a->coeffs[i]);
+        y = _mm256_loadu_si256((const __m256i *)&b->coeffs[i]);
+        t = _mm256_mullo_epi32(x, _mm256_mullo_epi32(y, qinv));
+        pe = _mm256_mul_epi32(x, y);
+        po = _mm256_mul_epi32(_mm256_srli_epi64(x, 32), _mm256_srli_epi64(y, 32));
+        re = _mm256_sub_epi64(pe, _mm256_mul_epi32(t, q));
+        ro = _mm256_sub_epi64(po, _mm256_mul_epi32(_mm256_srli_epi64(t, 32), q));
+        _mm256_storeu_si256((__m256i *)&c->coeffs[i],
+                            _mm256_blend_epi32(_mm256_srli_epi64(re, 32), ro, 0xAA));
+    }
+}
+#endif
+
+static void pointwise_montgomery_portable(poly *c, const poly *a, const poly *b) {
     unsigned int i;
-    DBENCH_START();
 
     for (i = 0; i < N; ++i) {
         c->coeffs[i] = PQCLEAN_MLDSA65_CLEAN_montgomery_reduce((int64_t)a->coeffs[i] * b->coeffs[i]);
     }
+}
+
+void PQCLEAN_MLDSA65_CLEAN_poly_pointwise_montgomery(poly *c, const poly *a, const poly *b) {
+    DBENCH_START();
+
+#ifdef POLY_AVX2
+    if (cpu_has_avx2()) {
+        pointwise_montgomery_avx2(c, a, b);
+        return;
+    }
+#endif
+    pointwise_montgomery_portable(c, a, b);
 
     DBENCH_STOP(*tmul);
 }
@@ -294,6 +340,45 @@ int PQCLEAN_MLDSA65_CLEAN_poly_chknorm(const poly *a, int32_t B) {
     return 0;
 }
 
+#ifdef POLY_AVX2
+/*
+ * rej_uniform() on eight 3-byte candidates at a time, as long as 32 bytes
+ * can be loaded and eight coefficients stored. Accepted candidates are
+ * packed in order, so the result is that of the scalar loop.
+ */
+__attribute__((target("avx2")))
+static unsigned int rej_uniform_avx2(int32_t *a,
+                                     unsigned int len,
+                                     const uint8_t *buf,
+                                     unsigned int buflen,
+                                     unsigned int *pos) {
+    /* Bytes 12..27 go to the upper half, then each half spreads its
+       first 12 bytes over four 32-bit lanes */
+    const __m256i idx = _mm256_setr_epi32(0, 1, 2, 3, 3, 4, 5, 6);
+    const __m256i spread = _mm256_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+                                            0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const __m256i mask = _mm256_set1_epi32(0x7FFFFF);
+    const __m256i q = _mm256_set1_epi32(Q);
+    int32_t t[8];
+    unsigned int ctr = 0, i, good;
+    __m256i v;
+
+    while (ctr + 8 <= len && *pos + 32 <= buflen) {
+        v = _mm256_loadu_si256((const __m256i *)&buf[*pos]);
+        v = _mm256_permutevar8x32_epi32(v, idx);
+        v = _mm256_and_si256(_mm256_shuffle_epi8(v, spread), mask);
+        good = (unsigned int)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(q, v)));
+        _mm256_storeu_si256((__m256i *)t, v);
+        for (i = 0; i < 8; ++i) {
+            a[ctr] = t[i];
+            ctr += (good >> i) & 1;
+        }
+        *pos += 24;
+    }
+    return ctr;
+}
+#endif
+
 /*************************************************
 * Name:        rej_uniform
 *
@@ -317,6 +402,11 @@ static unsigned int rej_uniform(int32_t *a,
     DBENCH_START();
 
     ctr = pos = 0;
+#ifdef POLY_AVX2
+    if (cpu_has_avx2()) {
+        ctr = rej_uniform_avx2(a, len, buf, buflen, &pos);
+    }
+#endif
     while (ctr < len && pos + 3 <= buflen) {
         t  = buf[pos++];
         t |= (uint32_t)buf[pos++] << 8;
@@ -370,6 +460,71 @@ void PQCLEAN_MLDSA65_CLEAN_poly_uniform(poly *a,
     stream128_release(&state);
 }
 
+/*************************************************
+* Name:        PQCLEAN_MLDSA65_CLEAN_poly_uniform_4x
+*
+* Description: Four calls of poly_uniform with the same seed, sharing
+*              4-way SHAKE128 calls. Output is identical to the single
+*              version.
+*
+* Arguments:   - poly *a0, *a1, *a2, *a3: pointers to output polynomials
+*              - const uint8_t seed[]: byte array with seed of length SEEDBYTES
+*              - uint16_t nonce0, ..., nonce3: 2-byte nonces
+**************************************************/
+void PQCLEAN_MLDSA65_CLEAN_poly_uniform_4x(poly *a0,
+        poly *a1,
+        poly *a2,
+        poly *a3,
+        const uint8_t seed[SEEDBYTES],
+        uint16_t nonce0,
+        uint16_t nonce1,
+        uint16_t nonce2,
+        uint16_t nonce3) {
+    unsigned int i, j, off;
+    unsigned int ctr[4], buflen[4];
+    uint8_t in[4][SEEDBYTES + 2];
+    uint8_t buf[4][POLY_UNIFORM_NBLOCKS * STREAM128_BLOCKBYTES + 2];
+    poly *a[4] = {a0, a1, a2, a3};
+    uint16_t nonce[4] = {nonce0, nonce1, nonce2, nonce3};
+    keccakx4_state state;
+
+    for (j = 0; j < 4; ++j) {
+        for (i = 0; i < SEEDBYTES; ++i) {
+            in[j][i] = seed[i];
+        }
+        in[j][SEEDBYTES + 0] = (uint8_t) nonce[j];
+        in[j][SEEDBYTES + 1] = (uint8_t) (nonce[j] >> 8);
+    }
+
+    shake128x4_absorb_once(&state, in[0], in[1], in[2], in[3], SEEDBYTES + 2);
+    shake128x4_squeezeblocks(buf[0], buf[1], buf[2], buf[3], POLY_UNIFORM_NBLOCKS, &state);
+
+    for (j = 0; j < 4; ++j) {
+        buflen[j] = POLY_UNIFORM_NBLOCKS * STREAM128_BLOCKBYTES;
+        ctr[j] = rej_uniform(a[j]->coeffs, N, buf[j], buflen[j]);
+    }
+
+    while (ctr[0] < N || ctr[1] < N || ctr[2] < N || ctr[3] < N) {
+        for (j = 0; j < 4; ++j) {
+            off = buflen[j] % 3;
+            for (i = 0; i < off; ++i) {
+                buf[j][i] = buf[j][buflen[j] - off + i];
+            }
+            buflen[j] = STREAM128_BLOCKBYTES + off;
+        }
+        /* One more block for every lane; finished polys ignore theirs */
+        shake128x4_squeezeblocks(buf[0] + buflen[0] - STREAM128_BLOCKBYTES,
+                                 buf[1] + buflen[1] - STREAM128_BLOCKBYTES,
+                                 buf[2] + buflen[2] - STREAM128_BLOCKBYTES,
+                                 buf[3] + buflen[3] - STREAM128_BLOCKBYTES, 1, &state);
+        for (j = 0; j < 4; ++j) {
+            if (ctr[j] < N) {
+                ctr[j] += rej_uniform(a[j]->coeffs + ctr[j], N - ctr[j], buf[j], buflen[j]);
+            }
+        }
+    }
+}
+
 /*************************************************
 * Name:        rej_eta
 *
@@ -1,8 +1,19 @@
+#include "cpu_features.h"
 #include "ntt.h"
 #include "params.h"
 #include "reduce.h"
 #include <stdint.h>
 
+#if defined(__XTENSA__)
+#include <xtensa/config/core-isa.h>
+#endif
+
+#ifdef CPU_FEATURES_X86
+/* NTT and inverse NTT with AVX2, chosen at run time */
+#define NTT_AVX2
+#include <immintrin.h>
+#endif
+
 static const int32_t zetas[N] = {
     0,    25847, -2608894, -518909,   237124, -777960, -876248,   466468,
     1826347,  2353451, -359251, -2091905,  3119733, -2884855,  3111497,  2680103,
@@ -38,28 +49,329 @@ static const int32_t zetas[N] = {
     -554416,  3919660, -48306, -1362209,  3937738,  1400424, -846154,  1976782
 };
 
+/*
+ * Montgomery multiplication by a twiddle factor on 32-bit words. The low
+ * words of a*zeta and t*Q agree when t = a*zeta*QINV mod 2^32, so
+ * (a*zeta - t*Q) >> 32 is the difference of the two high words; with
+ * zeta*QINV computed once per block this takes one low and two high
+ * 32x32 multiplications and gives montgomery_reduce((int64_t)a * zeta)
+ * exactly. On Xtensa cores with MUL32_HIGH these are mull and mulsh.
+ */
+static int32_t mulhi(int32_t a, int32_t b) {
+#if defined(__XTENSA__) && XCHAL_HAVE_MUL32_HIGH
+    int32_t r;
+
+    __asm__("mulsh %0, %1, %2" : "=a"(r) : "a"(a), "a"(b));
+    return r;
+#else
+    return (int32_t)(((int64_t)a * b) >> 32);
+#endif
+}
+
+static int32_t mullo(int32_t a, int32_t b) {
+    return (int32_t)((uint32_t)a * (uint32_t)b);
+}
+
+static int32_t zeta_qinv(int32_t zeta) {
+    return mullo(zeta, QINV);
+}
+
+static int32_t fqmul(int32_t a, int32_t zeta, int32_t zq) {
+    return mulhi(a, zeta) - mulhi(mullo(a, zq), Q);
+}
+
+#ifdef NTT_AVX2
+/* fqmul() on eight coefficients; zeta and zq may differ from lane to lane */
+__attribute__((target("avx2")))
+static __m256i fqmul_avx2(__m256i a, __m256i zeta, __m256i zq) {
+    const __m256i q = _mm256_set1_epi32(Q);
+    __m256i t, pe, po, re, ro;
+
+    /* Even lanes in the low words of the 64-bit products, odd lanes in
+       the high words */
+    t = _mm256_mullo_epi32(a, zq);
+    pe = _mm256_mul_epi32(a, zeta);
+    po = _mm256_mul_epi32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(zeta, 32));
+    re = _mm256_sub_epi64(pe, _mm256_mul_epi32(t, q));
+    ro = _mm256_sub_epi64(po, _mm256_mul_epi32(_mm256_srli_epi64(t, 32), q));
+    return _mm256_blend_epi32(_mm256_srli_epi64(re, 32), ro, 0xAA);
+}
+
+__attribute__((target("avx2")))
+static __m256i zeta_qinv_avx2(__m256i zeta) {
+    return _mm256_mullo_epi32(zeta, _mm256_set1_epi32(QINV));
+}
+
+/*
+ * The last three layers of the forward NTT (first three of the inverse)
+ * work on 16 coefficients x, y at a time. split_len*() gather the first
+ * coefficient of each butterfly in u and the second in v, and join_len*()
+ * undo that. The twiddles of a lane follow from the gather: with len 4, u
+ * holds blocks 0 and 1 of the 16 coefficients; with len 2, blocks 0, 2, 1,
+ * 3 in pairs of lanes; with len 1, blocks 0, 4, 1, 5, 2, 6, 3, 7.
+ */
+#define split_len4(u, v, x, y) \
+    ((u) = _mm256_permute2x128_si256(x, y, 0x20), (v) = _mm256_permute2x128_si256(x, y, 0x31))
+#define join_len4(x, y, u, v) split_len4(x, y, u, v)
+#define split_len2(u, v, x, y) \
+    ((u) = _mm256_unpacklo_epi64(x, y), (v) = _mm256_unpackhi_epi64(x, y))
+#define join_len2(x, y, u, v) split_len2(x, y, u, v)
+#define split_len1(u, v, x, y) \
+    ((u) = _mm256_blend_epi32(x, _mm256_slli_epi64(y, 32), 0xAA), \
+     (v) = _mm256_blend_epi32(_mm256_srli_epi64(x, 32), y, 0xAA))
+#define join_len1(x, y, u, v) split_len1(x, y, u, v)
+
+/* z[i] is the twiddle of block i of the 16 coefficients */
+__attribute__((target("avx2")))
+static __m256i twiddles_len4(const int32_t z[2]) {
+    return _mm256_setr_epi32(z[0], z[0], z[0], z[0], z[1], z[1], z[1], z[1]);
+}
+
+__attribute__((target("avx2")))
+static __m256i twiddles_len2(const int32_t z[4]) {
+    return _mm256_setr_epi32(z[0], z[0], z[2], z[2], z[1], z[1], z[3], z[3]);
+}
+
+__attribute__((target("avx2")))
+static __m256i twiddles_len1(const int32_t z[8]) {
+    return _mm256_setr_epi32(z[0], z[4], z[1], z[5], z[2], z[6], z[3], z[7]);
+}
+
+/* Cooley-Tukey butterflies of the forward NTT */
+__attribute__((target("avx2")))
+static void ct_avx2(__m256i *u, __m256i *v, __m256i zeta) {
+    __m256i t = fqmul_avx2(*v, zeta, zeta_qinv_avx2(zeta));
+
+    *v = _mm256_sub_epi32(*u, t);
+    *u = _mm256_add_epi32(*u, t);
+}
+
+/* Gentleman-Sande butterflies of the inverse NTT */
+__attribute__((target("avx2")))
+static void gs_avx2(__m256i *u, __m256i *v, __m256i zeta) {
+    __m256i t = *u;
+
+    *u = _mm256_add_epi32(t, *v);
+    *v = fqmul_avx2(_mm256_sub_epi32(t, *v), zeta, zeta_qinv_avx2(zeta));
+}
+
+__attribute__((target("avx2")))
+static void ntt_avx2(int32_t a[N]) {
+    unsigned int len, start, j, k;
+    __m256i u, v, x, y, z;
+
+    k = 1;
+    for (len = 128; len >= 8; len >>= 1) {
+        for (start = 0; start < N; start += 2 * len) {
+            z = _mm256_set1_epi32(zetas[k++]);
+            for (j = start; j < start + len; j += 8) {
+                u = _mm256_loadu_si256((const __m256i *)&a[j]);
+                v = _mm256_loadu_si256((const __m256i *)&a[j + len]);
+                ct_avx2(&u, &v, z);
+                _mm256_storeu_si256((__m256i *)&a[j], u);
+                _mm256_storeu_si256((__m256i *)&a[j + len], v);
+            }
+        }
+    }
+
+    for (start = 0; start < N; start += 16) {
+        x = _mm256_loadu_si256((const __m256i *)&a[start]);
+        y = _mm256_loadu_si256((const __m256i *)&a[start + 8]);
+
+        split_len4(u, v, x, y);
+        ct_avx2(&u, &v, twiddles_len4(&zetas[32 + start / 8]));
+        join_len4(x, y, u, v);
+
+        split_len2(u, v, x, y);
+        ct_avx2(&u, &v, twiddles_len2(&zetas[64 + start / 4]));
+        join_len2(x, y, u, v);
+
+        split_len1(u, v, x, y);
+        ct_avx2(&u, &v, twiddles_len1(&zetas[128 + start / 2]));
+        join_len1(x, y, u, v);
+
+        _mm256_storeu_si256((__m256i *)&a[start], x);
+        _mm256_storeu_si256((__m256i *)&a[start + 8], y);
+    }
+}
+
+__attribute__((target("avx2")))
+static void invntt_avx2(int32_t a[N]) {
+    unsigned int len, start, i, j, k;
+    int32_t z[8];
+    __m256i u, v, x, y, zeta;
+    const __m256i f = _mm256_set1_epi32(41978); // mont^2/256
+
+    /* The inverse layers take the blocks' twiddles in decreasing order */
+    for (start = 0; start < N; start += 16) {
+        x = _mm256_loadu_si256((const __m256i *)&a[start]);
+        y = _mm256_loadu_si256((const __m256i *)&a[start + 8]);
+
+        for (i = 0; i < 8; ++i) {
+            z[i] = -zetas[255 - start / 2 - i];
+        }
+        split_len1(u, v, x, y);
+        gs_avx2(&u, &v, twiddles_len1(z));
+        join_len1(x, y, u, v);
+
+        for (i = 0; i < 4; ++i) {
+            z[i] = -zetas[127 - start / 4 - i];
+        }
+        split_len2(u, v, x, y);
+        gs_avx2(&u, &v, twiddles_len2(z));
+        join_len2(x, y, u, v);
+
+        for (i = 0; i < 2; ++i) {
+            z[i] = -zetas[63 - start / 8 - i];
+        }
+        split_len4(u, v, x, y);
+        gs_avx2(&u, &v, twiddles_len4(z));
+        join_len4(x, y, u, v);
+
+        _mm256_storeu_si256((__m256i *)&a[start], x);
+        _mm256_storeu_si256((__m256i *)&a[start + 8], y);
+    }
+
+    k = 32;
+    for (len = 8; len < N; len <<= 1) {
+        for (start = 0; start < N; start += 2 * len) {
+            zeta = _mm256_set1_epi32(-zetas[--k]);
+            for (j = start; j < start + len; j += 8) {
+                u = _mm256_loadu_si256((const __m256i *)&a[j]);
+                v = _mm256_loadu_si256((const __m256i *)&a[j + len]);
+                gs_avx2(&u, &v, zeta);
+                if (len == N / 2) {
+                    u = fqmul_avx2(u, f, zeta_qinv_avx2(f));
+                    v = fqmul_avx2(v, f, zeta_qinv_avx2(f));
+                }
+                _mm256_storeu_si256((__m256i *)&a[j], u);
+                _mm256_storeu_si256((__m256i *)&a[j + len], v);
+            }
+        }
+    }
+}
+#endif
+
+/* The forward NTT without vector instructions */
+static void ntt_portable(int32_t a[N]) {
+    unsigned int len, start, j, k;
+    int32_t z1, z2, z3, q1, q2, q3;
+    int32_t a0, a1, a2, a3, t;
+
+    /* Layers len and len / 2; the blocks of layer len start at k */
+    k = 1;
+    for (len = 128; len > 1; len >>= 2) {
+        for (start = 0; start < N; start += 2 * len) {
+            z1 = zetas[k];
+            z2 = zetas[2 * k];
+            z3 = zetas[2 * k + 1];
+            q1 = zeta_qinv(z1);
+            q2 = zeta_qinv(z2);
+            q3 = zeta_qinv(z3);
+            k++;
+            for (j = start; j < start + len / 2; ++j) {
+                a0 = a[j];
+                a1 = a[j + len / 2];
+                a2 = a[j + len];
+                a3 = a[j + 3 * len / 2];
+
+                t = fqmul(a2, z1, q1);
+                a2 = a0 - t;
+                a0 = a0 + t;
+                t = fqmul(a3, z1, q1);
+                a3 = a1 - t;
+                a1 = a1 + t;
+
+                t = fqmul(a1, z2, q2);
+                a1 = a0 - t;
+                a0 = a0 + t;
+                t = fqmul(a3, z3, q3);
+                a3 = a2 - t;
+                a2 = a2 + t;
+
+                a[j] = a0;
+                a[j + len / 2] = a1;
+                a[j + len] = a2;
+                a[j + 3 * len / 2] = a3;
+            }
+        }
+        k *= 2;
+    }
+}
+
 /*************************************************
 * Name:        PQCLEAN_MLDSA87_CLEAN_ntt
 *
 * Description: Forward NTT, in-place. No modular reduction is performed after
 *              additions or subtractions. Output vector is in bitreversed order.
+*              Layers are done two at a time, so each quadruple of
+*              coefficients is loaded and stored once per pair of layers.
 *
 * Arguments:   - uint32_t p[N]: input/output coefficient array
 **************************************************/
 void PQCLEAN_MLDSA87_CLEAN_ntt(int32_t a[N]) {
-    unsigned int len, start, j, k;
-    int32_t zeta, t;
+#ifdef NTT_AVX2
+    if (cpu_has_avx2()) {
+        ntt_avx2(a);
+        return;
+    }
+#endif
+    ntt_portable(a);
+}
 
-    k = 0;
-    for (len = 128; len > 0; len >>= 1) {
-        for (start = 0; start < N; start = j + len) {
-            zeta = zetas[++k];
+/* The inverse NTT without vector instructions */
+static void invntt_portable(int32_t a[N]) {
+    unsigned int start, len, j, k;
+    int32_t z1, z2, z3, q1, q2, q3;
+    int32_t a0, a1, a2, a3, t;
+    const int32_t f = 41978; // mont^2/256
+    const int32_t fq = zeta_qinv(f);
+
+    /* Layers len and 2 * len; the blocks of layer len end below k */
+    k = 256;
+    for (len = 1; len < N; len <<= 2) {
+        for (start = 0; start < N; start += 4 * len) {
+            z1 = -zetas[k - 1];
+            z2 = -zetas[k - 2];
+            z3 = -zetas[k / 2 - 1];
+            q1 = zeta_qinv(z1);
+            q2 = zeta_qinv(z2);
+            q3 = zeta_qinv(z3);
+            k -= 2;
             for (j = start; j < start + len; ++j) {
-                t = PQCLEAN_MLDSA87_CLEAN_montgomery_reduce((int64_t)zeta * a[j + len]);
-                a[j + len] = a[j] - t;
-                a[j] = a[j] + t;
+                a0 = a[j];
+                a1 = a[j + len];
+                a2 = a[j + 2 * len];
+                a3 = a[j + 3 * len];
+
+                t = a0;
+                a0 = t + a1;
+                a1 = fqmul(t - a1, z1, q1);
+                t = a2;
+                a2 = t + a3;
+                a3 = fqmul(t - a3, z2, q2);
+
+                t = a0;
+                a0 = t + a2;
+                a2 = fqmul(t - a2, z3, q3);
+                t = a1;
+                a1 = t + a3;
+                a3 = fqmul(t - a3, z3, q3);
+
+                if (len == N / 4) {
+                    a0 = fqmul(a0, f, fq);
+                    a1 = fqmul(a1, f, fq);
+                    a2 = fqmul(a2, f, fq);
+                    a3 = fqmul(a3, f, fq);
+                }
+
+                a[j] = a0;
+                a[j + len] = a1;
+                a[j + 2 * len] = a2;
+                a[j + 3 * len] = a3;
             }
         }
+        k /= 2;
     }
 }
 
@@ -70,29 +382,17 @@ void PQCLEAN_MLDSA87_CLEAN_ntt(int32_t a[N]) {
 *              In-place. No modular reductions after additions or
 *              subtractions; input coefficients need to be smaller than
 *              Q in absolute value. Output coefficient are smaller than Q in
-*              absolute value.
+*              absolute value. Layers are done two at a time as in the
+*              forward NTT, and the last pair also applies the factor.
 *
 * Arguments:   - uint32_t p[N]: input/output coefficient array
 **************************************************/
 void PQCLEAN_MLDSA87_CLEAN_invntt_tomont(int32_t a[N]) {
-    unsigned int start, len, j, k;
-    int32_t t, zeta;
-    const int32_t f = 41978; // mont^2/256
-
-    k = 256;
-    for (len = 1; len < N; len <<= 1) {
-        for (start = 0; start < N; start = j + len) {
-            zeta = -zetas[--k];
-            for (j = start; j < start + len; ++j) {
-                t = a[j];
-                a[j] = t + a[j + len];
-                a[j + len] = t - a[j + len];
-                a[j + len] = PQCLEAN_MLDSA87_CLEAN_montgomery_reduce((int64_t)zeta * a[j + len]);
-            }
-        }
-    }
-
-    for (j = 0; j < N; ++j) {
-        a[j] = PQCLEAN_MLDSA87_CLEAN_montgomery_reduce((int64_t)f * a[j]);
+#ifdef NTT_AVX2
+    if (cpu_has_avx2()) {
+        invntt_avx2(a);
+        return;
     }
+#endif
+    invntt_portable(a);
 }
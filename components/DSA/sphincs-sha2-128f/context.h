@@ -11,8 +11,8 @@ typedef struct {
     uint8_t pub_seed[SPX_N];
     uint8_t sk_seed[SPX_N];
 
-    // sha256 state that absorbed pub_seed
-    sha256ctx state_seeded;
+    // sha256 midstate that absorbed pub_seed
+    uint32_t state_seeded[8];
 
 
 } spx_ctx;
@@ -18,16 +18,119 @@ void thash(unsigned char *out, const unsigned char *in, unsigned int inblocks,
            const spx_ctx *ctx, uint32_t addr[8]) {
 
     unsigned char outbuf[SPX_SHA256_OUTPUT_BYTES];
-    sha256ctx sha2_state;
-    PQCLEAN_VLA(uint8_t, buf, SPX_SHA256_ADDR_BYTES + (inblocks * SPX_N));
+    size_t inlen = SPX_SHA256_ADDR_BYTES + (inblocks * SPX_N);
 
-    /* Retrieve precomputed state containing pub_seed */
-    sha256_inc_ctx_clone(&sha2_state, &ctx->state_seeded);
+    /* Continue from the precomputed midstate containing pub_seed. WOTS
+       chain steps and tree nodes fit in one padded block, which is built
+       and padded in place. */
+    if (inlen < SPX_SHA256_BLOCK_BYTES - 8) {
+        unsigned char block[SPX_SHA256_BLOCK_BYTES];
 
-    memcpy(buf, addr, SPX_SHA256_ADDR_BYTES);
-    memcpy(buf + SPX_SHA256_ADDR_BYTES, in, inblocks * SPX_N);
+        memcpy(block, addr, SPX_SHA256_ADDR_BYTES);
+        memcpy(block + SPX_SHA256_ADDR_BYTES, in, inblocks * SPX_N);
 
-    sha256_inc_finalize(outbuf, &sha2_state, buf, SPX_SHA256_ADDR_BYTES + (inblocks * SPX_N));
+        sha256_midstate_finalize_block(outbuf, ctx->state_seeded, SPX_SHA256_BLOCK_BYTES,
+                                       block, inlen);
+    } else {
+        PQCLEAN_VLA(uint8_t, buf, inlen);
+
+        memcpy(buf, addr, SPX_SHA256_ADDR_BYTES);
+        memcpy(buf + SPX_SHA256_ADDR_BYTES, in, inblocks * SPX_N);
+
+        sha256_midstate_finalize(outbuf, ctx->state_seeded, SPX_SHA256_BLOCK_BYTES,
+                                 buf, inlen);
+    }
     memcpy(out, outbuf, SPX_N);
 }
 
+void thashx4(unsigned char *out0,
+             unsigned char *out1,
+             unsigned char *out2,
+             unsigned char *out3,
+             const unsigned char *in0,
+             const unsigned char *in1,
+             const unsigned char *in2,
+             const unsigned char *in3, unsigned int inblocks,
+             const spx_ctx *ctx, uint32_t addrx4[4 * 8]) {
+    const unsigned char *in[4] = {in0, in1, in2, in3};
+    unsigned char *out[4] = {out0, out1, out2, out3};
+    unsigned char outbuf[4][SPX_SHA256_OUTPUT_BYTES];
+    unsigned char *outx4[4];
+    const unsigned char *bufx4[4];
+    size_t inlen = SPX_SHA256_ADDR_BYTES + (inblocks * SPX_N);
+    PQCLEAN_VLA(uint8_t, buf, 4 * inlen);
+    unsigned int j;
+
+    for (j = 0; j < 4; j++) {
+        memcpy(buf + j * inlen, addrx4 + 8 * j, SPX_SHA256_ADDR_BYTES);
+        memcpy(buf + j * inlen + SPX_SHA256_ADDR_BYTES, in[j], inblocks * SPX_N);
+        bufx4[j] = buf + j * inlen;
+        outx4[j] = outbuf[j];
+    }
+
+    /* All four continue from the precomputed midstate containing pub_seed */
+    sha256x4_midstate_finalize(outx4, ctx->state_seeded, SPX_SHA256_BLOCK_BYTES,
+                               bufx4, inlen);
+
+    for (j = 0; j < 4; j++) {
+        memcpy(out[j], outbuf[j], SPX_N);
+    }
+}
+
+void thash_chain(unsigned char *out, const unsigned char *in,
+                 unsigned int start, unsigned int steps,
+                 const spx_ctx *ctx, const uint32_t addr[8]) {
+    unsigned char block[SPX_SHA256_BLOCK_BYTES];
+    unsigned char *value = block + SPX_SHA256_ADDR_BYTES;
+    unsigned int i;
+
+    /* ADDR^c || value, padded once; each step hashes it from the midstate
+       containing pub_seed and writes the digest back over value */
+    memcpy(block, addr, SPX_SHA256_ADDR_BYTES);
+    memcpy(value, in, SPX_N);
+    sha256_midstate_pad_block(block, SPX_SHA256_ADDR_BYTES + SPX_N, SPX_SHA256_BLOCK_BYTES);
+
+    for (i = start; i < start + steps; i++) {
+        block[SPX_OFFSET_HASH_ADDR] = (unsigned char)i;
+        sha256_midstate_compress_block(value, SPX_N, ctx->state_seeded, block);
+    }
+    memcpy(out, value, SPX_N);
+}
+
+void thashx4_chain(unsigned char *out0,
+                   unsigned char *out1,
+                   unsigned char *out2,
+                   unsigned char *out3,
+                   const unsigned char *in0,
+                   const unsigned char *in1,
+                   const unsigned char *in2,
+                   const unsigned char *in3,
+                   unsigned int start, unsigned int steps,
+                   const spx_ctx *ctx, const uint32_t addrx4[4 * 8]) {
+    const unsigned char *in[4] = {in0, in1, in2, in3};
+    unsigned char *out[4] = {out0, out1, out2, out3};
+    unsigned char block[4][SPX_SHA256_BLOCK_BYTES];
+    unsigned char *valuex4[4];
+    const unsigned char *blockx4[4];
+    unsigned int i, j;
+
+    for (j = 0; j < 4; j++) {
+        memcpy(block[j], addrx4 + 8 * j, SPX_SHA256_ADDR_BYTES);
+        memcpy(block[j] + SPX_SHA256_ADDR_BYTES, in[j], SPX_N);
+        sha256_midstate_pad_block(block[j], SPX_SHA256_ADDR_BYTES + SPX_N,
+                                  SPX_SHA256_BLOCK_BYTES);
+        valuex4[j] = block[j] + SPX_SHA256_ADDR_BYTES;
+        blockx4[j] = block[j];
+    }
+
+    for (i = start; i < start + steps; i++) {
+        for (j = 0; j < 4; j++) {
+            block[j][SPX_OFFSET_HASH_ADDR] = (unsigned char)i;
+        }
+        sha256x4_midstate_compress_block(valuex4, SPX_N, ctx->state_seeded, blockx4);
+    }
+
+    for (j = 0; j < 4; j++) {
+        memcpy(out[j], valuex4[j], SPX_N);
+    }
+}
@@ -1,6 +1,7 @@
 #ifndef SPX_FORS_H
 #define SPX_FORS_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include "context.h"
@@ -16,6 +17,39 @@ void fors_sign(unsigned char *sig, unsigned char *pk,
                const spx_ctx *ctx,
                const uint32_t fors_addr[8]);
 
+/* Size of the part of the signature that covers one FORS tree */
+#define SPX_FORS_TREE_BYTES ((SPX_FORS_HEIGHT + 1) * SPX_N)
+
+/**
+ * fors_sign(), handing the signature to sink() one tree at a time.
+ * Returns the first non-zero value sink() returns, 0 otherwise.
+ */
+#define fors_sign_stream SPX_NAMESPACE(fors_sign_stream)
+int fors_sign_stream(unsigned char *pk,
+                     const unsigned char *m,
+                     const spx_ctx *ctx,
+                     const uint32_t fors_addr[8],
+                     int (*sink)(void *arg, const uint8_t *data, size_t len),
+                     void *arg);
+
+/**
+ * Derives the root of FORS tree i from its part of the signature.
+ */
+#define fors_tree_root_from_sig SPX_NAMESPACE(fors_tree_root_from_sig)
+void fors_tree_root_from_sig(unsigned char *root,
+                             const unsigned char *tree_sig,
+                             const unsigned char *m, uint32_t i,
+                             const spx_ctx *ctx,
+                             const uint32_t fors_addr[8]);
+
+/**
+ * Derives the FORS public key from the roots of all its trees.
+ */
+#define fors_pk_from_roots SPX_NAMESPACE(fors_pk_from_roots)
+void fors_pk_from_roots(unsigned char *pk, const unsigned char *roots,
+                        const spx_ctx *ctx,
+                        const uint32_t fors_addr[8]);
+
 /**
  * Derives the FORS public key from a signature.
  * This can be used for verification by comparing to a known public key, or to
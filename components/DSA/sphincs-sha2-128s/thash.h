@@ -10,4 +10,40 @@
 void thash(unsigned char *out, const unsigned char *in, unsigned int inblocks,
            const spx_ctx *ctx, uint32_t addr[8]);
 
+/* Four independent thash calls: out_j = thash(in_j) with address
+ * addrx4[8 * j .. 8 * j + 7]. */
+#define thashx4 SPX_NAMESPACE(thashx4)
+void thashx4(unsigned char *out0,
+             unsigned char *out1,
+             unsigned char *out2,
+             unsigned char *out3,
+             const unsigned char *in0,
+             const unsigned char *in1,
+             const unsigned char *in2,
+             const unsigned char *in3, unsigned int inblocks,
+             const spx_ctx *ctx, uint32_t addrx4[4 * 8]);
+
+/* steps iterations of thash(out, out, 1, ctx, addr) on in, with hash
+ * addresses start, start + 1, ...: a WOTS chain from its start-th value.
+ * The hashed block stays in place across the steps, with only the hash
+ * address and the chaining value rewritten. addr is left unchanged. */
+#define thash_chain SPX_NAMESPACE(thash_chain)
+void thash_chain(unsigned char *out, const unsigned char *in,
+                 unsigned int start, unsigned int steps,
+                 const spx_ctx *ctx, const uint32_t addr[8]);
+
+/* Four thash_chain() calls with the same start and steps, on the addresses
+ * addrx4[8 * j .. 8 * j + 7]. */
+#define thashx4_chain SPX_NAMESPACE(thashx4_chain)
+void thashx4_chain(unsigned char *out0,
+                   unsigned char *out1,
+                   unsigned char *out2,
+                   unsigned char *out3,
+                   const unsigned char *in0,
+                   const unsigned char *in1,
+                   const unsigned char *in2,
+                   const unsigned char *in3,
+                   unsigned int start, unsigned int steps,
+                   const spx_ctx *ctx, const uint32_t addrx4[4 * 8]);
+
 #endif
@@ -0,0 +1,113 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "utilsx4.h"
+
+#include "address.h"
+#include "context.h"
+#include "params.h"
+#include "thash.h"
+#include "utils.h"
+
+/*
+ * Generate the entire Merkle tree, computing the authentication path for
+ * leaf_idx, and the resulting root node, four leaves at a time.
+ * Expects the layer and tree parts of each of the four tree_addrx4 entries to
+ * be set, as well as the tree type.
+ *
+ * The logical nodes are groups of four adjacent nodes of one level, so a
+ * tree of height tree_height is walked as one of height tree_height - 2; the
+ * last two levels then hold fewer than four real nodes, and left_adj tracks
+ * where the real ones start in current[].
+ */
+void treehashx4(unsigned char *root, unsigned char *auth_path,
+                const spx_ctx *ctx,
+                uint32_t leaf_idx, uint32_t idx_offset,
+                uint32_t tree_height,
+                void (*gen_leafx4)(
+                    unsigned char * /* Where to write the leaves */,
+                    const spx_ctx * /* ctx */,
+                    uint32_t idx, void *info),
+                uint32_t tree_addrx4[4 * 8],
+                void *info) {
+    /* This is where we keep the intermediate nodes */
+    PQCLEAN_VLA(uint8_t, stackx4, tree_height * 4 * SPX_N);
+    uint32_t left_adj = 0, prev_left_adj = 0;
+
+    uint32_t idx;
+    uint32_t max_idx = (uint32_t)((1 << (tree_height - 2)) - 1);
+    for (idx = 0;; idx++) {
+        unsigned char current[4 * SPX_N]; /* Current logical node */
+        gen_leafx4( current, ctx, 4 * idx + idx_offset,
+                    info );
+
+        /* Now combine the freshly generated right node with previously */
+        /* generated left ones */
+        uint32_t internal_idx_offset = idx_offset;
+        uint32_t internal_idx = idx;
+        uint32_t internal_leaf = leaf_idx;
+        uint32_t h;     /* The height we are in the Merkle tree */
+        for (h = 0;; h++, internal_idx >>= 1, internal_leaf >>= 1) {
+
+            /* Special processing if we're at the top of the tree */
+            if (h >= tree_height - 2) {
+                if (h == tree_height) {
+                    /* We hit the root; return it */
+                    memcpy( root, &current[3 * SPX_N], SPX_N );
+                    return;
+                }
+                /* The tree indexing logic is a bit off in this case */
+                /* Adjust it so that the left-most node of the part of */
+                /* the tree that we're processing has index 0 */
+                prev_left_adj = left_adj;
+                left_adj = (uint32_t)(4 - (1 << (tree_height - h - 1)));
+            }
+
+            /*
+             * Check if one of the nodes we have is a part of the
+             * authentication path; if it is, write it out
+             */
+            if ((((internal_idx << 2) ^ internal_leaf) & ~0x3U) == 0) {
+                memcpy( &auth_path[ h * SPX_N ],
+                        &current[(((internal_leaf & 3) ^ 1) + prev_left_adj) * SPX_N],
+                        SPX_N );
+            }
+
+            /*
+             * Check if we're at a left child; if so, stop going up the stack
+             * Exception: if we've reached the end of the tree, keep on going
+             * (so we combine the last 4 nodes into the one root node in two
+             * more iterations)
+             */
+            if ((internal_idx & 1) == 0 && idx < max_idx) {
+                break;
+            }
+
+            /* Ok, we're at a right node (or doing the top 3 levels) */
+            /* Now combine the left and right logical nodes together */
+
+            /* Set the address of the node we're creating. */
+            unsigned int j;
+            internal_idx_offset >>= 1;
+            for (j = 0; j < 4; j++) {
+                set_tree_height(tree_addrx4 + j * 8, h + 1);
+                set_tree_index(tree_addrx4 + j * 8,
+                               (4 / 2) * (internal_idx & ~1U) + j - left_adj + internal_idx_offset );
+            }
+            unsigned char *left = &stackx4[h * 4 * SPX_N];
+            thashx4( &current[0 * SPX_N],
+                     &current[1 * SPX_N],
+                     &current[2 * SPX_N],
+                     &current[3 * SPX_N],
+                     &left   [0 * SPX_N],
+                     &left   [2 * SPX_N],
+                     &current[0 * SPX_N],
+                     &current[2 * SPX_N],
+                     2, ctx, tree_addrx4);
+        }
+
+        /* We've hit a left child; save the current for when we get the */
+        /* corresponding right right */
+        memcpy( &stackx4[h * 4 * SPX_N], current, 4 * SPX_N);
+    }
+}
@@ -54,6 +54,21 @@ int PQCLEAN_SPHINCSSHA2192FSIMPLE_CLEAN_crypto_sign_signature(uint8_t *sig, size
         const uint8_t *m, size_t mlen,
         const uint8_t *sk);
 
+/*
+ * Signing cache: crypto_sign_cache_init() fills cache[] (of
+ * crypto_sign_cachebytes() bytes) once per key with the top hypertree layer,
+ * which depends on the key alone, and crypto_sign_signature_cached() reads
+ * it instead of rebuilding that layer for every signature. cache_init
+ * returns -1 if the layer does not match the public root in sk.
+ */
+size_t PQCLEAN_SPHINCSSHA2192FSIMPLE_CLEAN_crypto_sign_cachebytes(void);
+
+int PQCLEAN_SPHINCSSHA2192FSIMPLE_CLEAN_crypto_sign_cache_init(uint8_t *cache, const uint8_t *sk);
+
+int PQCLEAN_SPHINCSSHA2192FSIMPLE_CLEAN_crypto_sign_signature_cached(uint8_t *sig, size_t *siglen,
+        const uint8_t *m, size_t mlen,
+        const uint8_t *sk, const uint8_t *cache);
+
 /**
  * Verifies a detached signature and message under a given public key.
  */
@@ -61,6 +76,54 @@ int PQCLEAN_SPHINCSSHA2192FSIMPLE_CLEAN_crypto_sign_verify(const uint8_t *sig, s
         const uint8_t *m, size_t mlen,
         const uint8_t *pk);
 
+/*
+ * Key context: crypto_sign_keyctx_init() prepares in key_ctx[] (of
+ * crypto_sign_keyctxbytes() bytes, 8-byte aligned) the hash context that
+ * signing with sk, or verifying with pk if sk is NULL, starts with, so
+ * that the *_keyctx() variants need not set it up on every call. cache
+ * may be NULL, or a signing cache of the same sk. crypto_sign_keyctx_init()
+ * returns -1 if both keys are given and pk is not the one held in sk.
+ */
+size_t PQCLEAN_SPHINCSSHA2192FSIMPLE_CLEAN_crypto_sign_keyctxbytes(void);
+
+int PQCLEAN_SPHINCSSHA2192FSIMPLE_CLEAN_crypto_sign_keyctx_init(void *key_ctx, const uint8_t *pk, const uint8_t *sk);
+
+void PQCLEAN_SPHINCSSHA2192FSIMPLE_CLEAN_crypto_sign_keyctx_release(void *key_ctx);
+
+int PQCLEAN_SPHINCSSHA2192FSIMPLE_CLEAN_crypto_sign_signature_keyctx(uint8_t *sig, size_t *siglen,
+        const uint8_t *m, size_t mlen,
+        const uint8_t *sk, const void *key_ctx, const uint8_t *cache);
+
+int PQCLEAN_SPHINCSSHA2192FSIMPLE_CLEAN_crypto_sign_verify_keyctx(const uint8_t *sig, size_t siglen,
+        const uint8_t *m, size_t mlen,
+        const uint8_t *pk, const void *key_ctx);
+
+/*
+ * Streaming signature: the signature of crypto_sign_signature_keyctx(),
+ * handed to sink() in order as it is computed (R, each FORS tree, then each
+ * hypertree layer) instead of written out. key_ctx and cache may be NULL.
+ * Returns the first non-zero value sink() returns, which stops signing.
+ */
+int PQCLEAN_SPHINCSSHA2192FSIMPLE_CLEAN_crypto_sign_signature_stream(const uint8_t *m, size_t mlen,
+        const uint8_t *sk, const void *key_ctx, const uint8_t *cache,
+        int (*sink)(void *arg, const uint8_t *data, size_t len), void *arg);
+
+/*
+ * Incremental verification: init starts verifying a signature of m under pk
+ * in state[] (of crypto_sign_verify_statebytes() bytes, 8-byte aligned),
+ * update takes the signature in order in pieces of any size, keeping only
+ * the part that is still incomplete, and final returns 0 if it was valid.
+ * m must stay valid until final; key_ctx may be NULL.
+ */
+size_t PQCLEAN_SPHINCSSHA2192FSIMPLE_CLEAN_crypto_sign_verify_statebytes(void);
+
+void PQCLEAN_SPHINCSSHA2192FSIMPLE_CLEAN_crypto_sign_verify_init(void *state, const uint8_t *m, size_t mlen,
+        const uint8_t *pk, const void *key_ctx);
+
+int PQCLEAN_SPHINCSSHA2192FSIMPLE_CLEAN_crypto_sign_verify_update(void *state, const uint8_t *data, size_t len);
+
+int PQCLEAN_SPHINCSSHA2192FSIMPLE_CLEAN_crypto_sign_verify_final(void *state);
+
 /**
  * Returns an array containing the signature followed by the message.
  */
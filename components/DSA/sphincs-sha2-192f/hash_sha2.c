@@ -77,22 +77,47 @@ void mgf1_512(unsigned char *out, unsigned long outlen,
  */
 void prf_addr(unsigned char *out, const spx_ctx *ctx,
               const uint32_t addr[8]) {
-    sha256ctx sha2_state;
-    unsigned char buf[SPX_SHA256_ADDR_BYTES + SPX_N];
+    unsigned char block[SPX_SHA256_BLOCK_BYTES];
     unsigned char outbuf[SPX_SHA256_OUTPUT_BYTES];
 
-    /* Retrieve precomputed state containing pub_seed */
-    sha256_inc_ctx_clone(&sha2_state, &ctx->state_seeded);
+    /* Remainder: ADDR^c ‖ SK.seed, which fits in the single block left after
+       the precomputed midstate containing pub_seed */
+    memcpy(block, addr, SPX_SHA256_ADDR_BYTES);
+    memcpy(block + SPX_SHA256_ADDR_BYTES, ctx->sk_seed, SPX_N);
 
-    /* Remainder: ADDR^c ‖ SK.seed */
-    memcpy(buf, addr, SPX_SHA256_ADDR_BYTES);
-    memcpy(buf + SPX_SHA256_ADDR_BYTES, ctx->sk_seed, SPX_N);
-
-    sha256_inc_finalize(outbuf, &sha2_state, buf, SPX_SHA256_ADDR_BYTES + SPX_N);
+    sha256_midstate_finalize_block(outbuf, ctx->state_seeded, SPX_SHA256_BLOCK_BYTES,
+                                   block, SPX_SHA256_ADDR_BYTES + SPX_N);
 
     memcpy(out, outbuf, SPX_N);
 }
 
+void prf_addrx4(unsigned char *out0,
+                unsigned char *out1,
+                unsigned char *out2,
+                unsigned char *out3,
+                const spx_ctx *ctx, const uint32_t addrx4[4 * 8]) {
+    unsigned char buf[4][SPX_SHA256_ADDR_BYTES + SPX_N];
+    unsigned char outbuf[4][SPX_SHA256_OUTPUT_BYTES];
+    unsigned char *out[4] = {out0, out1, out2, out3};
+    unsigned char *outx4[4];
+    const unsigned char *bufx4[4];
+    unsigned int j;
+
+    for (j = 0; j < 4; j++) {
+        memcpy(buf[j], addrx4 + 8 * j, SPX_SHA256_ADDR_BYTES);
+        memcpy(buf[j] + SPX_SHA256_ADDR_BYTES, ctx->sk_seed, SPX_N);
+        bufx4[j] = buf[j];
+        outx4[j] = outbuf[j];
+    }
+
+    sha256x4_midstate_finalize(outx4, ctx->state_seeded, SPX_SHA256_BLOCK_BYTES,
+                               bufx4, SPX_SHA256_ADDR_BYTES + SPX_N);
+
+    for (j = 0; j < 4; j++) {
+        memcpy(out[j], outbuf[j], SPX_N);
+    }
+}
+
 /**
  * Computes the message-dependent randomness R, using a secret seed as a key
  * for HMAC, and an optional randomization value prefixed to the message.
@@ -61,6 +61,30 @@ int crypto_sign_keypair(uint8_t *pk, uint8_t *sk);
 int crypto_sign_signature(uint8_t *sig, size_t *siglen,
                           const uint8_t *m, size_t mlen, const uint8_t *sk);
 
+/*
+ * Returns the length of the signing cache, in bytes
+ */
+#define crypto_sign_cachebytes SPX_NAMESPACE(crypto_sign_cachebytes)
+size_t crypto_sign_cachebytes(void);
+
+/*
+ * Fills cache[] with the top-most subtree of sk, the part of every
+ * signature that depends on the key alone. Returns -1 if that subtree does
+ * not match the public root in sk.
+ */
+#define crypto_sign_cache_init SPX_NAMESPACE(crypto_sign_cache_init)
+int crypto_sign_cache_init(uint8_t *cache, const uint8_t *sk);
+
+/**
+ * Returns an array containing a detached signature, reading the top-most
+ * subtree out of a cache[] filled by crypto_sign_cache_init() for the same
+ * sk instead of rebuilding it. The signature is the same.
+ */
+#define crypto_sign_signature_cached SPX_NAMESPACE(crypto_sign_signature_cached)
+int crypto_sign_signature_cached(uint8_t *sig, size_t *siglen,
+                                 const uint8_t *m, size_t mlen, const uint8_t *sk,
+                                 const uint8_t *cache);
+
 /**
  * Verifies a detached signature and message under a given public key.
  */
@@ -68,6 +92,83 @@ int crypto_sign_signature(uint8_t *sig, size_t *siglen,
 int crypto_sign_verify(const uint8_t *sig, size_t siglen,
                        const uint8_t *m, size_t mlen, const uint8_t *pk);
 
+/*
+ * Returns the length of a key context, in bytes
+ */
+#define crypto_sign_keyctxbytes SPX_NAMESPACE(crypto_sign_keyctxbytes)
+size_t crypto_sign_keyctxbytes(void);
+
+/*
+ * Prepares in key_ctx[] (8-byte aligned) the hash context that every
+ * signature with sk, or every verification with pk if sk is NULL, starts
+ * with, so that crypto_sign_signature_keyctx() and
+ * crypto_sign_verify_keyctx() need not set it up again. Returns -1 if both
+ * keys are given and pk is not the public key held in sk.
+ */
+#define crypto_sign_keyctx_init SPX_NAMESPACE(crypto_sign_keyctx_init)
+int crypto_sign_keyctx_init(void *key_ctx, const uint8_t *pk, const uint8_t *sk);
+
+/*
+ * Releases what crypto_sign_keyctx_init() set up.
+ */
+#define crypto_sign_keyctx_release SPX_NAMESPACE(crypto_sign_keyctx_release)
+void crypto_sign_keyctx_release(void *key_ctx);
+
+/**
+ * crypto_sign_signature() with a key context prepared from sk and, unless
+ * cache is NULL, the signing cache of sk.
+ */
+#define crypto_sign_signature_keyctx SPX_NAMESPACE(crypto_sign_signature_keyctx)
+int crypto_sign_signature_keyctx(uint8_t *sig, size_t *siglen,
+                                 const uint8_t *m, size_t mlen, const uint8_t *sk,
+                                 const void *key_ctx, const uint8_t *cache);
+
+/**
+ * The signature of crypto_sign_signature_keyctx(), handed to sink() in
+ * order as it is computed instead of written out: R, each FORS tree, then
+ * each hypertree layer, so at most SPX_WOTS_BYTES + SPX_TREE_HEIGHT * SPX_N
+ * bytes at a time. key_ctx and cache may be NULL. Returns the first
+ * non-zero value sink() returns, which stops signing, 0 otherwise.
+ */
+#define crypto_sign_signature_stream SPX_NAMESPACE(crypto_sign_signature_stream)
+int crypto_sign_signature_stream(const uint8_t *m, size_t mlen, const uint8_t *sk,
+                                 const void *key_ctx, const uint8_t *cache,
+                                 int (*sink)(void *arg, const uint8_t *data, size_t len),
+                                 void *arg);
+
+/**
+ * crypto_sign_verify() with a key context prepared from pk or from the
+ * matching sk.
+ */
+#define crypto_sign_verify_keyctx SPX_NAMESPACE(crypto_sign_verify_keyctx)
+int crypto_sign_verify_keyctx(const uint8_t *sig, size_t siglen,
+                              const uint8_t *m, size_t mlen, const uint8_t *pk,
+                              const void *key_ctx);
+
+/*
+ * Incremental verification: crypto_sign_verify_init() starts verifying a
+ * signature of m under pk in state[] (of crypto_sign_verify_statebytes()
+ * bytes, 8-byte aligned), crypto_sign_verify_update() takes the signature
+ * in order, in pieces of any size, and crypto_sign_verify_final() returns
+ * the result. Only the part of the signature that is still incomplete is
+ * kept, at most SPX_WOTS_BYTES + SPX_TREE_HEIGHT * SPX_N bytes. m must stay
+ * valid until final; key_ctx may be NULL. update returns -1 once the
+ * signature is longer than SPX_BYTES, 0 otherwise; whether it is valid is
+ * only known at the end.
+ */
+#define crypto_sign_verify_statebytes SPX_NAMESPACE(crypto_sign_verify_statebytes)
+size_t crypto_sign_verify_statebytes(void);
+
+#define crypto_sign_verify_init SPX_NAMESPACE(crypto_sign_verify_init)
+void crypto_sign_verify_init(void *state, const uint8_t *m, size_t mlen,
+                             const uint8_t *pk, const void *key_ctx);
+
+#define crypto_sign_verify_update SPX_NAMESPACE(crypto_sign_verify_update)
+int crypto_sign_verify_update(void *state, const uint8_t *data, size_t len);
+
+#define crypto_sign_verify_final SPX_NAMESPACE(crypto_sign_verify_final)
+int crypto_sign_verify_final(void *state);
+
 /**
  * Returns an array containing the signature followed by the message.
  */
@@ -16,6 +16,13 @@ void wots_pk_from_sig(unsigned char *pk,
                       const unsigned char *sig, const unsigned char *msg,
                       const spx_ctx *ctx, uint32_t addr[8]);
 
+/**
+ * Signs an n-byte message with the WOTS key pair at addr.
+ */
+#define wots_sign SPX_NAMESPACE(wots_sign)
+void wots_sign(unsigned char *sig, const unsigned char *msg,
+               const spx_ctx *ctx, uint32_t addr[8]);
+
 /*
  * Compute the chain lengths needed for a given message hash
  */
@@ -22,10 +22,8 @@ static void seed_state(spx_ctx *ctx) {
     }
     /* block has been properly initialized for both SHA-256 and SHA-512 */
 
-    sha256_inc_init(&ctx->state_seeded);
-    sha256_inc_blocks(&ctx->state_seeded, block, 1);
-    sha512_inc_init(&ctx->state_seeded_512);
-    sha512_inc_blocks(&ctx->state_seeded_512, block, 1);
+    sha256_midstate_init(ctx->state_seeded, block, 1);
+    sha512_midstate_init(ctx->state_seeded_512, block, 1);
 }
 
 
@@ -34,8 +32,7 @@ void initialize_hash_function(spx_ctx *ctx) {
     seed_state(ctx);
 }
 
-/* Free the incremental hashing context for heap-based SHA2 APIs */
+/* The seeded midstates live in ctx itself, so there is nothing to free */
 void free_hash_function(spx_ctx *ctx) {
-    sha256_inc_ctx_release(&ctx->state_seeded);
-    sha512_inc_ctx_release(&ctx->state_seeded_512);
+    (void)ctx;
 }
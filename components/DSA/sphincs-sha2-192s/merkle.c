@@ -1,9 +1,11 @@
 #include <stdint.h>
+#include <string.h>
 
 #include "address.h"
 #include "context.h"
 #include "merkle.h"
 #include "params.h"
+#include "thash.h"
 #include "utilsx1.h"
 #include "wots.h"
 #include "wotsx1.h"
@@ -40,6 +42,35 @@ void merkle_sign(uint8_t *sig, unsigned char *root,
                tree_addr, &info);
 }
 
+/*
+ * The Merkle half of merkle_sign(): the authentication path for idx_leaf
+ * and the root of the tree, without the WOTS signature. That signature is
+ * the only part that depends on the message signed, so trees of different
+ * layers can be built in any order, and signed later with wots_sign().
+ */
+void merkle_gen_tree(unsigned char *auth_path, unsigned char *root,
+                     const spx_ctx *ctx,
+                     uint32_t wots_addr[8], uint32_t tree_addr[8],
+                     uint32_t idx_leaf) {
+    struct leaf_info_x1 info = { 0 };
+    uint32_t steps[ SPX_WOTS_LEN ] = { 0 };
+
+    info.wots_steps = steps;
+
+    set_type(&tree_addr[0], SPX_ADDR_TYPE_HASHTREE);
+    set_type(&info.pk_addr[0], SPX_ADDR_TYPE_WOTSPK);
+    copy_subtree_addr(&info.leaf_addr[0], wots_addr);
+    copy_subtree_addr(&info.pk_addr[0], wots_addr);
+
+    info.wots_sign_leaf = ~0U; /* No leaf is signed */
+
+    treehashx1(root, auth_path, ctx,
+               idx_leaf, 0,
+               SPX_TREE_HEIGHT,
+               wots_gen_leafx1,
+               tree_addr, &info);
+}
+
 /* Compute root node of the top-most subtree. */
 void merkle_gen_root(unsigned char *root, const spx_ctx *ctx) {
     /* We do not need the auth path in key generation, but it simplifies the
@@ -56,3 +87,62 @@ void merkle_gen_root(unsigned char *root, const spx_ctx *ctx) {
                 wots_addr, top_tree_addr,
                 ~0U /* ~0 means "don't bother generating an auth path */ );
 }
+
+/*
+ * Every node of the top-most subtree: the 2^h leaves, then the 2^(h-1)
+ * nodes of the level above, and so on up to the root. This is the tree
+ * merkle_gen_root() builds; keeping it saves rebuilding it for every
+ * signature.
+ */
+void merkle_gen_top_nodes(unsigned char *nodes, const spx_ctx *ctx) {
+    struct leaf_info_x1 info = { 0 };
+    uint32_t steps[ SPX_WOTS_LEN ] = { 0 };
+    uint32_t top_tree_addr[8] = {0};
+    uint32_t wots_addr[8] = {0};
+    unsigned char *level = nodes;
+    uint32_t width = 1U << SPX_TREE_HEIGHT;
+    uint32_t h, i;
+
+    info.wots_steps = steps;
+    info.wots_sign_leaf = ~0U; /* No leaf is signed */
+
+    set_layer_addr(top_tree_addr, SPX_D - 1);
+    set_layer_addr(wots_addr, SPX_D - 1);
+
+    set_type(&top_tree_addr[0], SPX_ADDR_TYPE_HASHTREE);
+    set_type(&info.pk_addr[0], SPX_ADDR_TYPE_WOTSPK);
+    copy_subtree_addr(&info.leaf_addr[0], wots_addr);
+    copy_subtree_addr(&info.pk_addr[0], wots_addr);
+
+    for (i = 0; i < width; i++) {
+        wots_gen_leafx1(nodes + (i * SPX_N), ctx, i, &info);
+    }
+
+    for (h = 0; h < SPX_TREE_HEIGHT; h++) {
+        set_tree_height(top_tree_addr, h + 1);
+        for (i = 0; i < width / 2; i++) {
+            set_tree_index(top_tree_addr, i);
+            thash(level + ((width + i) * SPX_N), level + (2 * i * SPX_N),
+                  2, ctx, top_tree_addr);
+        }
+        level += width * SPX_N;
+        width /= 2;
+    }
+}
+
+/*
+ * Reads the authentication path for idx_leaf and the root out of the nodes
+ * from merkle_gen_top_nodes().
+ */
+void merkle_top_path(unsigned char *auth_path, unsigned char *root,
+                     const unsigned char *nodes, uint32_t idx_leaf) {
+    uint32_t width = 1U << SPX_TREE_HEIGHT;
+    uint32_t h;
+
+    for (h = 0; h < SPX_TREE_HEIGHT; h++, idx_leaf >>= 1) {
+        memcpy(auth_path + (h * SPX_N), nodes + ((idx_leaf ^ 1) * SPX_N), SPX_N);
+        nodes += width * SPX_N;
+        width /= 2;
+    }
+    memcpy(root, nodes, SPX_N);
+}
@@ -5,6 +5,7 @@
 #include "context.h"
 
 #include "address.h"
+#include "hash.h"
 #include "params.h"
 #include "thash.h"
 #include "utils.h"
@@ -23,16 +24,13 @@
 static void gen_chain(unsigned char *out, const unsigned char *in,
                       unsigned int start, unsigned int steps,
                       const spx_ctx *ctx, uint32_t addr[8]) {
-    uint32_t i;
-
-    /* Initialize out with the value at position 'start'. */
-    memcpy(out, in, SPX_N);
-
-    /* Iterate 'steps' calls to the hash function. */
-    for (i = start; i < (start + steps) && i < SPX_WOTS_W; i++) {
-        set_hash_addr(addr, i);
-        thash(out, out, 1, ctx, addr);
+    /* Iterate 'steps' calls to the hash function, up to the end of the chain. */
+    if (start >= SPX_WOTS_W) {
+        steps = 0;
+    } else if (steps > SPX_WOTS_W - start) {
+        steps = SPX_WOTS_W - start;
     }
+    thash_chain(out, in, start, steps, ctx, addr);
 }
 
 /**
@@ -104,3 +102,29 @@ void wots_pk_from_sig(unsigned char *pk,
                   lengths[i], SPX_WOTS_W - 1 - lengths[i], ctx, addr);
     }
 }
+
+/**
+ * Signs an n-byte message with the WOTS key pair at addr, whose layer, tree,
+ * key pair and type (SPX_ADDR_TYPE_WOTS) must be set.
+ *
+ * merkle_sign() gets the same signature as a by-product of building the
+ * tree; this is for callers that build the tree before the message is known.
+ */
+void wots_sign(unsigned char *sig, const unsigned char *msg,
+               const spx_ctx *ctx, uint32_t addr[8]) {
+    uint32_t lengths[SPX_WOTS_LEN];
+    uint32_t i;
+
+    chain_lengths(lengths, msg);
+
+    for (i = 0; i < SPX_WOTS_LEN; i++) {
+        set_chain_addr(addr, i);
+        set_hash_addr(addr, 0);
+        set_type(addr, SPX_ADDR_TYPE_WOTSPRF);
+        prf_addr(sig + (i * SPX_N), ctx, addr);
+
+        set_type(addr, SPX_ADDR_TYPE_WOTS);
+        gen_chain(sig + (i * SPX_N), sig + (i * SPX_N),
+                  0, lengths[i], ctx, addr);
+    }
+}
@@ -11,11 +11,11 @@ typedef struct {
     uint8_t pub_seed[SPX_N];
     uint8_t sk_seed[SPX_N];
 
-    // sha256 state that absorbed pub_seed
-    sha256ctx state_seeded;
+    // sha256 midstate that absorbed pub_seed
+    uint32_t state_seeded[8];
 
-    // sha512 state that absorbed pub_seed
-    sha512ctx state_seeded_512;
+    // sha512 midstate that absorbed pub_seed
+    uint64_t state_seeded_512[8];
 
 } spx_ctx;
 
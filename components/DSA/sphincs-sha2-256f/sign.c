@@ -4,6 +4,8 @@
 
 #include "address.h"
 #include "context.h"
+#include "dsa_config.h"
+#include "dsa_parallel.h"
 #include "fors.h"
 #include "hash.h"
 #include "merkle.h"
@@ -87,12 +89,77 @@ int crypto_sign_keypair(uint8_t *pk, uint8_t *sk) {
     return 0;
 }
 
-/**
- * Returns an array containing a detached signature.
+#ifdef CONFIG_DSA_SPHINCS_PARALLEL
+/*
+ * Signing work split between the two cores. Item 0 is the FORS signature and
+ * item 1 + i the Merkle tree of hypertree layer i; none depends on another,
+ * since a layer's tree does not depend on the root it signs. roots[0] is the
+ * FORS public key and roots[1 + i] the root of layer i. The WOTS signatures
+ * that link the layers are made once every root is known.
  */
-int crypto_sign_signature(uint8_t *sig, size_t *siglen,
-                          const uint8_t *m, size_t mlen, const uint8_t *sk) {
-    spx_ctx ctx;
+struct sign_work {
+    const spx_ctx *ctx;
+    const uint8_t *mhash;
+    uint8_t *sig;
+    uint64_t tree[SPX_D];
+    uint32_t idx_leaf[SPX_D];
+    uint8_t roots[SPX_D + 1][SPX_N];
+    const uint8_t *top_nodes;
+    uint32_t next;
+};
+
+static void sign_worker(void *arg) {
+    struct sign_work *work = arg;
+    uint32_t item;
+
+    while ((item = dsa_parallel_next(&work->next)) <= SPX_D) {
+        uint32_t wots_addr[8] = {0};
+        uint32_t tree_addr[8] = {0};
+
+        set_type(wots_addr, SPX_ADDR_TYPE_WOTS);
+        set_type(tree_addr, SPX_ADDR_TYPE_HASHTREE);
+
+        if (item == 0) {
+            set_tree_addr(wots_addr, work->tree[0]);
+            set_keypair_addr(wots_addr, work->idx_leaf[0]);
+
+            fors_sign(work->sig, work->roots[0], work->mhash, work->ctx, wots_addr);
+        } else {
+            uint32_t i = item - 1;
+            uint8_t *auth_path = work->sig + SPX_FORS_BYTES +
+                                 i * (SPX_WOTS_BYTES + SPX_TREE_HEIGHT * SPX_N) +
+                                 SPX_WOTS_BYTES;
+
+            if (i == SPX_D - 1 && work->top_nodes) {
+                merkle_top_path(auth_path, work->roots[item],
+                                work->top_nodes, work->idx_leaf[i]);
+                continue;
+            }
+
+            set_layer_addr(tree_addr, i);
+            set_tree_addr(tree_addr, work->tree[i]);
+
+            copy_subtree_addr(wots_addr, tree_addr);
+            set_keypair_addr(wots_addr, work->idx_leaf[i]);
+
+            merkle_gen_tree(auth_path, work->roots[item], work->ctx,
+                            wots_addr, tree_addr, work->idx_leaf[i]);
+        }
+    }
+}
+#endif
+
+/*
+ * crypto_sign_signature(), with the hash context prepared by
+ * crypto_sign_keyctx_init() if key_ctx is not NULL, and reading the
+ * top-most subtree out of top_nodes (see merkle_gen_top_nodes()) instead of
+ * building it if top_nodes is not NULL.
+ */
+static int signature(uint8_t *sig, size_t *siglen,
+                     const uint8_t *m, size_t mlen, const uint8_t *sk,
+                     const spx_ctx *key_ctx, const uint8_t *top_nodes) {
+    spx_ctx local_ctx;
+    const spx_ctx *ctx = key_ctx;
 
     const uint8_t *sk_prf = sk + SPX_N;
     const uint8_t *pk = sk + (2 * SPX_N);
@@ -106,12 +173,15 @@ int crypto_sign_signature(uint8_t *sig, size_t *siglen,
     uint32_t wots_addr[8] = {0};
     uint32_t tree_addr[8] = {0};
 
-    memcpy(ctx.sk_seed, sk, SPX_N);
-    memcpy(ctx.pub_seed, pk, SPX_N);
+    if (!key_ctx) {
+        memcpy(local_ctx.sk_seed, sk, SPX_N);
+        memcpy(local_ctx.pub_seed, pk, SPX_N);
 
-    /* This hook allows the hash function instantiation to do whatever
-       preparation or computation it needs, based on the public seed. */
-    initialize_hash_function(&ctx);
+        /* This hook allows the hash function instantiation to do whatever
+           preparation or computation it needs, based on the public seed. */
+        initialize_hash_function(&local_ctx);
+        ctx = &local_ctx;
+    }
 
     set_type(wots_addr, SPX_ADDR_TYPE_WOTS);
     set_type(tree_addr, SPX_ADDR_TYPE_HASHTREE);
@@ -121,17 +191,51 @@ int crypto_sign_signature(uint8_t *sig, size_t *siglen,
        getting a large number of traces when the signer uses the same nodes. */
     randombytes(optrand, SPX_N);
     /* Compute the digest randomization value. */
-    gen_message_random(sig, sk_prf, optrand, m, mlen, &ctx);
+    gen_message_random(sig, sk_prf, optrand, m, mlen, ctx);
 
     /* Derive the message digest and leaf index from R, PK and M. */
-    hash_message(mhash, &tree, &idx_leaf, sig, pk, m, mlen, &ctx);
+    hash_message(mhash, &tree, &idx_leaf, sig, pk, m, mlen, ctx);
     sig += SPX_N;
 
+#ifdef CONFIG_DSA_SPHINCS_PARALLEL
+    struct sign_work work;
+
+    (void)root;
+    work.ctx = ctx;
+    work.mhash = mhash;
+    work.sig = sig;
+    work.top_nodes = top_nodes;
+    work.next = 0;
+    for (i = 0; i < SPX_D; i++) {
+        work.tree[i] = tree;
+        work.idx_leaf[i] = idx_leaf;
+
+        /* Update the indices for the next layer. */
+        idx_leaf = (tree & ((1 << SPX_TREE_HEIGHT) - 1));
+        tree = tree >> SPX_TREE_HEIGHT;
+    }
+
+    /* FORS and the Merkle trees of every layer, on both cores. */
+    dsa_parallel_run(sign_worker, &work);
+    sig += SPX_FORS_BYTES;
+
+    /* Each layer signs the root of the one below, the first the FORS pk. */
+    for (i = 0; i < SPX_D; i++) {
+        set_layer_addr(tree_addr, i);
+        set_tree_addr(tree_addr, work.tree[i]);
+
+        copy_subtree_addr(wots_addr, tree_addr);
+        set_keypair_addr(wots_addr, work.idx_leaf[i]);
+
+        wots_sign(sig, work.roots[i], ctx, wots_addr);
+        sig += SPX_WOTS_BYTES + SPX_TREE_HEIGHT * SPX_N;
+    }
+#else
     set_tree_addr(wots_addr, tree);
     set_keypair_addr(wots_addr, idx_leaf);
 
     /* Sign the message hash using FORS. */
-    fors_sign(sig, root, mhash, &ctx, wots_addr);
+    fors_sign(sig, root, mhash, ctx, wots_addr);
     sig += SPX_FORS_BYTES;
 
     for (i = 0; i < SPX_D; i++) {
@@ -141,15 +245,23 @@ int crypto_sign_signature(uint8_t *sig, size_t *siglen,
         copy_subtree_addr(wots_addr, tree_addr);
         set_keypair_addr(wots_addr, idx_leaf);
 
-        merkle_sign(sig, root, &ctx, wots_addr, tree_addr, idx_leaf);
+        if (i == SPX_D - 1 && top_nodes) {
+            wots_sign(sig, root, ctx, wots_addr);
+            merkle_top_path(sig + SPX_WOTS_BYTES, root, top_nodes, idx_leaf);
+        } else {
+            merkle_sign(sig, root, ctx, wots_addr, tree_addr, idx_leaf);
+        }
         sig += SPX_WOTS_BYTES + SPX_TREE_HEIGHT * SPX_N;
 
         /* Update the indices for the next layer. */
         idx_leaf = (tree & ((1 << SPX_TREE_HEIGHT) - 1));
         tree = tree >> SPX_TREE_HEIGHT;
     }
+#endif
 
-    free_hash_function(&ctx);
+    if (!key_ctx) {
+        free_hash_function(&local_ctx);
+    }
 
     *siglen = SPX_BYTES;
 
@@ -157,72 +269,219 @@ int crypto_sign_signature(uint8_t *sig, size_t *siglen,
 }
 
 /**
- * Verifies a detached signature and message under a given public key.
+ * Returns an array containing a detached signature.
  */
-int crypto_sign_verify(const uint8_t *sig, size_t siglen,
-                       const uint8_t *m, size_t mlen, const uint8_t *pk) {
+int crypto_sign_signature(uint8_t *sig, size_t *siglen,
+                          const uint8_t *m, size_t mlen, const uint8_t *sk) {
+    return signature(sig, siglen, m, mlen, sk, NULL, NULL);
+}
+
+/*
+ * Returns the length of the signing cache, in bytes
+ */
+size_t crypto_sign_cachebytes(void) {
+    return SPX_TOP_NODES_BYTES;
+}
+
+/*
+ * Fills the signing cache of sk: every node of the top-most subtree.
+ */
+int crypto_sign_cache_init(uint8_t *cache, const uint8_t *sk) {
     spx_ctx ctx;
-    const uint8_t *pub_root = pk + SPX_N;
+    int ret = 0;
+
+    memcpy(ctx.sk_seed, sk, SPX_N);
+    memcpy(ctx.pub_seed, sk + (2 * SPX_N), SPX_N);
+
+    initialize_hash_function(&ctx);
+
+    merkle_gen_top_nodes(cache, &ctx);
+
+    /* The root of that subtree is the public root; anything else means */
+    /* the secret key is damaged. */
+    if (memcmp(cache + SPX_TOP_NODES_BYTES - SPX_N, sk + (3 * SPX_N), SPX_N) != 0) {
+        ret = -1;
+    }
+
+    free_hash_function(&ctx);
+
+    return ret;
+}
+
+/**
+ * Returns an array containing a detached signature, using the signing cache
+ * of sk.
+ */
+int crypto_sign_signature_cached(uint8_t *sig, size_t *siglen,
+                                 const uint8_t *m, size_t mlen, const uint8_t *sk,
+                                 const uint8_t *cache) {
+    return signature(sig, siglen, m, mlen, sk, NULL, cache);
+}
+
+/**
+ * The signature of crypto_sign_signature_keyctx(), handed to sink() in
+ * order as it is computed instead of written out: R, each FORS tree, then
+ * each hypertree layer. key_ctx and cache may be NULL.
+ */
+int crypto_sign_signature_stream(const uint8_t *m, size_t mlen, const uint8_t *sk,
+                                 const void *key_ctx, const uint8_t *cache,
+                                 int (*sink)(void *arg, const uint8_t *data, size_t len),
+                                 void *arg) {
+    spx_ctx local_ctx;
+    const spx_ctx *ctx = key_ctx;
+
+    const uint8_t *sk_prf = sk + SPX_N;
+    const uint8_t *pk = sk + (2 * SPX_N);
+
+    uint8_t optrand[SPX_N];
     uint8_t mhash[SPX_FORS_MSG_BYTES];
-    uint8_t wots_pk[SPX_WOTS_BYTES];
     uint8_t root[SPX_N];
-    uint8_t leaf[SPX_N];
-    unsigned int i;
+    uint8_t layer_sig[SPX_WOTS_BYTES + SPX_TREE_HEIGHT * SPX_N];
+    uint32_t i;
     uint64_t tree;
     uint32_t idx_leaf;
     uint32_t wots_addr[8] = {0};
     uint32_t tree_addr[8] = {0};
+    int ret;
+
+    if (!key_ctx) {
+        memcpy(local_ctx.sk_seed, sk, SPX_N);
+        memcpy(local_ctx.pub_seed, pk, SPX_N);
+
+        initialize_hash_function(&local_ctx);
+        ctx = &local_ctx;
+    }
+
+    set_type(wots_addr, SPX_ADDR_TYPE_WOTS);
+    set_type(tree_addr, SPX_ADDR_TYPE_HASHTREE);
+
+    randombytes(optrand, SPX_N);
+    /* R goes out through layer_sig, which is free until the first layer. */
+    gen_message_random(layer_sig, sk_prf, optrand, m, mlen, ctx);
+    hash_message(mhash, &tree, &idx_leaf, layer_sig, pk, m, mlen, ctx);
+    ret = sink(arg, layer_sig, SPX_N);
+
+    if (ret == 0) {
+        set_tree_addr(wots_addr, tree);
+        set_keypair_addr(wots_addr, idx_leaf);
+
+        ret = fors_sign_stream(root, mhash, ctx, wots_addr, sink, arg);
+    }
+
+    for (i = 0; i < SPX_D && ret == 0; i++) {
+        set_layer_addr(tree_addr, i);
+        set_tree_addr(tree_addr, tree);
+
+        copy_subtree_addr(wots_addr, tree_addr);
+        set_keypair_addr(wots_addr, idx_leaf);
+
+        if (i == SPX_D - 1 && cache) {
+            wots_sign(layer_sig, root, ctx, wots_addr);
+            merkle_top_path(layer_sig + SPX_WOTS_BYTES, root, cache, idx_leaf);
+        } else {
+            merkle_sign(layer_sig, root, ctx, wots_addr, tree_addr, idx_leaf);
+        }
+        ret = sink(arg, layer_sig, sizeof(layer_sig));
+
+        /* Update the indices for the next layer. */
+        idx_leaf = (tree & ((1 << SPX_TREE_HEIGHT) - 1));
+        tree = tree >> SPX_TREE_HEIGHT;
+    }
+
+    if (!key_ctx) {
+        free_hash_function(&local_ctx);
+    }
+
+    return ret;
+}
+
+/*
+ * Derives the root of the subtree at the given layer and tree address from
+ * its part of the signature (the WOTS signature of the root below, root on
+ * entry, then the authentication path of idx_leaf).
+ */
+static void layer_root_from_sig(uint8_t *root, const uint8_t *layer_sig,
+                                const spx_ctx *ctx, uint32_t layer,
+                                uint64_t tree, uint32_t idx_leaf) {
+    uint8_t wots_pk[SPX_WOTS_BYTES];
+    uint8_t leaf[SPX_N];
+    uint32_t wots_addr[8] = {0};
+    uint32_t tree_addr[8] = {0};
     uint32_t wots_pk_addr[8] = {0};
 
+    set_type(wots_addr, SPX_ADDR_TYPE_WOTS);
+    set_type(tree_addr, SPX_ADDR_TYPE_HASHTREE);
+    set_type(wots_pk_addr, SPX_ADDR_TYPE_WOTSPK);
+
+    set_layer_addr(tree_addr, layer);
+    set_tree_addr(tree_addr, tree);
+
+    copy_subtree_addr(wots_addr, tree_addr);
+    set_keypair_addr(wots_addr, idx_leaf);
+
+    copy_keypair_addr(wots_pk_addr, wots_addr);
+
+    /* The WOTS public key is only correct if the signature was correct. */
+    wots_pk_from_sig(wots_pk, layer_sig, root, ctx, wots_addr);
+
+    /* Compute the leaf node using the WOTS public key. */
+    thash(leaf, wots_pk, SPX_WOTS_LEN, ctx, wots_pk_addr);
+
+    /* Compute the root node of this subtree. */
+    compute_root(root, leaf, idx_leaf, 0, layer_sig + SPX_WOTS_BYTES,
+                 SPX_TREE_HEIGHT, ctx, tree_addr);
+}
+
+/*
+ * crypto_sign_verify(), with the hash context prepared by
+ * crypto_sign_keyctx_init() if key_ctx is not NULL.
+ */
+static int verify(const uint8_t *sig, size_t siglen,
+                  const uint8_t *m, size_t mlen, const uint8_t *pk,
+                  const spx_ctx *key_ctx) {
+    spx_ctx local_ctx;
+    const spx_ctx *ctx = key_ctx;
+    const uint8_t *pub_root = pk + SPX_N;
+    uint8_t mhash[SPX_FORS_MSG_BYTES];
+    uint8_t root[SPX_N];
+    unsigned int i;
+    uint64_t tree;
+    uint32_t idx_leaf;
+    uint32_t wots_addr[8] = {0};
+
     if (siglen != SPX_BYTES) {
         return -1;
     }
 
-    memcpy(ctx.pub_seed, pk, SPX_N);
+    if (!key_ctx) {
+        memcpy(local_ctx.pub_seed, pk, SPX_N);
 
-    /* This hook allows the hash function instantiation to do whatever
-       preparation or computation it needs, based on the public seed. */
-    initialize_hash_function(&ctx);
+        /* This hook allows the hash function instantiation to do whatever
+           preparation or computation it needs, based on the public seed. */
+        initialize_hash_function(&local_ctx);
+        ctx = &local_ctx;
+    }
 
     set_type(wots_addr, SPX_ADDR_TYPE_WOTS);
-    set_type(tree_addr, SPX_ADDR_TYPE_HASHTREE);
-    set_type(wots_pk_addr, SPX_ADDR_TYPE_WOTSPK);
 
     /* Derive the message digest and leaf index from R || PK || M. */
     /* The additional SPX_N is a result of the hash domain separator. */
-    hash_message(mhash, &tree, &idx_leaf, sig, pk, m, mlen, &ctx);
+    hash_message(mhash, &tree, &idx_leaf, sig, pk, m, mlen, ctx);
     sig += SPX_N;
 
     /* Layer correctly defaults to 0, so no need to set_layer_addr */
     set_tree_addr(wots_addr, tree);
     set_keypair_addr(wots_addr, idx_leaf);
 
-    fors_pk_from_sig(root, sig, mhash, &ctx, wots_addr);
+    fors_pk_from_sig(root, sig, mhash, ctx, wots_addr);
     sig += SPX_FORS_BYTES;
 
     /* For each subtree.. */
     for (i = 0; i < SPX_D; i++) {
-        set_layer_addr(tree_addr, i);
-        set_tree_addr(tree_addr, tree);
-
-        copy_subtree_addr(wots_addr, tree_addr);
-        set_keypair_addr(wots_addr, idx_leaf);
-
-        copy_keypair_addr(wots_pk_addr, wots_addr);
-
-        /* The WOTS public key is only correct if the signature was correct. */
         /* Initially, root is the FORS pk, but on subsequent iterations it is
            the root of the subtree below the currently processed subtree. */
-        wots_pk_from_sig(wots_pk, sig, root, &ctx, wots_addr);
-        sig += SPX_WOTS_BYTES;
-
-        /* Compute the leaf node using the WOTS public key. */
-        thash(leaf, wots_pk, SPX_WOTS_LEN, &ctx, wots_pk_addr);
-
-        /* Compute the root node of this subtree. */
-        compute_root(root, leaf, idx_leaf, 0, sig, SPX_TREE_HEIGHT,
-                     &ctx, tree_addr);
-        sig += SPX_TREE_HEIGHT * SPX_N;
+        layer_root_from_sig(root, sig, ctx, i, tree, idx_leaf);
+        sig += SPX_WOTS_BYTES + SPX_TREE_HEIGHT * SPX_N;
 
         /* Update the indices for the next layer. */
         idx_leaf = (tree & ((1 << SPX_TREE_HEIGHT) - 1));
@@ -230,7 +489,9 @@ int crypto_sign_verify(const uint8_t *sig, size_t siglen,
     }
 
     // cleanup
-    free_hash_function(&ctx);
+    if (!key_ctx) {
+        free_hash_function(&local_ctx);
+    }
 
     /* Check if the root node equals the root node in the public key. */
     if (memcmp(root, pub_root, SPX_N) != 0) {
@@ -241,6 +502,212 @@ int crypto_sign_verify(const uint8_t *sig, size_t siglen,
 }
 
 
+/**
+ * Verifies a detached signature and message under a given public key.
+ */
+int crypto_sign_verify(const uint8_t *sig, size_t siglen,
+                       const uint8_t *m, size_t mlen, const uint8_t *pk) {
+    return verify(sig, siglen, m, mlen, pk, NULL);
+}
+
+/*
+ * Returns the length of a key context, in bytes
+ */
+size_t crypto_sign_keyctxbytes(void) {
+    return sizeof(spx_ctx);
+}
+
+/*
+ * Prepares the hash context of sk, or of pk alone if sk is NULL. With both,
+ * the context also serves verification with pk, so sk has to hold pk.
+ */
+int crypto_sign_keyctx_init(void *key_ctx, const uint8_t *pk, const uint8_t *sk) {
+    spx_ctx *ctx = key_ctx;
+
+    if (sk && pk && memcmp(sk + (2 * SPX_N), pk, SPX_PK_BYTES) != 0) {
+        return -1;
+    }
+    if (sk) {
+        memcpy(ctx->sk_seed, sk, SPX_N);
+        memcpy(ctx->pub_seed, sk + (2 * SPX_N), SPX_N);
+    } else {
+        memset(ctx->sk_seed, 0, SPX_N);
+        memcpy(ctx->pub_seed, pk, SPX_N);
+    }
+
+    initialize_hash_function(ctx);
+    return 0;
+}
+
+/*
+ * Releases what crypto_sign_keyctx_init() set up.
+ */
+void crypto_sign_keyctx_release(void *key_ctx) {
+    free_hash_function(key_ctx);
+}
+
+/**
+ * Returns an array containing a detached signature, with a key context
+ * prepared from sk and, unless it is NULL, the signing cache of sk.
+ */
+int crypto_sign_signature_keyctx(uint8_t *sig, size_t *siglen,
+                                 const uint8_t *m, size_t mlen, const uint8_t *sk,
+                                 const void *key_ctx, const uint8_t *cache) {
+    return signature(sig, siglen, m, mlen, sk, key_ctx, cache);
+}
+
+/**
+ * Verifies a detached signature and message, with a key context prepared
+ * from pk or from the matching sk.
+ */
+int crypto_sign_verify_keyctx(const uint8_t *sig, size_t siglen,
+                              const uint8_t *m, size_t mlen, const uint8_t *pk,
+                              const void *key_ctx) {
+    return verify(sig, siglen, m, mlen, pk, key_ctx);
+}
+
+/*
+ * Incremental verification. The signature arrives in pieces of any size and
+ * is taken apart in the order it was made: R (unit 0), the SPX_FORS_TREES
+ * FORS trees, then the SPX_D layers. buf gathers the unit being received;
+ * once complete it is folded into mhash, fors_roots or root and dropped.
+ */
+#define VERIFY_UNITS (1 + SPX_FORS_TREES + SPX_D)
+
+struct verify_state {
+    spx_ctx ctx;
+    int own_ctx;
+    int result;
+    const uint8_t *m;
+    size_t mlen;
+    uint8_t pk[SPX_PK_BYTES];
+    uint8_t mhash[SPX_FORS_MSG_BYTES];
+    uint8_t fors_roots[SPX_FORS_TREES * SPX_N];
+    uint8_t root[SPX_N];
+    uint64_t tree;
+    uint32_t idx_leaf;
+    uint32_t unit;
+    size_t fill;
+    uint8_t buf[SPX_WOTS_BYTES + SPX_TREE_HEIGHT * SPX_N];
+};
+
+static size_t verify_unit_bytes(uint32_t unit) {
+    if (unit == 0) {
+        return SPX_N;
+    }
+    if (unit <= SPX_FORS_TREES) {
+        return SPX_FORS_TREE_BYTES;
+    }
+    return SPX_WOTS_BYTES + SPX_TREE_HEIGHT * SPX_N;
+}
+
+static void verify_unit(struct verify_state *s) {
+    uint32_t fors_addr[8] = {0};
+
+    if (s->unit == 0) {
+        hash_message(s->mhash, &s->tree, &s->idx_leaf, s->buf, s->pk,
+                     s->m, s->mlen, &s->ctx);
+    } else if (s->unit <= SPX_FORS_TREES) {
+        set_tree_addr(fors_addr, s->tree);
+        set_keypair_addr(fors_addr, s->idx_leaf);
+
+        fors_tree_root_from_sig(s->fors_roots + ((s->unit - 1) * SPX_N), s->buf,
+                                s->mhash, s->unit - 1, &s->ctx, fors_addr);
+        if (s->unit == SPX_FORS_TREES) {
+            fors_pk_from_roots(s->root, s->fors_roots, &s->ctx, fors_addr);
+        }
+    } else {
+        layer_root_from_sig(s->root, s->buf, &s->ctx,
+                            s->unit - 1 - SPX_FORS_TREES, s->tree, s->idx_leaf);
+
+        /* Update the indices for the next layer. */
+        s->idx_leaf = (s->tree & ((1 << SPX_TREE_HEIGHT) - 1));
+        s->tree = s->tree >> SPX_TREE_HEIGHT;
+
+        if (s->unit == VERIFY_UNITS - 1 &&
+            memcmp(s->root, s->pk + SPX_N, SPX_N) != 0) {
+            s->result = -1;
+        }
+    }
+}
+
+/*
+ * Returns the length of an incremental verification state, in bytes
+ */
+size_t crypto_sign_verify_statebytes(void) {
+    return sizeof(struct verify_state);
+}
+
+/*
+ * Starts verifying a signature of m under pk.
+ */
+void crypto_sign_verify_init(void *state, const uint8_t *m, size_t mlen,
+                             const uint8_t *pk, const void *key_ctx) {
+    struct verify_state *s = state;
+
+    if (key_ctx) {
+        memcpy(&s->ctx, key_ctx, sizeof(spx_ctx));
+        s->own_ctx = 0;
+    } else {
+        memcpy(s->ctx.pub_seed, pk, SPX_N);
+        initialize_hash_function(&s->ctx);
+        s->own_ctx = 1;
+    }
+    s->result = 0;
+    s->m = m;
+    s->mlen = mlen;
+    memcpy(s->pk, pk, SPX_PK_BYTES);
+    s->unit = 0;
+    s->fill = 0;
+}
+
+/*
+ * Takes the next len bytes of the signature.
+ */
+int crypto_sign_verify_update(void *state, const uint8_t *data, size_t len) {
+    struct verify_state *s = state;
+
+    while (len > 0 && s->result == 0) {
+        size_t unit_bytes, n;
+
+        if (s->unit == VERIFY_UNITS) {
+            /* Longer than SPX_BYTES */
+            s->result = -1;
+            break;
+        }
+        unit_bytes = verify_unit_bytes(s->unit);
+        n = unit_bytes - s->fill;
+        if (n > len) {
+            n = len;
+        }
+        memcpy(s->buf + s->fill, data, n);
+        s->fill += n;
+        data += n;
+        len -= n;
+
+        if (s->fill == unit_bytes) {
+            verify_unit(s);
+            s->unit++;
+            s->fill = 0;
+        }
+    }
+
+    return s->result;
+}
+
+/*
+ * Returns 0 if exactly SPX_BYTES of a valid signature came in, -1 otherwise.
+ */
+int crypto_sign_verify_final(void *state) {
+    struct verify_state *s = state;
+
+    if (s->own_ctx) {
+        free_hash_function(&s->ctx);
+    }
+
+    return s->result == 0 && s->unit == VERIFY_UNITS ? 0 : -1;
+}
+
 /**
  * Returns an array containing the signature followed by the message.
  */
@@ -2,6 +2,7 @@
 #include <string.h>
 
 #include "context.h"
+#include "dsa_config.h"
 #include "wotsx1.h"
 
 #include "address.h"
@@ -20,7 +21,7 @@ void wots_gen_leafx1(unsigned char *dest,
     struct leaf_info_x1 *info = v_info;
     uint32_t *leaf_addr = info->leaf_addr;
     uint32_t *pk_addr = info->pk_addr;
-    unsigned int i, k;
+    unsigned int i;
     unsigned char pk_buffer[ SPX_WOTS_BYTES ];
     unsigned char *buffer;
     uint32_t wots_k_mask;
@@ -37,6 +38,63 @@ void wots_gen_leafx1(unsigned char *dest,
     set_keypair_addr( leaf_addr, leaf_idx );
     set_keypair_addr( pk_addr, leaf_idx );
 
+#ifdef CONFIG_DSA_HASH_X4
+    /* Walk four chains at a time with thashx4; lanes past the last chain */
+    /* run on scratch buffers and never match a signature step */
+    for (i = 0, buffer = pk_buffer; i < SPX_WOTS_LEN; i += 4, buffer += 4 * SPX_N) {
+        unsigned char scratch[4][SPX_N];
+        unsigned char *bufx4[4];
+        uint32_t addrx4[4 * 8];
+        uint32_t wots_kx4[4];
+        unsigned int j, k;
+
+        for (j = 0; j < 4; j++) {
+            uint32_t *addr = addrx4 + 8 * j;
+
+            if (i + j < SPX_WOTS_LEN) {
+                bufx4[j] = buffer + j * SPX_N;
+                wots_kx4[j] = info->wots_steps[i + j] | wots_k_mask;
+            } else {
+                bufx4[j] = scratch[j];
+                wots_kx4[j] = ~0U;
+            }
+
+            memcpy(addr, leaf_addr, 8 * sizeof(uint32_t));
+            set_chain_addr(addr, i + j);
+            set_hash_addr(addr, 0);
+            set_type(addr, SPX_ADDR_TYPE_WOTSPRF);
+        }
+
+        prf_addrx4(bufx4[0], bufx4[1], bufx4[2], bufx4[3], ctx, addrx4);
+
+        for (j = 0; j < 4; j++) {
+            set_type(addrx4 + 8 * j, SPX_ADDR_TYPE_WOTS);
+        }
+
+        /* Run the chains together up to the next step any of them signs */
+        for (k = 0;;) {
+            uint32_t next = SPX_WOTS_W - 1;
+
+            for (j = 0; j < 4; j++) {
+                if (k == wots_kx4[j]) {
+                    memcpy( info->wots_sig + ((i + j) * SPX_N), bufx4[j], SPX_N );
+                }
+                if (wots_kx4[j] > k && wots_kx4[j] < next) {
+                    next = wots_kx4[j];
+                }
+            }
+
+            if (k == SPX_WOTS_W - 1) {
+                break;
+            }
+
+            thashx4_chain(bufx4[0], bufx4[1], bufx4[2], bufx4[3],
+                          bufx4[0], bufx4[1], bufx4[2], bufx4[3],
+                          k, next - k, ctx, addrx4);
+            k = next;
+        }
+    }
+#else
     for (i = 0, buffer = pk_buffer; i < SPX_WOTS_LEN; i++, buffer += SPX_N) {
         uint32_t wots_k = info->wots_steps[i] | wots_k_mask; /* Set wots_k to */
         /* the step if we're generating a signature, ~0 if we're not */
@@ -50,26 +108,22 @@ void wots_gen_leafx1(unsigned char *dest,
 
         set_type(leaf_addr, SPX_ADDR_TYPE_WOTS);
 
-        /* Iterate down the WOTS chain */
-        for (k = 0;; k++) {
-            /* Check if this is the value that needs to be saved as a */
-            /* part of the WOTS signature */
-            if (k == wots_k) {
+        /* Iterate down the WOTS chain, stopping at the value that needs */
+        /* to be saved as a part of the WOTS signature */
+        if (wots_k < SPX_WOTS_W - 1) {
+            thash_chain(buffer, buffer, 0, wots_k, ctx, leaf_addr);
+            memcpy( info->wots_sig + (i * SPX_N), buffer, SPX_N );
+            thash_chain(buffer, buffer, wots_k, SPX_WOTS_W - 1 - wots_k, ctx, leaf_addr);
+        } else {
+            thash_chain(buffer, buffer, 0, SPX_WOTS_W - 1, ctx, leaf_addr);
+            if (wots_k == SPX_WOTS_W - 1) {
                 memcpy( info->wots_sig + (i * SPX_N), buffer, SPX_N );
             }
-
-            /* Check if we hit the top of the chain */
-            if (k == SPX_WOTS_W - 1) {
-                break;
-            }
-
-            /* Iterate one step on the chain */
-            set_hash_addr(leaf_addr, k);
-
-            thash(buffer, buffer, 1, ctx, leaf_addr);
         }
     }
 
+#endif
+
     /* Do the final thash to generate the public keys */
     thash(dest, pk_buffer, SPX_WOTS_LEN, ctx, pk_addr);
 }
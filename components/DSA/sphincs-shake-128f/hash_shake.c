@@ -22,6 +22,24 @@ void prf_addr(unsigned char *out, const spx_ctx *ctx,
     shake256(out, SPX_N, buf, (2 * SPX_N) + SPX_ADDR_BYTES);
 }
 
+void prf_addrx4(unsigned char *out0,
+                unsigned char *out1,
+                unsigned char *out2,
+                unsigned char *out3,
+                const spx_ctx *ctx, const uint32_t addrx4[4 * 8]) {
+    unsigned char buf[4][(2 * SPX_N) + SPX_ADDR_BYTES];
+    unsigned int j;
+
+    for (j = 0; j < 4; j++) {
+        memcpy(buf[j], ctx->pub_seed, SPX_N);
+        memcpy(buf[j] + SPX_N, addrx4 + 8 * j, SPX_ADDR_BYTES);
+        memcpy(buf[j] + SPX_N + SPX_ADDR_BYTES, ctx->sk_seed, SPX_N);
+    }
+
+    shake256x4(out0, out1, out2, out3, SPX_N,
+               buf[0], buf[1], buf[2], buf[3], (2 * SPX_N) + SPX_ADDR_BYTES);
+}
+
 /**
  * Computes the message-dependent randomness R, using a secret seed and an
  * optional randomization value as well as the message.
@@ -14,8 +14,28 @@ void merkle_sign(uint8_t *sig, unsigned char *root,
                  uint32_t wots_addr[8], uint32_t tree_addr[8],
                  uint32_t idx_leaf);
 
+/* Generate the Merkle authentication path and root, without the WOTS */
+/* signature (see wots_sign()) */
+#define merkle_gen_tree SPX_NAMESPACE(merkle_gen_tree)
+void merkle_gen_tree(unsigned char *auth_path, unsigned char *root,
+                     const spx_ctx *ctx,
+                     uint32_t wots_addr[8], uint32_t tree_addr[8],
+                     uint32_t idx_leaf);
+
 /* Compute the root node of the top-most subtree. */
 #define merkle_gen_root SPX_NAMESPACE(merkle_gen_root)
 void merkle_gen_root(unsigned char *root, const spx_ctx *ctx);
 
+/* Size of every node of the top-most subtree, for merkle_gen_top_nodes() */
+#define SPX_TOP_NODES_BYTES (((2U << SPX_TREE_HEIGHT) - 1) * SPX_N)
+
+/* Compute every node of the top-most subtree */
+#define merkle_gen_top_nodes SPX_NAMESPACE(merkle_gen_top_nodes)
+void merkle_gen_top_nodes(unsigned char *nodes, const spx_ctx *ctx);
+
+/* Read an authentication path and the root out of the top-most subtree */
+#define merkle_top_path SPX_NAMESPACE(merkle_top_path)
+void merkle_top_path(unsigned char *auth_path, unsigned char *root,
+                     const unsigned char *nodes, uint32_t idx_leaf);
+
 #endif /* MERKLE_H_ */
@@ -9,11 +9,38 @@
 
 #include "fips202.h"
 
-/**
- * Takes an array of inblocks concatenated arrays of SPX_N bytes.
+/*
+ * PK.seed || ADDR || in is hashed with one Keccak permutation whenever it
+ * fits in a SHAKE256 block with its padding, which is the case for WOTS
+ * chain steps, tree nodes and FORS leaves. SPX_N and SPX_ADDR_BYTES are
+ * multiples of 8, so each part starts on a lane and is written straight
+ * into the state, and the output is read straight out of it.
  */
-void thash(unsigned char *out, const unsigned char *in, unsigned int inblocks,
-           const spx_ctx *ctx, uint32_t addr[8]) {
+#define SPX_THASH_MAX_INBLOCKS ((SHAKE256_RATE - 1 - SPX_N - SPX_ADDR_BYTES) / SPX_N)
+#define SPX_THASH_IN_LANE ((SPX_N + SPX_ADDR_BYTES) / 8)
+
+/*
+ * Sets the state whose lane l is s[stride * l] to PK.seed || ADDR || in,
+ * padded for SHAKE256. inblocks is at most SPX_THASH_MAX_INBLOCKS.
+ */
+static void load_block(uint64_t *s, unsigned int stride, const spx_ctx *ctx,
+                       const uint32_t addr[8], const unsigned char *in,
+                       unsigned int inblocks) {
+    unsigned int l = SPX_THASH_IN_LANE + inblocks * SPX_N / 8;
+
+    keccakf1600_load_lanes(s, stride, ctx->pub_seed, SPX_N / 8);
+    keccakf1600_load_lanes(s + stride * (SPX_N / 8), stride,
+                           (const unsigned char *)addr, SPX_ADDR_BYTES / 8);
+    keccakf1600_load_lanes(s + stride * SPX_THASH_IN_LANE, stride, in, inblocks * SPX_N / 8);
+    s[stride * l++] = 0x1F;
+    for (; l < 25; l++) {
+        s[stride * l] = 0;
+    }
+    s[stride * ((SHAKE256_RATE - 1) / 8)] ^= (uint64_t)0x80 << 56;
+}
+
+static void thash_blocks(unsigned char *out, const unsigned char *in, unsigned int inblocks,
+                         const spx_ctx *ctx, uint32_t addr[8]) {
     PQCLEAN_VLA(uint8_t, buf, SPX_N + SPX_ADDR_BYTES + (inblocks * SPX_N));
 
     memcpy(buf, ctx->pub_seed, SPX_N);
@@ -22,3 +49,124 @@ void thash(unsigned char *out, const unsigned char *in, unsigned int inblocks,
 
     shake256(out, SPX_N, buf, SPX_N + SPX_ADDR_BYTES + (inblocks * SPX_N));
 }
+
+/**
+ * Takes an array of inblocks concatenated arrays of SPX_N bytes.
+ */
+void thash(unsigned char *out, const unsigned char *in, unsigned int inblocks,
+           const spx_ctx *ctx, uint32_t addr[8]) {
+    uint64_t s[25];
+
+    if (inblocks > SPX_THASH_MAX_INBLOCKS) {
+        thash_blocks(out, in, inblocks, ctx, addr);
+        return;
+    }
+
+    load_block(s, 1, ctx, addr, in, inblocks);
+    keccakf1600_permute(s);
+    keccakf1600_store_lanes(out, s, 1, SPX_N / 8);
+}
+
+void thashx4(unsigned char *out0,
+             unsigned char *out1,
+             unsigned char *out2,
+             unsigned char *out3,
+             const unsigned char *in0,
+             const unsigned char *in1,
+             const unsigned char *in2,
+             const unsigned char *in3, unsigned int inblocks,
+             const spx_ctx *ctx, uint32_t addrx4[4 * 8]) {
+    const unsigned char *in[4] = {in0, in1, in2, in3};
+    unsigned char *out[4] = {out0, out1, out2, out3};
+    keccakx4_state state;
+    unsigned int j;
+
+    if (inblocks > SPX_THASH_MAX_INBLOCKS) {
+        PQCLEAN_VLA(uint8_t, buf, 4 * (SPX_N + SPX_ADDR_BYTES + (inblocks * SPX_N)));
+        size_t buflen = SPX_N + SPX_ADDR_BYTES + (inblocks * SPX_N);
+
+        for (j = 0; j < 4; j++) {
+            memcpy(buf + j * buflen, ctx->pub_seed, SPX_N);
+            memcpy(buf + j * buflen + SPX_N, addrx4 + 8 * j, SPX_ADDR_BYTES);
+            memcpy(buf + j * buflen + SPX_N + SPX_ADDR_BYTES, in[j], inblocks * SPX_N);
+        }
+
+        shake256x4(out0, out1, out2, out3, SPX_N,
+                   buf, buf + buflen, buf + 2 * buflen, buf + 3 * buflen, buflen);
+        return;
+    }
+
+    /* Every input is loaded before any output is written, as an output may
+       alias the input of another lane */
+    for (j = 0; j < 4; j++) {
+        load_block(state.s + j, 4, ctx, addrx4 + 8 * j, in[j], inblocks);
+    }
+    keccakf1600x4_permute(&state);
+
+    for (j = 0; j < 4; j++) {
+        keccakf1600_store_lanes(out[j], state.s + j, 4, SPX_N / 8);
+    }
+}
+
+/* The lane and shift of the hash-address byte in PK.seed || ADDR || in */
+#define SPX_THASH_HASH_LANE ((SPX_N + SPX_OFFSET_HASH_ADDR) / 8)
+#define SPX_THASH_HASH_SHIFT (8 * ((SPX_N + SPX_OFFSET_HASH_ADDR) % 8))
+
+void thash_chain(unsigned char *out, const unsigned char *in,
+                 unsigned int start, unsigned int steps,
+                 const spx_ctx *ctx, const uint32_t addr[8]) {
+    uint64_t block[25];
+    uint64_t s[25];
+    unsigned int i, l;
+
+    /* The padded block stays in lanes; each step sets the hash address,
+       permutes a copy and moves the chaining value back into the block */
+    load_block(block, 1, ctx, addr, in, 1);
+    block[SPX_THASH_HASH_LANE] &= ~((uint64_t)0xFF << SPX_THASH_HASH_SHIFT);
+
+    for (i = start; i < start + steps; i++) {
+        memcpy(s, block, sizeof(s));
+        s[SPX_THASH_HASH_LANE] |= (uint64_t)i << SPX_THASH_HASH_SHIFT;
+        keccakf1600_permute(s);
+        for (l = 0; l < SPX_N / 8; l++) {
+            block[SPX_THASH_IN_LANE + l] = s[l];
+        }
+    }
+
+    keccakf1600_store_lanes(out, block + SPX_THASH_IN_LANE, 1, SPX_N / 8);
+}
+
+void thashx4_chain(unsigned char *out0,
+                   unsigned char *out1,
+                   unsigned char *out2,
+                   unsigned char *out3,
+                   const unsigned char *in0,
+                   const unsigned char *in1,
+                   const unsigned char *in2,
+                   const unsigned char *in3,
+                   unsigned int start, unsigned int steps,
+                   const spx_ctx *ctx, const uint32_t addrx4[4 * 8]) {
+    const unsigned char *in[4] = {in0, in1, in2, in3};
+    unsigned char *out[4] = {out0, out1, out2, out3};
+    keccakx4_state block;
+    keccakx4_state state;
+    unsigned int i, j;
+
+    for (j = 0; j < 4; j++) {
+        load_block(block.s + j, 4, ctx, addrx4 + 8 * j, in[j], 1);
+        block.s[4 * SPX_THASH_HASH_LANE + j] &= ~((uint64_t)0xFF << SPX_THASH_HASH_SHIFT);
+    }
+
+    for (i = start; i < start + steps; i++) {
+        memcpy(&state, &block, sizeof(state));
+        for (j = 0; j < 4; j++) {
+            state.s[4 * SPX_THASH_HASH_LANE + j] |= (uint64_t)i << SPX_THASH_HASH_SHIFT;
+        }
+        keccakf1600x4_permute(&state);
+        memcpy(block.s + 4 * SPX_THASH_IN_LANE, state.s, 4 * (SPX_N / 8) * sizeof(uint64_t));
+    }
+
+    for (j = 0; j < 4; j++) {
+        keccakf1600_store_lanes(out[j], block.s + 4 * SPX_THASH_IN_LANE + j, 4, SPX_N / 8);
+    }
+}
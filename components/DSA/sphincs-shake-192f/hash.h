@@ -11,6 +11,14 @@
 void prf_addr(unsigned char *out, const spx_ctx *ctx,
               const uint32_t addr[8]);
 
+/* Four independent prf_addr calls: out_j = prf_addr(addrx4[8 * j .. 8 * j + 7]) */
+#define prf_addrx4 SPX_NAMESPACE(prf_addrx4)
+void prf_addrx4(unsigned char *out0,
+                unsigned char *out1,
+                unsigned char *out2,
+                unsigned char *out3,
+                const spx_ctx *ctx, const uint32_t addrx4[4 * 8]);
+
 #define gen_message_random SPX_NAMESPACE(gen_message_random)
 void gen_message_random(unsigned char *R, const unsigned char *sk_prf,
                         const unsigned char *optrand,
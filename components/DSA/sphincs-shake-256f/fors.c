@@ -1,14 +1,17 @@
 #include <stdint.h>
+#include <string.h>
 
 #include "fors.h"
 
 #include "address.h"
 #include "context.h"
+#include "dsa_config.h"
 #include "hash.h"
 #include "params.h"
 #include "thash.h"
 #include "utils.h"
 #include "utilsx1.h"
+#include "utilsx4.h"
 
 static void fors_gen_sk(unsigned char *sk, const spx_ctx *ctx,
                         uint32_t fors_leaf_addr[8]) {
@@ -21,6 +24,45 @@ static void fors_sk_to_leaf(unsigned char *leaf, const unsigned char *sk,
     thash(leaf, sk, 1, ctx, fors_leaf_addr);
 }
 
+#ifdef CONFIG_DSA_HASH_X4
+struct fors_gen_leaf_info {
+    uint32_t leaf_addrx[4 * 8];
+};
+
+static void fors_gen_leafx4(unsigned char *leaf,
+                            const spx_ctx *ctx,
+                            uint32_t addr_idx, void *info) {
+    struct fors_gen_leaf_info *fors_info = info;
+    uint32_t *fors_leaf_addrx4 = fors_info->leaf_addrx;
+    unsigned int j;
+
+    /* Only set the parts that the caller doesn't set */
+    for (j = 0; j < 4; j++) {
+        set_tree_index(fors_leaf_addrx4 + j * 8, addr_idx + j);
+        set_type(fors_leaf_addrx4 + j * 8, SPX_ADDR_TYPE_FORSPRF);
+    }
+
+    prf_addrx4(leaf + 0 * SPX_N,
+               leaf + 1 * SPX_N,
+               leaf + 2 * SPX_N,
+               leaf + 3 * SPX_N,
+               ctx, fors_leaf_addrx4);
+
+    for (j = 0; j < 4; j++) {
+        set_type(fors_leaf_addrx4 + j * 8, SPX_ADDR_TYPE_FORSTREE);
+    }
+
+    thashx4(leaf + 0 * SPX_N,
+            leaf + 1 * SPX_N,
+            leaf + 2 * SPX_N,
+            leaf + 3 * SPX_N,
+            leaf + 0 * SPX_N,
+            leaf + 1 * SPX_N,
+            leaf + 2 * SPX_N,
+            leaf + 3 * SPX_N,
+            1, ctx, fors_leaf_addrx4);
+}
+#else
 struct fors_gen_leaf_info {
     uint32_t leaf_addrx[8];
 };
@@ -40,6 +82,7 @@ static void fors_gen_leafx1(unsigned char *leaf,
     fors_sk_to_leaf(leaf, leaf,
                     ctx, fors_leaf_addr);
 }
+#endif
 
 /**
  * Interprets m as SPX_FORS_HEIGHT-bit unsigned integers.
@@ -60,13 +103,15 @@ static void message_to_indices(uint32_t *indices, const unsigned char *m) {
 }
 
 /**
- * Signs a message m, deriving the secret key from sk_seed and the FTS address.
- * Assumes m contains at least SPX_FORS_HEIGHT * SPX_FORS_TREES bits.
+ * fors_sign(), or if sink is not NULL, fors_sign_stream() with sig as the
+ * buffer of one tree.
  */
-void fors_sign(unsigned char *sig, unsigned char *pk,
-               const unsigned char *m,
-               const spx_ctx *ctx,
-               const uint32_t fors_addr[8]) {
+static int fors_sign_trees(unsigned char *sig, unsigned char *pk,
+                           const unsigned char *m,
+                           const spx_ctx *ctx,
+                           const uint32_t fors_addr[8],
+                           int (*sink)(void *arg, const uint8_t *data, size_t len),
+                           void *arg) {
     uint32_t indices[SPX_FORS_TREES];
     unsigned char roots[SPX_FORS_TREES * SPX_N];
     uint32_t fors_tree_addr[8] = {0};
@@ -75,9 +120,19 @@ void fors_sign(unsigned char *sig, unsigned char *pk,
     uint32_t fors_pk_addr[8] = {0};
     uint32_t idx_offset;
     unsigned int i;
+    int ret;
+#ifdef CONFIG_DSA_HASH_X4
+    uint32_t fors_tree_addrx4[4 * 8];
+    unsigned int j;
 
-    copy_keypair_addr(fors_tree_addr, fors_addr);
+    for (j = 0; j < 4; j++) {
+        copy_keypair_addr(fors_leaf_addr + j * 8, fors_addr);
+    }
+#else
     copy_keypair_addr(fors_leaf_addr, fors_addr);
+#endif
+
+    copy_keypair_addr(fors_tree_addr, fors_addr);
 
     copy_keypair_addr(fors_pk_addr, fors_addr);
     set_type(fors_pk_addr, SPX_ADDR_TYPE_FORSPK);
@@ -85,6 +140,8 @@ void fors_sign(unsigned char *sig, unsigned char *pk,
     message_to_indices(indices, m);
 
     for (i = 0; i < SPX_FORS_TREES; i++) {
+        unsigned char *tree_sig = sig;
+
         idx_offset = i * (1 << SPX_FORS_HEIGHT);
 
         set_tree_height(fors_tree_addr, 0);
@@ -97,60 +154,132 @@ void fors_sign(unsigned char *sig, unsigned char *pk,
         sig += SPX_N;
 
         /* Compute the authentication path for this leaf node. */
+#ifdef CONFIG_DSA_HASH_X4
+        for (j = 0; j < 4; j++) {
+            memcpy(fors_tree_addrx4 + j * 8, fors_tree_addr, sizeof(fors_tree_addr));
+        }
+        treehashx4(roots + (i * SPX_N), sig, ctx,
+                   indices[i], idx_offset, SPX_FORS_HEIGHT, fors_gen_leafx4,
+                   fors_tree_addrx4, &fors_info);
+#else
         treehashx1(roots + (i * SPX_N), sig, ctx,
                    indices[i], idx_offset, SPX_FORS_HEIGHT, fors_gen_leafx1,
                    fors_tree_addr, &fors_info);
+#endif
 
         sig += SPX_N * SPX_FORS_HEIGHT;
+
+        if (sink) {
+            ret = sink(arg, tree_sig, SPX_FORS_TREE_BYTES);
+            if (ret != 0) {
+                return ret;
+            }
+            sig = tree_sig;
+        }
     }
 
     /* Hash horizontally across all tree roots to derive the public key. */
     thash(pk, roots, SPX_FORS_TREES, ctx, fors_pk_addr);
+    return 0;
 }
 
 /**
- * Derives the FORS public key from a signature.
- * This can be used for verification by comparing to a known public key, or to
- * subsequently verify a signature on the derived public key. The latter is the
- * typical use-case when used as an FTS below an OTS in a hypertree.
+ * Signs a message m, deriving the secret key from sk_seed and the FTS address.
  * Assumes m contains at least SPX_FORS_HEIGHT * SPX_FORS_TREES bits.
  */
-void fors_pk_from_sig(unsigned char *pk,
-                      const unsigned char *sig, const unsigned char *m,
-                      const spx_ctx *ctx,
-                      const uint32_t fors_addr[8]) {
-    uint32_t indices[SPX_FORS_TREES];
-    unsigned char roots[SPX_FORS_TREES * SPX_N];
+void fors_sign(unsigned char *sig, unsigned char *pk,
+               const unsigned char *m,
+               const spx_ctx *ctx,
+               const uint32_t fors_addr[8]) {
+    fors_sign_trees(sig, pk, m, ctx, fors_addr, NULL, NULL);
+}
+
+/**
+ * fors_sign(), handing the signature to sink() one tree (SPX_FORS_TREE_BYTES)
+ * at a time instead of writing it out. Returns the first non-zero value
+ * sink() returns, 0 otherwise.
+ */
+int fors_sign_stream(unsigned char *pk,
+                     const unsigned char *m,
+                     const spx_ctx *ctx,
+                     const uint32_t fors_addr[8],
+                     int (*sink)(void *arg, const uint8_t *data, size_t len),
+                     void *arg) {
+    unsigned char tree_sig[SPX_FORS_TREE_BYTES];
+
+    return fors_sign_trees(tree_sig, pk, m, ctx, fors_addr, sink, arg);
+}
+
+
+/**
+ * Derives the root of FORS tree i from its part of the signature
+ * (SPX_FORS_TREE_BYTES bytes), for the message m.
+ */
+void fors_tree_root_from_sig(unsigned char *root,
+                             const unsigned char *tree_sig,
+                             const unsigned char *m, uint32_t i,
+                             const spx_ctx *ctx,
+                             const uint32_t fors_addr[8]) {
     unsigned char leaf[SPX_N];
     uint32_t fors_tree_addr[8] = {0};
-    uint32_t fors_pk_addr[8] = {0};
-    uint32_t idx_offset;
-    unsigned int i;
+    uint32_t idx_offset = i * (1 << SPX_FORS_HEIGHT);
+    uint32_t index = 0;
+    unsigned int offset = i * SPX_FORS_HEIGHT;
+    unsigned int j;
 
-    copy_keypair_addr(fors_tree_addr, fors_addr);
-    copy_keypair_addr(fors_pk_addr, fors_addr);
+    /* Bits i * SPX_FORS_HEIGHT on of m, as message_to_indices() reads them */
+    for (j = 0; j < SPX_FORS_HEIGHT; j++) {
+        index ^= (uint32_t)(((m[offset >> 3] >> (offset & 0x7)) & 0x1) << j);
+        offset++;
+    }
 
+    copy_keypair_addr(fors_tree_addr, fors_addr);
     set_type(fors_tree_addr, SPX_ADDR_TYPE_FORSTREE);
-    set_type(fors_pk_addr, SPX_ADDR_TYPE_FORSPK);
 
-    message_to_indices(indices, m);
+    set_tree_height(fors_tree_addr, 0);
+    set_tree_index(fors_tree_addr, index + idx_offset);
 
-    for (i = 0; i < SPX_FORS_TREES; i++) {
-        idx_offset = i * (1 << SPX_FORS_HEIGHT);
+    /* Derive the leaf from the included secret key part. */
+    fors_sk_to_leaf(leaf, tree_sig, ctx, fors_tree_addr);
 
-        set_tree_height(fors_tree_addr, 0);
-        set_tree_index(fors_tree_addr, indices[i] + idx_offset);
+    /* Derive the corresponding root node of this tree. */
+    compute_root(root, leaf, index, idx_offset,
+                 tree_sig + SPX_N, SPX_FORS_HEIGHT, ctx, fors_tree_addr);
+}
 
-        /* Derive the leaf from the included secret key part. */
-        fors_sk_to_leaf(leaf, sig, ctx, fors_tree_addr);
-        sig += SPX_N;
+/**
+ * Derives the FORS public key from the roots of all its trees.
+ */
+void fors_pk_from_roots(unsigned char *pk, const unsigned char *roots,
+                        const spx_ctx *ctx,
+                        const uint32_t fors_addr[8]) {
+    uint32_t fors_pk_addr[8] = {0};
 
-        /* Derive the corresponding root node of this tree. */
-        compute_root(roots + (i * SPX_N), leaf, indices[i], idx_offset,
-                     sig, SPX_FORS_HEIGHT, ctx, fors_tree_addr);
-        sig += SPX_N * SPX_FORS_HEIGHT;
-    }
+    copy_keypair_addr(fors_pk_addr, fors_addr);
+    set_type(fors_pk_addr, SPX_ADDR_TYPE_FORSPK);
 
     /* Hash horizontally across all tree roots to derive the public key. */
     thash(pk, roots, SPX_FORS_TREES, ctx, fors_pk_addr);
 }
+
+/**
+ * Derives the FORS public key from a signature.
+ * This can be used for verification by comparing to a known public key, or to
+ * subsequently verify a signature on the derived public key. The latter is the
+ * typical use-case when used as an FTS below an OTS in a hypertree.
+ * Assumes m contains at least SPX_FORS_HEIGHT * SPX_FORS_TREES bits.
+ */
+void fors_pk_from_sig(unsigned char *pk,
+                      const unsigned char *sig, const unsigned char *m,
+                      const spx_ctx *ctx,
+                      const uint32_t fors_addr[8]) {
+    unsigned char roots[SPX_FORS_TREES * SPX_N];
+    uint32_t i;
+
+    for (i = 0; i < SPX_FORS_TREES; i++) {
+        fors_tree_root_from_sig(roots + (i * SPX_N), sig, m, i, ctx, fors_addr);
+        sig += SPX_FORS_TREE_BYTES;
+    }
+
+    fors_pk_from_roots(pk, roots, ctx, fors_addr);
+}
@@ -0,0 +1,25 @@
+#ifndef SPX_UTILSX4_H
+#define SPX_UTILSX4_H
+
+#include <stdint.h>
+
+#include "context.h"
+#include "params.h"
+
+/**
+ * Same as treehashx1(), but builds the tree four leaves at a time: gen_leafx4
+ * writes the four consecutive leaves starting at addr_idx, and the nodes of
+ * each level are combined four at a time with thashx4(). tree_addrx4 holds
+ * four copies of the tree address. Expects tree_height to be at least 2.
+ */
+#define treehashx4 SPX_NAMESPACE(treehashx4)
+void treehashx4(unsigned char *root, unsigned char *auth_path,
+                const spx_ctx *ctx,
+                uint32_t leaf_idx, uint32_t idx_offset, uint32_t tree_height,
+                void (*gen_leafx4)(
+                    unsigned char * /* Where to write the leaves */,
+                    const spx_ctx * /* ctx */,
+                    uint32_t addr_idx, void *info),
+                uint32_t tree_addrx4[4 * 8], void *info);
+
+#endif
@@ -1,367 +1,606 @@
 #include "dsa.h"
-#include "string.h"
-#include "freertos/FreeRTOS.h"
+#include "dsa_parallel.h"
+#include "dsa_stack_budget.h"
+#include "dsa_stats.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
-const char* getAlgoName(enum DSA_ALGO algo){
-    switch (algo)
-    {
-        case FALCON_512: return "FALCON_512";
-        case FALCON_1024: return "FALCON_1024";
-        case FALCON_PADDED_512: return "FALCON_PADDED_512";
-        case FALCON_PADDED_1024: return "FALCON_PADDED_1024";
-        case ML_DSA_44: return "ML_DSA_44";
-        case ML_DSA_65: return "ML_DSA_65";
-        case ML_DSA_87: return "ML_DSA_87";
-        case SPHINCS_SHA2_128F: return "SPHINCS_SHA2_128F";
-        case SPHINCS_SHA2_128S: return "SPHINCS_SHA2_128S";
-        case SPHINCS_SHA2_192F: return "SPHINCS_SHA2_192F";
-        case SPHINCS_SHA2_192S: return "SPHINCS_SHA2_192S";
-        case SPHINCS_SHA2_256F: return "SPHINCS_SHA2_256F";
-        case SPHINCS_SHA2_256S: return "SPHINCS_SHA2_256S";
-        case SPHINCS_SHAKE_128F: return "SPHINCS_SHAKE_128F";
-        case SPHINCS_SHAKE_128S: return "SPHINCS_SHAKE_128S";
-        case SPHINCS_SHAKE_192F: return "SPHINCS_SHAKE_192F";
-        case SPHINCS_SHAKE_192S: return "SPHINCS_SHAKE_192S";
-        case SPHINCS_SHAKE_256F: return "SPHINCS_SHAKE_256F";
-        case SPHINCS_SHAKE_256S: return "SPHINCS_SHAKE_256S";
-        default: return "Unknown Algorithm";
+#define HEAP(keygen, sign, verify) { keygen, sign, verify }
+
+// One row per parameter set. `ns` is the PQClean namespace of the
+// implementation; every scheme exports the same crypto_sign_* entry points
+// under it. Stack figures come from dsa_stack_budget.h (profiled on the
+// target, or the host estimates of dsa_stack_budget_host.h); heap
+// figures are the peak transient allocations of each operation, without
+// CONFIG_DSA_KECCAK_HEAP_STATE (which adds 208 bytes wherever SHAKE is used).
+// SPHINCS+ signing adds the helper task of CONFIG_DSA_SPHINCS_PARALLEL.
+#define DSA_FIELDS(algo, ns)                                                \
+        .name = #algo,                                                      \
+        .pk_len = PQCLEAN_##ns##_CLEAN_CRYPTO_PUBLICKEYBYTES,               \
+        .sk_len = PQCLEAN_##ns##_CLEAN_CRYPTO_SECRETKEYBYTES,               \
+        .sig_len = PQCLEAN_##ns##_CLEAN_CRYPTO_BYTES,                       \
+        .stack_bytes = {                                                    \
+            DSA_STACK_BUDGET_##algo##_KEYGEN,                               \
+            DSA_STACK_BUDGET_##algo##_SIGN,                                 \
+            DSA_STACK_BUDGET_##algo##_VERIFY,                               \
+        },                                                                  \
+        .stack_ws_bytes = {                                                 \
+            DSA_STACK_BUDGET_##algo##_KEYGEN_WS,                            \
+            DSA_STACK_BUDGET_##algo##_SIGN_WS,                              \
+            DSA_STACK_BUDGET_##algo##_VERIFY_WS,                            \
+        },                                                                  \
+        .stack_stream_bytes = {                                             \
+            0,                                                              \
+            DSA_STACK_BUDGET_##algo##_SIGN_STREAM,                          \
+            DSA_STACK_BUDGET_##algo##_VERIFY_STREAM,                        \
+        },                                                                  \
+        .keypair = PQCLEAN_##ns##_CLEAN_crypto_sign_keypair,                \
+        .sign = PQCLEAN_##ns##_CLEAN_crypto_sign,                           \
+        .signature = PQCLEAN_##ns##_CLEAN_crypto_sign_signature,            \
+        .verify = PQCLEAN_##ns##_CLEAN_crypto_sign_verify,                  \
+        .open = PQCLEAN_##ns##_CLEAN_crypto_sign_open,
+
+#define DSA_ENTRY(algo, ns, heap)                                           \
+    [algo] = {                                                              \
+        DSA_FIELDS(algo, ns)                                                \
+        .heap_bytes = heap,                                                 \
+    }
+
+// Same, for schemes that also export the crypto_sign_*_cached() signing
+// cache, the crypto_sign_*_keyctx() key context, the streaming signature
+// and the incremental crypto_sign_verify_*() verification.
+#define DSA_ENTRY_CACHE(algo, ns, heap)                                     \
+    [algo] = {                                                              \
+        DSA_FIELDS(algo, ns)                                                \
+        .heap_bytes = heap,                                                 \
+        .sign_cache_bytes = PQCLEAN_##ns##_CLEAN_crypto_sign_cachebytes,    \
+        .sign_cache_init = PQCLEAN_##ns##_CLEAN_crypto_sign_cache_init,     \
+        .signature_cached = PQCLEAN_##ns##_CLEAN_crypto_sign_signature_cached, \
+        .key_ctx_bytes = PQCLEAN_##ns##_CLEAN_crypto_sign_keyctxbytes,      \
+        .key_ctx_init = PQCLEAN_##ns##_CLEAN_crypto_sign_keyctx_init,       \
+        .key_ctx_release = PQCLEAN_##ns##_CLEAN_crypto_sign_keyctx_release, \
+        .signature_key_ctx = PQCLEAN_##ns##_CLEAN_crypto_sign_signature_keyctx, \
+        .verify_key_ctx = PQCLEAN_##ns##_CLEAN_crypto_sign_verify_keyctx,   \
+        .signature_stream = PQCLEAN_##ns##_CLEAN_crypto_sign_signature_stream, \
+        .verify_state_bytes = PQCLEAN_##ns##_CLEAN_crypto_sign_verify_statebytes, \
+        .verify_init = PQCLEAN_##ns##_CLEAN_crypto_sign_verify_init,         \
+        .verify_update = PQCLEAN_##ns##_CLEAN_crypto_sign_verify_update,     \
+        .verify_final = PQCLEAN_##ns##_CLEAN_crypto_sign_verify_final,       \
+    }
+
+// Same, for schemes that also export the crypto_sign_*_ws() workspace
+// variants.
+#define DSA_WS_FIELDS(ns)                                                   \
+        .ws_bytes = {                                                       \
+            PQCLEAN_##ns##_CLEAN_crypto_sign_keypair_wsbytes,               \
+            PQCLEAN_##ns##_CLEAN_crypto_sign_signature_wsbytes,             \
+            PQCLEAN_##ns##_CLEAN_crypto_sign_verify_wsbytes,                \
+        },                                                                  \
+        .keypair_ws = PQCLEAN_##ns##_CLEAN_crypto_sign_keypair_ws,          \
+        .signature_ws = PQCLEAN_##ns##_CLEAN_crypto_sign_signature_ws,      \
+        .verify_ws = PQCLEAN_##ns##_CLEAN_crypto_sign_verify_ws,
+
+#define DSA_ENTRY_WS(algo, ns, heap)                                        \
+    [algo] = {                                                              \
+        DSA_FIELDS(algo, ns)                                                \
+        DSA_WS_FIELDS(ns)                                                   \
+        .heap_bytes = heap,                                                 \
+    }
+
+// Same, for ML-DSA, which also exports a crypto_sign_*_keyctx() key
+// context. It signs and verifies from the context alone, so
+// DSA_KEY_CTX_ADAPTERS() fits its functions to the descriptor fields
+// shared with SPHINCS+.
+#define DSA_KEY_CTX_ADAPTERS(ns)                                            \
+    static int ns##_signature_key_ctx(uint8_t *sig, size_t *siglen,         \
+                const uint8_t *m, size_t mlen, const uint8_t *sk,           \
+                const void *key_ctx, const uint8_t *cache) {                \
+        (void)sk;                                                           \
+        (void)cache;                                                        \
+        return PQCLEAN_##ns##_CLEAN_crypto_sign_signature_keyctx(sig, siglen, \
+                                                                 m, mlen, key_ctx); \
+    }                                                                       \
+    static int ns##_verify_key_ctx(const uint8_t *sig, size_t siglen,       \
+                const uint8_t *m, size_t mlen, const uint8_t *pk,           \
+                const void *key_ctx) {                                      \
+        (void)pk;                                                           \
+        return PQCLEAN_##ns##_CLEAN_crypto_sign_verify_keyctx(sig, siglen,  \
+                                                              m, mlen, key_ctx); \
+    }
+
+#define DSA_ENTRY_WS_KEY_CTX(algo, ns, heap)                                \
+    [algo] = {                                                              \
+        DSA_FIELDS(algo, ns)                                                \
+        DSA_WS_FIELDS(ns)                                                   \
+        .heap_bytes = heap,                                                 \
+        .key_ctx_bytes = PQCLEAN_##ns##_CLEAN_crypto_sign_keyctxbytes,      \
+        .key_ctx_init = PQCLEAN_##ns##_CLEAN_crypto_sign_keyctx_init,       \
+        .key_ctx_release = PQCLEAN_##ns##_CLEAN_crypto_sign_keyctx_release, \
+        .signature_key_ctx = ns##_signature_key_ctx,                        \
+        .verify_key_ctx = ns##_verify_key_ctx,                              \
+    }
+
+#ifdef CONFIG_DSA_ML_DSA_44
+DSA_KEY_CTX_ADAPTERS(MLDSA44)
+#endif
+#ifdef CONFIG_DSA_ML_DSA_65
+DSA_KEY_CTX_ADAPTERS(MLDSA65)
+#endif
+#ifdef CONFIG_DSA_ML_DSA_87
+DSA_KEY_CTX_ADAPTERS(MLDSA87)
+#endif
+
+static const struct dsa_descriptor dsa_registry[DSA_ALGO_COUNT] = {
+#ifdef CONFIG_DSA_FALCON_512
+    DSA_ENTRY_WS(FALCON_512, FALCON512, HEAP(0, 0, 0)),
+#endif
+#ifdef CONFIG_DSA_FALCON_1024
+    DSA_ENTRY_WS(FALCON_1024, FALCON1024, HEAP(0, 0, 0)),
+#endif
+#ifdef CONFIG_DSA_FALCON_PADDED_512
+    DSA_ENTRY_WS(FALCON_PADDED_512, FALCONPADDED512, HEAP(0, 0, 0)),
+#endif
+#ifdef CONFIG_DSA_FALCON_PADDED_1024
+    DSA_ENTRY_WS(FALCON_PADDED_1024, FALCONPADDED1024, HEAP(0, 0, 0)),
+#endif
+#ifdef CONFIG_DSA_ML_DSA_44
+    DSA_ENTRY_WS_KEY_CTX(ML_DSA_44, MLDSA44, HEAP(0, 0, 0)),
+#endif
+#ifdef CONFIG_DSA_ML_DSA_65
+    DSA_ENTRY_WS_KEY_CTX(ML_DSA_65, MLDSA65, HEAP(0, 0, 0)),
+#endif
+#ifdef CONFIG_DSA_ML_DSA_87
+    DSA_ENTRY_WS_KEY_CTX(ML_DSA_87, MLDSA87, HEAP(0, 0, 0)),
+#endif
+#ifdef CONFIG_DSA_SPHINCS_SHA2_128F
+    DSA_ENTRY_CACHE(SPHINCS_SHA2_128F, SPHINCSSHA2128FSIMPLE, HEAP(0, 40 + DSA_PARALLEL_HEAP_BYTES, 40)),
+#endif
+#ifdef CONFIG_DSA_SPHINCS_SHA2_128S
+    DSA_ENTRY_CACHE(SPHINCS_SHA2_128S, SPHINCSSHA2128SSIMPLE, HEAP(0, 40 + DSA_PARALLEL_HEAP_BYTES, 40)),
+#endif
+#ifdef CONFIG_DSA_SPHINCS_SHA2_192F
+    DSA_ENTRY_CACHE(SPHINCS_SHA2_192F, SPHINCSSHA2192FSIMPLE, HEAP(0, 72 + DSA_PARALLEL_HEAP_BYTES, 72)),
+#endif
+#ifdef CONFIG_DSA_SPHINCS_SHA2_192S
+    DSA_ENTRY_CACHE(SPHINCS_SHA2_192S, SPHINCSSHA2192SSIMPLE, HEAP(0, 72 + DSA_PARALLEL_HEAP_BYTES, 72)),
+#endif
+#ifdef CONFIG_DSA_SPHINCS_SHA2_256F
+    DSA_ENTRY_CACHE(SPHINCS_SHA2_256F, SPHINCSSHA2256FSIMPLE, HEAP(0, 72 + DSA_PARALLEL_HEAP_BYTES, 72)),
+#endif
+#ifdef CONFIG_DSA_SPHINCS_SHA2_256S
+    DSA_ENTRY_CACHE(SPHINCS_SHA2_256S, SPHINCSSHA2256SSIMPLE, HEAP(0, 72 + DSA_PARALLEL_HEAP_BYTES, 72)),
+#endif
+#ifdef CONFIG_DSA_SPHINCS_SHAKE_128F
+    DSA_ENTRY_CACHE(SPHINCS_SHAKE_128F, SPHINCSSHAKE128FSIMPLE, HEAP(0, 0 + DSA_PARALLEL_HEAP_BYTES, 0)),
+#endif
+#ifdef CONFIG_DSA_SPHINCS_SHAKE_128S
+    DSA_ENTRY_CACHE(SPHINCS_SHAKE_128S, SPHINCSSHAKE128SSIMPLE, HEAP(0, 0 + DSA_PARALLEL_HEAP_BYTES, 0)),
+#endif
+#ifdef CONFIG_DSA_SPHINCS_SHAKE_192F
+    DSA_ENTRY_CACHE(SPHINCS_SHAKE_192F, SPHINCSSHAKE192FSIMPLE, HEAP(0, 0 + DSA_PARALLEL_HEAP_BYTES, 0)),
+#endif
+#ifdef CONFIG_DSA_SPHINCS_SHAKE_192S
+    DSA_ENTRY_CACHE(SPHINCS_SHAKE_192S, SPHINCSSHAKE192SSIMPLE, HEAP(0, 0 + DSA_PARALLEL_HEAP_BYTES, 0)),
+#endif
+#ifdef CONFIG_DSA_SPHINCS_SHAKE_256F
+    DSA_ENTRY_CACHE(SPHINCS_SHAKE_256F, SPHINCSSHAKE256FSIMPLE, HEAP(0, 0 + DSA_PARALLEL_HEAP_BYTES, 0)),
+#endif
+#ifdef CONFIG_DSA_SPHINCS_SHAKE_256S
+    DSA_ENTRY_CACHE(SPHINCS_SHAKE_256S, SPHINCSSHAKE256SSIMPLE, HEAP(0, 0 + DSA_PARALLEL_HEAP_BYTES, 0)),
+#endif
+};
+
+const struct dsa_descriptor *dsa_get_descriptor(enum DSA_ALGO algo) {
+    if ((unsigned)algo >= DSA_ALGO_COUNT || dsa_registry[algo].name == NULL) {
+        return NULL; // Unsupported algorithm
     }
+    return &dsa_registry[algo];
+}
+
+const char* getAlgoName(enum DSA_ALGO algo){
+    const struct dsa_descriptor *d = dsa_get_descriptor(algo);
+    return d ? d->name : "Unknown Algorithm";
 }
 
 int dsa_keygen(enum DSA_ALGO algo, uint8_t *pk, uint8_t *sk) {
-    switch (algo) {
-        case FALCON_512:
-            return PQCLEAN_FALCON512_CLEAN_crypto_sign_keypair(pk, sk);
-        case FALCON_1024:
-            return PQCLEAN_FALCON1024_CLEAN_crypto_sign_keypair(pk, sk);
-        case FALCON_PADDED_512:
-            return PQCLEAN_FALCONPADDED512_CLEAN_crypto_sign_keypair(pk, sk);
-        case FALCON_PADDED_1024:
-            return PQCLEAN_FALCONPADDED1024_CLEAN_crypto_sign_keypair(pk, sk);
-        case ML_DSA_44:
-            return PQCLEAN_MLDSA44_CLEAN_crypto_sign_keypair(pk, sk);
-        case ML_DSA_65:
-            return PQCLEAN_MLDSA65_CLEAN_crypto_sign_keypair(pk, sk);
-        case ML_DSA_87:
-            return PQCLEAN_MLDSA87_CLEAN_crypto_sign_keypair(pk, sk);
-        case SPHINCS_SHA2_128F:
-            return PQCLEAN_SPHINCSSHA2128FSIMPLE_CLEAN_crypto_sign_keypair(pk, sk);
-        case SPHINCS_SHA2_128S:
-            return PQCLEAN_SPHINCSSHA2128SSIMPLE_CLEAN_crypto_sign_keypair(pk, sk);
-        case SPHINCS_SHA2_192F:
-            return PQCLEAN_SPHINCSSHA2192FSIMPLE_CLEAN_crypto_sign_keypair(pk, sk);
-        case SPHINCS_SHA2_192S:
-            return PQCLEAN_SPHINCSSHA2192SSIMPLE_CLEAN_crypto_sign_keypair(pk, sk);
-        case SPHINCS_SHA2_256F:
-            return PQCLEAN_SPHINCSSHA2256FSIMPLE_CLEAN_crypto_sign_keypair(pk, sk);
-        case SPHINCS_SHA2_256S:
-            return PQCLEAN_SPHINCSSHA2256SSIMPLE_CLEAN_crypto_sign_keypair(pk, sk);
-        case SPHINCS_SHAKE_128F:
-            return PQCLEAN_SPHINCSSHAKE128FSIMPLE_CLEAN_crypto_sign_keypair(pk, sk);
-        case SPHINCS_SHAKE_128S:
-            return PQCLEAN_SPHINCSSHAKE128SSIMPLE_CLEAN_crypto_sign_keypair(pk, sk);
-        case SPHINCS_SHAKE_192F:
-            return PQCLEAN_SPHINCSSHAKE192FSIMPLE_CLEAN_crypto_sign_keypair(pk, sk);
-        case SPHINCS_SHAKE_192S:
-            return PQCLEAN_SPHINCSSHAKE192SSIMPLE_CLEAN_crypto_sign_keypair(pk, sk);
-        case SPHINCS_SHAKE_256F:
-            return PQCLEAN_SPHINCSSHAKE256FSIMPLE_CLEAN_crypto_sign_keypair(pk, sk);
-        case SPHINCS_SHAKE_256S:
-            return PQCLEAN_SPHINCSSHAKE256SSIMPLE_CLEAN_crypto_sign_keypair(pk, sk);
-        default:
-            return -1; // Unsupported algorithm
+    const struct dsa_descriptor *d = dsa_get_descriptor(algo);
+    if (!d) {
+        return -1; // Unsupported algorithm
     }
+    DSA_PROBE_BEGIN(probe);
+    int ret = d->keypair(pk, sk);
+    DSA_PROBE_END(probe, algo, DSA_OP_KEYGEN, ret);
+    return ret;
 }
 
 int dsa_sign(enum DSA_ALGO algo, uint8_t *sig, size_t *siglen,
             const uint8_t *m, size_t mlen, const uint8_t *sk) {
-    switch (algo) {
-        case FALCON_512:
-            return PQCLEAN_FALCON512_CLEAN_crypto_sign(sig, siglen, m, mlen, sk);
-        case FALCON_1024:
-            return PQCLEAN_FALCON1024_CLEAN_crypto_sign(sig, siglen, m, mlen, sk);
-        case FALCON_PADDED_512:
-            return PQCLEAN_FALCONPADDED512_CLEAN_crypto_sign(sig, siglen, m, mlen, sk);
-        case FALCON_PADDED_1024:
-            return PQCLEAN_FALCONPADDED1024_CLEAN_crypto_sign(sig, siglen, m, mlen, sk);
-        case ML_DSA_44:
-            return PQCLEAN_MLDSA44_CLEAN_crypto_sign(sig, siglen, m, mlen, sk);
-        case ML_DSA_65:
-            return PQCLEAN_MLDSA65_CLEAN_crypto_sign(sig, siglen, m, mlen, sk);
-        case ML_DSA_87:
-            return PQCLEAN_MLDSA87_CLEAN_crypto_sign(sig, siglen, m, mlen, sk);
-        case SPHINCS_SHA2_128F:
-            return PQCLEAN_SPHINCSSHA2128FSIMPLE_CLEAN_crypto_sign(sig, siglen, m, mlen, sk);
-        case SPHINCS_SHA2_128S:
-            return PQCLEAN_SPHINCSSHA2128SSIMPLE_CLEAN_crypto_sign(sig, siglen, m, mlen, sk);
-        case SPHINCS_SHA2_192F:
-            return PQCLEAN_SPHINCSSHA2192FSIMPLE_CLEAN_crypto_sign(sig, siglen, m, mlen, sk);
-        case SPHINCS_SHA2_192S:
-            return PQCLEAN_SPHINCSSHA2192SSIMPLE_CLEAN_crypto_sign(sig, siglen, m, mlen, sk);
-        case SPHINCS_SHA2_256F:
-            return PQCLEAN_SPHINCSSHA2256FSIMPLE_CLEAN_crypto_sign(sig, siglen, m, mlen, sk);
-        case SPHINCS_SHA2_256S:
-            return PQCLEAN_SPHINCSSHA2256SSIMPLE_CLEAN_crypto_sign(sig, siglen, m, mlen, sk);
-        case SPHINCS_SHAKE_128F:
-            return PQCLEAN_SPHINCSSHAKE128FSIMPLE_CLEAN_crypto_sign(sig, siglen, m, mlen, sk);
-        case SPHINCS_SHAKE_128S:
-            return PQCLEAN_SPHINCSSHAKE128SSIMPLE_CLEAN_crypto_sign(sig, siglen, m, mlen, sk);
-        case SPHINCS_SHAKE_192F:
-            return PQCLEAN_SPHINCSSHAKE192FSIMPLE_CLEAN_crypto_sign(sig, siglen, m, mlen, sk);
-        case SPHINCS_SHAKE_192S:
-            return PQCLEAN_SPHINCSSHAKE192SSIMPLE_CLEAN_crypto_sign(sig, siglen, m, mlen, sk);
-        case SPHINCS_SHAKE_256F:
-            return PQCLEAN_SPHINCSSHAKE256FSIMPLE_CLEAN_crypto_sign(sig, siglen, m, mlen, sk);
-        case SPHINCS_SHAKE_256S:
-            return PQCLEAN_SPHINCSSHAKE256SSIMPLE_CLEAN_crypto_sign(sig, siglen, m, mlen, sk);
-        default:
-            return -1; // Unsupported algorithm
+    const struct dsa_descriptor *d = dsa_get_descriptor(algo);
+    if (!d) {
+        return -1; // Unsupported algorithm
     }
+    DSA_PROBE_BEGIN(probe);
+    int ret = d->sign(sig, siglen, m, mlen, sk);
+    DSA_PROBE_END(probe, algo, DSA_OP_SIGN, ret);
+    return ret;
 }
 
 int dsa_signature(enum DSA_ALGO algo, uint8_t *sig, size_t *siglen,
             const uint8_t *m, size_t mlen, const uint8_t *sk) {
-                switch (algo) {
-        case FALCON_512:
-            return PQCLEAN_FALCON512_CLEAN_crypto_sign_signature(sig, siglen, m, mlen, sk);
-        case FALCON_1024:
-            return PQCLEAN_FALCON1024_CLEAN_crypto_sign_signature(sig, siglen, m, mlen, sk);
-        case FALCON_PADDED_512:
-            return PQCLEAN_FALCONPADDED512_CLEAN_crypto_sign_signature(sig, siglen, m, mlen, sk);
-        case FALCON_PADDED_1024:
-            return PQCLEAN_FALCONPADDED1024_CLEAN_crypto_sign_signature(sig, siglen, m, mlen, sk);
-        case ML_DSA_44:
-            return PQCLEAN_MLDSA44_CLEAN_crypto_sign_signature(sig, siglen, m, mlen, sk);
-        case ML_DSA_65:
-            return PQCLEAN_MLDSA65_CLEAN_crypto_sign_signature(sig, siglen, m, mlen, sk);
-        case ML_DSA_87:
-            return PQCLEAN_MLDSA87_CLEAN_crypto_sign_signature(sig, siglen, m, mlen, sk);
-        case SPHINCS_SHA2_128F:
-            return PQCLEAN_SPHINCSSHA2128FSIMPLE_CLEAN_crypto_sign_signature(sig, siglen, m, mlen, sk);
-        case SPHINCS_SHA2_128S:
-            return PQCLEAN_SPHINCSSHA2128SSIMPLE_CLEAN_crypto_sign_signature(sig, siglen, m, mlen, sk);
-        case SPHINCS_SHA2_192F:
-            return PQCLEAN_SPHINCSSHA2192FSIMPLE_CLEAN_crypto_sign_signature(sig, siglen, m, mlen, sk);
-        case SPHINCS_SHA2_192S:
-            return PQCLEAN_SPHINCSSHA2192SSIMPLE_CLEAN_crypto_sign_signature(sig, siglen, m, mlen, sk);
-        case SPHINCS_SHA2_256F:
-            return PQCLEAN_SPHINCSSHA2256FSIMPLE_CLEAN_crypto_sign_signature(sig, siglen, m, mlen, sk);
-        case SPHINCS_SHA2_256S:
-            return PQCLEAN_SPHINCSSHA2256SSIMPLE_CLEAN_crypto_sign_signature(sig, siglen, m, mlen, sk);
-        case SPHINCS_SHAKE_128F:
-            return PQCLEAN_SPHINCSSHAKE128FSIMPLE_CLEAN_crypto_sign_signature(sig, siglen, m, mlen, sk);
-        case SPHINCS_SHAKE_128S:
-            return PQCLEAN_SPHINCSSHAKE128SSIMPLE_CLEAN_crypto_sign_signature(sig, siglen, m, mlen, sk);
-        case SPHINCS_SHAKE_192F:
-            return PQCLEAN_SPHINCSSHAKE192FSIMPLE_CLEAN_crypto_sign_signature(sig, siglen, m, mlen, sk);
-        case SPHINCS_SHAKE_192S:
-            return PQCLEAN_SPHINCSSHAKE192SSIMPLE_CLEAN_crypto_sign_signature(sig, siglen, m, mlen, sk);
-        case SPHINCS_SHAKE_256F:
-            return PQCLEAN_SPHINCSSHAKE256FSIMPLE_CLEAN_crypto_sign_signature(sig, siglen, m, mlen, sk);
-        case SPHINCS_SHAKE_256S:
-            return PQCLEAN_SPHINCSSHAKE256SSIMPLE_CLEAN_crypto_sign_signature(sig, siglen, m, mlen, sk);
-        default:
-            return -1; // Unsupported algorithm
+    const struct dsa_descriptor *d = dsa_get_descriptor(algo);
+    if (!d) {
+        return -1; // Unsupported algorithm
     }
+    DSA_PROBE_BEGIN(probe);
+    int ret = d->signature(sig, siglen, m, mlen, sk);
+    DSA_PROBE_END(probe, algo, DSA_OP_SIGN, ret);
+    return ret;
 }
 
 int dsa_verify(enum DSA_ALGO algo, const uint8_t *sig, size_t siglen,
             const uint8_t *m, size_t mlen, const uint8_t *pk) {
-    switch (algo) {
-        case FALCON_512:
-            return PQCLEAN_FALCON512_CLEAN_crypto_sign_verify(sig, siglen, m, mlen, pk);
-        case FALCON_1024:
-            return PQCLEAN_FALCON1024_CLEAN_crypto_sign_verify(sig, siglen, m, mlen, pk);
-        case FALCON_PADDED_512:
-            return PQCLEAN_FALCONPADDED512_CLEAN_crypto_sign_verify(sig, siglen, m, mlen, pk);
-        case FALCON_PADDED_1024:
-            return PQCLEAN_FALCONPADDED1024_CLEAN_crypto_sign_verify(sig, siglen, m, mlen, pk);
-        case ML_DSA_44:
-            return PQCLEAN_MLDSA44_CLEAN_crypto_sign_verify(sig, siglen, m, mlen, pk);
-        case ML_DSA_65:
-            return PQCLEAN_MLDSA65_CLEAN_crypto_sign_verify(sig, siglen, m, mlen, pk);
-        case ML_DSA_87:
-            return PQCLEAN_MLDSA87_CLEAN_crypto_sign_verify(sig, siglen, m, mlen, pk);
-        case SPHINCS_SHA2_128F:
-            return PQCLEAN_SPHINCSSHA2128FSIMPLE_CLEAN_crypto_sign_verify(sig, siglen, m, mlen, pk);
-        case SPHINCS_SHA2_128S:
-            return PQCLEAN_SPHINCSSHA2128SSIMPLE_CLEAN_crypto_sign_verify(sig, siglen, m, mlen, pk);
-        case SPHINCS_SHA2_192F:
-            return PQCLEAN_SPHINCSSHA2192FSIMPLE_CLEAN_crypto_sign_verify(sig, siglen, m, mlen, pk);
-        case SPHINCS_SHA2_192S:
-            return PQCLEAN_SPHINCSSHA2192SSIMPLE_CLEAN_crypto_sign_verify(sig, siglen, m, mlen, pk);
-        case SPHINCS_SHA2_256F:
-            return PQCLEAN_SPHINCSSHA2256FSIMPLE_CLEAN_crypto_sign_verify(sig, siglen, m, mlen, pk);
-        case SPHINCS_SHA2_256S:
-            return PQCLEAN_SPHINCSSHA2256SSIMPLE_CLEAN_crypto_sign_verify(sig, siglen, m, mlen, pk);
-        case SPHINCS_SHAKE_128F:
-            return PQCLEAN_SPHINCSSHAKE128FSIMPLE_CLEAN_crypto_sign_verify(sig, siglen, m, mlen, pk);
-        case SPHINCS_SHAKE_128S:
-            return PQCLEAN_SPHINCSSHAKE128SSIMPLE_CLEAN_crypto_sign_verify(sig, siglen, m, mlen, pk);
-        case SPHINCS_SHAKE_192F:
-            return PQCLEAN_SPHINCSSHAKE192FSIMPLE_CLEAN_crypto_sign_verify(sig, siglen, m, mlen, pk);
-        case SPHINCS_SHAKE_192S:
-            return PQCLEAN_SPHINCSSHAKE192SSIMPLE_CLEAN_crypto_sign_verify(sig, siglen, m, mlen, pk);
-        case SPHINCS_SHAKE_256F:
-            return PQCLEAN_SPHINCSSHAKE256FSIMPLE_CLEAN_crypto_sign_verify(sig, siglen, m, mlen, pk);
-        case SPHINCS_SHAKE_256S:
-            return PQCLEAN_SPHINCSSHAKE256SSIMPLE_CLEAN_crypto_sign_verify(sig, siglen, m, mlen, pk);
-        default:
-            return -1; // Unsupported algorithm
+    const struct dsa_descriptor *d = dsa_get_descriptor(algo);
+    if (!d) {
+        return -1; // Unsupported algorithm
     }
+    DSA_PROBE_BEGIN(probe);
+    int ret = d->verify(sig, siglen, m, mlen, pk);
+    DSA_PROBE_END(probe, algo, DSA_OP_VERIFY, ret);
+    return ret;
 }
 
 int dsa_open(enum DSA_ALGO algo, uint8_t *m, size_t *mlen,
             const uint8_t *sm, size_t smlen, const uint8_t *pk) {
-    switch (algo) {
-        case FALCON_512:
-            return PQCLEAN_FALCON512_CLEAN_crypto_sign_open(m, mlen, sm, smlen, pk);
-        case FALCON_1024:
-            return PQCLEAN_FALCON1024_CLEAN_crypto_sign_open(m, mlen, sm, smlen, pk);
-        case FALCON_PADDED_512:
-            return PQCLEAN_FALCONPADDED512_CLEAN_crypto_sign_open(m, mlen, sm, smlen, pk);
-        case FALCON_PADDED_1024:
-            return PQCLEAN_FALCONPADDED1024_CLEAN_crypto_sign_open(m, mlen, sm, smlen, pk);
-        case ML_DSA_44:
-            return PQCLEAN_MLDSA44_CLEAN_crypto_sign_open(m, mlen, sm, smlen, pk);
-        case ML_DSA_65:
-            return PQCLEAN_MLDSA65_CLEAN_crypto_sign_open(m, mlen, sm, smlen, pk);
-        case ML_DSA_87:
-            return PQCLEAN_MLDSA87_CLEAN_crypto_sign_open(m, mlen, sm, smlen, pk);
-        case SPHINCS_SHA2_128F:
-            return PQCLEAN_SPHINCSSHA2128FSIMPLE_CLEAN_crypto_sign_open(m, mlen, sm, smlen, pk);
-        case SPHINCS_SHA2_128S:
-            return PQCLEAN_SPHINCSSHA2128SSIMPLE_CLEAN_crypto_sign_open(m, mlen, sm, smlen, pk);
-        case SPHINCS_SHA2_192F:
-            return PQCLEAN_SPHINCSSHA2192FSIMPLE_CLEAN_crypto_sign_open(m, mlen, sm, smlen, pk);
-        case SPHINCS_SHA2_192S:
-            return PQCLEAN_SPHINCSSHA2192SSIMPLE_CLEAN_crypto_sign_open(m, mlen, sm, smlen, pk);
-        case SPHINCS_SHA2_256F:
-            return PQCLEAN_SPHINCSSHA2256FSIMPLE_CLEAN_crypto_sign_open(m, mlen, sm, smlen, pk);
-        case SPHINCS_SHA2_256S:
-            return PQCLEAN_SPHINCSSHA2256SSIMPLE_CLEAN_crypto_sign_open(m, mlen, sm, smlen, pk);
-        case SPHINCS_SHAKE_128F:
-            return PQCLEAN_SPHINCSSHAKE128FSIMPLE_CLEAN_crypto_sign_open(m, mlen, sm, smlen, pk);
-        case SPHINCS_SHAKE_128S:
-            return PQCLEAN_SPHINCSSHAKE128SSIMPLE_CLEAN_crypto_sign_open(m, mlen, sm, smlen, pk);
-        case SPHINCS_SHAKE_192F:
-            return PQCLEAN_SPHINCSSHAKE192FSIMPLE_CLEAN_crypto_sign_open(m, mlen, sm, smlen, pk);
-        case SPHINCS_SHAKE_192S:
-            return PQCLEAN_SPHINCSSHAKE192SSIMPLE_CLEAN_crypto_sign_open(m, mlen, sm, smlen, pk);
-        case SPHINCS_SHAKE_256F:
-            return PQCLEAN_SPHINCSSHAKE256FSIMPLE_CLEAN_crypto_sign_open(m, mlen, sm, smlen, pk);
-        case SPHINCS_SHAKE_256S:
-            return PQCLEAN_SPHINCSSHAKE256SSIMPLE_CLEAN_crypto_sign_open(m, mlen, sm, smlen, pk);
-        default:
-            return -1; // Unsupported algorithm
-    }
-}
-
-void alloc_space_for_dsa(enum DSA_ALGO algo,
-            uint8_t **pk, uint8_t **sk,
+    const struct dsa_descriptor *d = dsa_get_descriptor(algo);
+    if (!d) {
+        return -1; // Unsupported algorithm
+    }
+    DSA_PROBE_BEGIN(probe);
+    int ret = d->open(m, mlen, sm, smlen, pk);
+    DSA_PROBE_END(probe, algo, DSA_OP_VERIFY, ret);
+    return ret;
+}
+
+size_t dsa_workspace_size(enum DSA_ALGO algo, enum DSA_OP op) {
+    const struct dsa_descriptor *d = dsa_get_descriptor(algo);
+    if (!d || (unsigned)op >= DSA_OP_COUNT || !d->ws_bytes[op]) {
+        return 0;
+    }
+    return d->ws_bytes[op]();
+}
+
+// Looks up `algo` and checks `ws` against what `op` needs; NULL if the
+// algorithm is unsupported or the workspace too small or misaligned.
+static const struct dsa_descriptor *ws_descriptor(enum DSA_ALGO algo, enum DSA_OP op,
+                                                  const void *ws, size_t ws_len) {
+    const struct dsa_descriptor *d = dsa_get_descriptor(algo);
+    if (!d) {
+        return NULL; // Unsupported algorithm
+    }
+    if (ws_len < dsa_workspace_size(algo, op) || (uintptr_t)ws % DSA_WORKSPACE_ALIGN != 0) {
+        return NULL;
+    }
+    return d;
+}
+
+int dsa_keygen_ws(enum DSA_ALGO algo, uint8_t *pk, uint8_t *sk,
+            void *ws, size_t ws_len) {
+    const struct dsa_descriptor *d = ws_descriptor(algo, DSA_OP_KEYGEN, ws, ws_len);
+    if (!d) {
+        return -1;
+    }
+    DSA_PROBE_BEGIN(probe);
+    int ret = d->keypair_ws ? d->keypair_ws(pk, sk, ws) : d->keypair(pk, sk);
+    DSA_PROBE_END(probe, algo, DSA_OP_KEYGEN, ret);
+    return ret;
+}
+
+int dsa_signature_ws(enum DSA_ALGO algo, uint8_t *sig, size_t *siglen,
+            const uint8_t *m, size_t mlen, const uint8_t *sk,
+            void *ws, size_t ws_len) {
+    const struct dsa_descriptor *d = ws_descriptor(algo, DSA_OP_SIGN, ws, ws_len);
+    if (!d) {
+        return -1;
+    }
+    DSA_PROBE_BEGIN(probe);
+    int ret = d->signature_ws ? d->signature_ws(sig, siglen, m, mlen, sk, ws)
+                              : d->signature(sig, siglen, m, mlen, sk);
+    DSA_PROBE_END(probe, algo, DSA_OP_SIGN, ret);
+    return ret;
+}
+
+int dsa_verify_ws(enum DSA_ALGO algo, const uint8_t *sig, size_t siglen,
+            const uint8_t *m, size_t mlen, const uint8_t *pk,
+            void *ws, size_t ws_len) {
+    const struct dsa_descriptor *d = ws_descriptor(algo, DSA_OP_VERIFY, ws, ws_len);
+    if (!d) {
+        return -1;
+    }
+    DSA_PROBE_BEGIN(probe);
+    int ret = d->verify_ws ? d->verify_ws(sig, siglen, m, mlen, pk, ws)
+                           : d->verify(sig, siglen, m, mlen, pk);
+    DSA_PROBE_END(probe, algo, DSA_OP_VERIFY, ret);
+    return ret;
+}
+
+size_t dsa_sign_cache_size(enum DSA_ALGO algo) {
+    const struct dsa_descriptor *d = dsa_get_descriptor(algo);
+    if (!d || !d->sign_cache_bytes) {
+        return 0;
+    }
+    return d->sign_cache_bytes();
+}
+
+int dsa_sign_cache_init(enum DSA_ALGO algo, void *cache, size_t cache_len,
+            const uint8_t *sk) {
+    const struct dsa_descriptor *d = dsa_get_descriptor(algo);
+    if (!d || cache_len < dsa_sign_cache_size(algo)) {
+        return -1;
+    }
+    return d->sign_cache_init ? d->sign_cache_init(cache, sk) : 0;
+}
+
+int dsa_signature_cached(enum DSA_ALGO algo, uint8_t *sig, size_t *siglen,
+            const uint8_t *m, size_t mlen, const uint8_t *sk,
+            const void *cache, size_t cache_len) {
+    const struct dsa_descriptor *d = dsa_get_descriptor(algo);
+    if (!d || cache_len < dsa_sign_cache_size(algo)) {
+        return -1;
+    }
+    DSA_PROBE_BEGIN(probe);
+    int ret = d->signature_cached ? d->signature_cached(sig, siglen, m, mlen, sk, cache)
+                                  : d->signature(sig, siglen, m, mlen, sk);
+    DSA_PROBE_END(probe, algo, DSA_OP_SIGN, ret);
+    return ret;
+}
+
+struct dsa_key_ctx {
+    enum DSA_ALGO algo;
+    const struct dsa_descriptor *d;
+    const uint8_t *pk;
+    const uint8_t *sk;
+    void *scheme_ctx;   // d->key_ctx_bytes() bytes, NULL if the scheme has none
+    void *sign_cache;   // dsa_sign_cache_size() bytes, NULL if not asked for
+};
+
+// Offsets of the scheme context and signing cache within the single
+// allocation that also holds struct dsa_key_ctx.
+static size_t key_ctx_align(size_t n) {
+    return (n + DSA_WORKSPACE_ALIGN - 1) & ~(size_t)(DSA_WORKSPACE_ALIGN - 1);
+}
+
+struct dsa_key_ctx *dsa_key_ctx_new(enum DSA_ALGO algo,
+            const uint8_t *pk, const uint8_t *sk, bool sign_cache) {
+    const struct dsa_descriptor *d = dsa_get_descriptor(algo);
+    if (!d || (!pk && !sk)) {
+        return NULL;
+    }
+    size_t head_len = key_ctx_align(sizeof(struct dsa_key_ctx));
+    size_t scheme_len = key_ctx_align(d->key_ctx_bytes ? d->key_ctx_bytes() : 0);
+    size_t cache_len = sign_cache && sk ? dsa_sign_cache_size(algo) : 0;
+
+    uint8_t *mem = malloc(head_len + scheme_len + cache_len);
+    if (!mem) {
+        return NULL;
+    }
+    struct dsa_key_ctx *key_ctx = (struct dsa_key_ctx *)mem;
+    key_ctx->algo = algo;
+    key_ctx->d = d;
+    key_ctx->pk = pk;
+    key_ctx->sk = sk;
+    key_ctx->scheme_ctx = scheme_len ? mem + head_len : NULL;
+    key_ctx->sign_cache = cache_len ? mem + head_len + scheme_len : NULL;
+
+    if (key_ctx->scheme_ctx && d->key_ctx_init(key_ctx->scheme_ctx, pk, sk) != 0) {
+        free(key_ctx); // Nothing to release yet
+        return NULL;
+    }
+    if (key_ctx->sign_cache && d->sign_cache_init(key_ctx->sign_cache, sk) != 0) {
+        dsa_key_ctx_free(key_ctx);
+        return NULL;
+    }
+    return key_ctx;
+}
+
+void dsa_key_ctx_free(struct dsa_key_ctx *key_ctx) {
+    if (!key_ctx) {
+        return;
+    }
+    if (key_ctx->scheme_ctx) {
+        key_ctx->d->key_ctx_release(key_ctx->scheme_ctx);
+    }
+    free(key_ctx);
+}
+
+int dsa_key_ctx_signature(const struct dsa_key_ctx *key_ctx,
+            uint8_t *sig, size_t *siglen, const uint8_t *m, size_t mlen) {
+    if (!key_ctx || !key_ctx->sk) {
+        return -1;
+    }
+    const struct dsa_descriptor *d = key_ctx->d;
+    DSA_PROBE_BEGIN(probe);
+    int ret = key_ctx->scheme_ctx
+                  ? d->signature_key_ctx(sig, siglen, m, mlen, key_ctx->sk,
+                                         key_ctx->scheme_ctx, key_ctx->sign_cache)
+                  : d->signature(sig, siglen, m, mlen, key_ctx->sk);
+    DSA_PROBE_END(probe, key_ctx->algo, DSA_OP_SIGN, ret);
+    return ret;
+}
+
+int dsa_key_ctx_verify(const struct dsa_key_ctx *key_ctx,
+            const uint8_t *sig, size_t siglen, const uint8_t *m, size_t mlen) {
+    if (!key_ctx || !key_ctx->pk) {
+        return -1;
+    }
+    const struct dsa_descriptor *d = key_ctx->d;
+    DSA_PROBE_BEGIN(probe);
+    int ret = key_ctx->scheme_ctx
+                  ? d->verify_key_ctx(sig, siglen, m, mlen, key_ctx->pk, key_ctx->scheme_ctx)
+                  : d->verify(sig, siglen, m, mlen, key_ctx->pk);
+    DSA_PROBE_END(probe, key_ctx->algo, DSA_OP_VERIFY, ret);
+    return ret;
+}
+
+// Streams a signature of a scheme without a streaming variant: signs into
+// a heap buffer and hands it over in one piece.
+static int signature_whole(const struct dsa_descriptor *d,
+            const uint8_t *m, size_t mlen, const uint8_t *sk,
+            dsa_sink_fn sink, void *arg) {
+    size_t siglen = 0;
+    uint8_t *sig = malloc(d->sig_len);
+    if (!sig) {
+        return -1;
+    }
+    int ret = d->signature(sig, &siglen, m, mlen, sk);
+    if (ret == 0) {
+        ret = sink(arg, sig, siglen);
+    }
+    free(sig);
+    return ret;
+}
+
+int dsa_signature_stream(enum DSA_ALGO algo, const uint8_t *m, size_t mlen,
+            const uint8_t *sk, dsa_sink_fn sink, void *arg) {
+    const struct dsa_descriptor *d = dsa_get_descriptor(algo);
+    if (!d) {
+        return -1; // Unsupported algorithm
+    }
+    DSA_PROBE_BEGIN(probe);
+    int ret = d->signature_stream ? d->signature_stream(m, mlen, sk, NULL, NULL, sink, arg)
+                                  : signature_whole(d, m, mlen, sk, sink, arg);
+    DSA_PROBE_END(probe, algo, DSA_OP_SIGN, ret);
+    return ret;
+}
+
+int dsa_key_ctx_signature_stream(const struct dsa_key_ctx *key_ctx,
+            const uint8_t *m, size_t mlen, dsa_sink_fn sink, void *arg) {
+    if (!key_ctx || !key_ctx->sk) {
+        return -1;
+    }
+    const struct dsa_descriptor *d = key_ctx->d;
+    DSA_PROBE_BEGIN(probe);
+    int ret = d->signature_stream
+                  ? d->signature_stream(m, mlen, key_ctx->sk, key_ctx->scheme_ctx,
+                                        key_ctx->sign_cache, sink, arg)
+                  : signature_whole(d, m, mlen, key_ctx->sk, sink, arg);
+    DSA_PROBE_END(probe, key_ctx->algo, DSA_OP_SIGN, ret);
+    return ret;
+}
+
+struct dsa_verify_stream {
+    enum DSA_ALGO algo;
+    const struct dsa_descriptor *d;
+    const struct dsa_key_ctx *key_ctx; // NULL unless made from one
+    const uint8_t *m;
+    size_t mlen;
+    const uint8_t *pk;
+    void *state;    // d->verify_state_bytes() bytes, NULL if the scheme has none
+    uint8_t *sig;   // d->sig_len bytes, if state is NULL
+    size_t siglen;
+    int result;
+};
+
+static struct dsa_verify_stream *verify_stream_new(enum DSA_ALGO algo,
+            const struct dsa_descriptor *d, const struct dsa_key_ctx *key_ctx,
+            const uint8_t *m, size_t mlen, const uint8_t *pk) {
+    size_t head_len = key_ctx_align(sizeof(struct dsa_verify_stream));
+    size_t body_len = d->verify_state_bytes ? d->verify_state_bytes() : d->sig_len;
+
+    uint8_t *mem = malloc(head_len + body_len);
+    if (!mem) {
+        return NULL;
+    }
+    struct dsa_verify_stream *vs = (struct dsa_verify_stream *)mem;
+    vs->algo = algo;
+    vs->d = d;
+    vs->key_ctx = key_ctx;
+    vs->m = m;
+    vs->mlen = mlen;
+    vs->pk = pk;
+    vs->state = d->verify_state_bytes ? mem + head_len : NULL;
+    vs->sig = vs->state ? NULL : mem + head_len;
+    vs->siglen = 0;
+    vs->result = 0;
+
+    if (vs->state) {
+        d->verify_init(vs->state, m, mlen, pk, key_ctx ? key_ctx->scheme_ctx : NULL);
+    }
+    return vs;
+}
+
+struct dsa_verify_stream *dsa_verify_stream_new(enum DSA_ALGO algo,
+            const uint8_t *m, size_t mlen, const uint8_t *pk) {
+    const struct dsa_descriptor *d = dsa_get_descriptor(algo);
+    if (!d || !pk) {
+        return NULL;
+    }
+    return verify_stream_new(algo, d, NULL, m, mlen, pk);
+}
+
+struct dsa_verify_stream *dsa_key_ctx_verify_stream_new(
+            const struct dsa_key_ctx *key_ctx, const uint8_t *m, size_t mlen) {
+    if (!key_ctx || !key_ctx->pk) {
+        return NULL;
+    }
+    return verify_stream_new(key_ctx->algo, key_ctx->d, key_ctx, m, mlen, key_ctx->pk);
+}
+
+int dsa_verify_stream_update(struct dsa_verify_stream *vs,
+            const uint8_t *data, size_t len) {
+    if (!vs) {
+        return -1;
+    }
+    if (vs->state) {
+        return vs->d->verify_update(vs->state, data, len);
+    }
+    if (vs->result == 0 && len > vs->d->sig_len - vs->siglen) {
+        vs->result = -1; // Longer than any signature
+    }
+    if (vs->result == 0) {
+        memcpy(vs->sig + vs->siglen, data, len);
+        vs->siglen += len;
+    }
+    return vs->result;
+}
+
+// The work of a streamed verification is spread over the updates, so only
+// final goes through DSA_PROBE.
+int dsa_verify_stream_final(struct dsa_verify_stream *vs) {
+    if (!vs) {
+        return -1;
+    }
+    const struct dsa_descriptor *d = vs->d;
+    DSA_PROBE_BEGIN(probe);
+    int ret;
+    if (vs->state) {
+        ret = d->verify_final(vs->state);
+    } else if (vs->result != 0) {
+        ret = vs->result;
+    } else if (vs->key_ctx && vs->key_ctx->scheme_ctx) {
+        ret = d->verify_key_ctx(vs->sig, vs->siglen, vs->m, vs->mlen, vs->pk,
+                                vs->key_ctx->scheme_ctx);
+    } else {
+        ret = d->verify(vs->sig, vs->siglen, vs->m, vs->mlen, vs->pk);
+    }
+    DSA_PROBE_END(probe, vs->algo, DSA_OP_VERIFY, ret);
+    free(vs);
+    return ret;
+}
+
+void alloc_space_for_dsa(enum DSA_ALGO algo, uint8_t **pk, uint8_t **sk,
             size_t *pk_len, size_t *sk_len, size_t *sig_len) {
-    switch (algo) {
-        case FALCON_512:
-            *pk_len = PQCLEAN_FALCON512_CLEAN_CRYPTO_PUBLICKEYBYTES;
-            *sk_len = PQCLEAN_FALCON512_CLEAN_CRYPTO_SECRETKEYBYTES;
-            *sig_len = PQCLEAN_FALCON512_CLEAN_CRYPTO_BYTES;
-            break;
-        case FALCON_1024:
-            *pk_len = PQCLEAN_FALCON1024_CLEAN_CRYPTO_PUBLICKEYBYTES;
-            *sk_len = PQCLEAN_FALCON1024_CLEAN_CRYPTO_SECRETKEYBYTES;
-            *sig_len = PQCLEAN_FALCON1024_CLEAN_CRYPTO_BYTES;
-            break;
-        case FALCON_PADDED_512:
-            *pk_len = PQCLEAN_FALCONPADDED512_CLEAN_CRYPTO_PUBLICKEYBYTES;
-            *sk_len = PQCLEAN_FALCONPADDED512_CLEAN_CRYPTO_SECRETKEYBYTES;
-            *sig_len = PQCLEAN_FALCONPADDED512_CLEAN_CRYPTO_BYTES;
-            break;
-        case FALCON_PADDED_1024:
-            *pk_len = PQCLEAN_FALCONPADDED1024_CLEAN_CRYPTO_PUBLICKEYBYTES;
-            *sk_len = PQCLEAN_FALCONPADDED1024_CLEAN_CRYPTO_SECRETKEYBYTES;
-            *sig_len = PQCLEAN_FALCONPADDED1024_CLEAN_CRYPTO_BYTES;
-            break;
-        case ML_DSA_44:
-            *pk_len = PQCLEAN_MLDSA44_CLEAN_CRYPTO_PUBLICKEYBYTES;
-            *sk_len = PQCLEAN_MLDSA44_CLEAN_CRYPTO_SECRETKEYBYTES;
-            *sig_len = PQCLEAN_MLDSA44_CLEAN_CRYPTO_BYTES;
-            break;
-        case ML_DSA_65:
-            *pk_len = PQCLEAN_MLDSA65_CLEAN_CRYPTO_PUBLICKEYBYTES;
-            *sk_len = PQCLEAN_MLDSA65_CLEAN_CRYPTO_SECRETKEYBYTES;
-            *sig_len = PQCLEAN_MLDSA65_CLEAN_CRYPTO_BYTES;
-            break;
-        case ML_DSA_87:
-            *pk_len = PQCLEAN_MLDSA87_CLEAN_CRYPTO_PUBLICKEYBYTES;
-            *sk_len = PQCLEAN_MLDSA87_CLEAN_CRYPTO_SECRETKEYBYTES;
-            *sig_len = PQCLEAN_MLDSA87_CLEAN_CRYPTO_BYTES;
-            break;
-        case SPHINCS_SHA2_128F:
-            *pk_len = PQCLEAN_SPHINCSSHA2128FSIMPLE_CLEAN_CRYPTO_PUBLICKEYBYTES;
-            *sk_len = PQCLEAN_SPHINCSSHA2128FSIMPLE_CLEAN_CRYPTO_SECRETKEYBYTES;
-            *sig_len = PQCLEAN_SPHINCSSHA2128FSIMPLE_CLEAN_CRYPTO_BYTES;
-            break;
-        case SPHINCS_SHA2_128S:
-            *pk_len = PQCLEAN_SPHINCSSHA2128SSIMPLE_CLEAN_CRYPTO_PUBLICKEYBYTES;
-            *sk_len = PQCLEAN_SPHINCSSHA2128SSIMPLE_CLEAN_CRYPTO_SECRETKEYBYTES;
-            *sig_len = PQCLEAN_SPHINCSSHA2128SSIMPLE_CLEAN_CRYPTO_BYTES;
-            break;
-        case SPHINCS_SHA2_192F:
-            *pk_len = PQCLEAN_SPHINCSSHA2192FSIMPLE_CLEAN_CRYPTO_PUBLICKEYBYTES;
-            *sk_len = PQCLEAN_SPHINCSSHA2192FSIMPLE_CLEAN_CRYPTO_SECRETKEYBYTES;
-            *sig_len = PQCLEAN_SPHINCSSHA2192FSIMPLE_CLEAN_CRYPTO_BYTES;
-            break;
-        case SPHINCS_SHA2_192S:
-            *pk_len = PQCLEAN_SPHINCSSHA2192SSIMPLE_CLEAN_CRYPTO_PUBLICKEYBYTES;
-            *sk_len = PQCLEAN_SPHINCSSHA2192SSIMPLE_CLEAN_CRYPTO_SECRETKEYBYTES;
-            *sig_len = PQCLEAN_SPHINCSSHA2192SSIMPLE_CLEAN_CRYPTO_BYTES;
-            break;
-        case SPHINCS_SHA2_256F:
-            *pk_len = PQCLEAN_SPHINCSSHA2256FSIMPLE_CLEAN_CRYPTO_PUBLICKEYBYTES;
-            *sk_len = PQCLEAN_SPHINCSSHA2256FSIMPLE_CLEAN_CRYPTO_SECRETKEYBYTES;
-            *sig_len = PQCLEAN_SPHINCSSHA2256FSIMPLE_CLEAN_CRYPTO_BYTES;
-            break;
-        case SPHINCS_SHA2_256S:
-            *pk_len = PQCLEAN_SPHINCSSHA2256SSIMPLE_CLEAN_CRYPTO_PUBLICKEYBYTES;
-            *sk_len = PQCLEAN_SPHINCSSHA2256SSIMPLE_CLEAN_CRYPTO_SECRETKEYBYTES;
-            *sig_len = PQCLEAN_SPHINCSSHA2256SSIMPLE_CLEAN_CRYPTO_BYTES;
-            break;
-        case SPHINCS_SHAKE_128F:
-            *pk_len = PQCLEAN_SPHINCSSHAKE128FSIMPLE_CLEAN_CRYPTO_PUBLICKEYBYTES;
-            *sk_len = PQCLEAN_SPHINCSSHAKE128FSIMPLE_CLEAN_CRYPTO_SECRETKEYBYTES;
-            *sig_len = PQCLEAN_SPHINCSSHAKE128FSIMPLE_CLEAN_CRYPTO_BYTES;
-            break;
-        case SPHINCS_SHAKE_128S:
-            *pk_len = PQCLEAN_SPHINCSSHAKE128SSIMPLE_CLEAN_CRYPTO_PUBLICKEYBYTES;
-            *sk_len = PQCLEAN_SPHINCSSHAKE128SSIMPLE_CLEAN_CRYPTO_SECRETKEYBYTES;
-            *sig_len = PQCLEAN_SPHINCSSHAKE128SSIMPLE_CLEAN_CRYPTO_BYTES;
-            break;
-        case SPHINCS_SHAKE_192F:
-            *pk_len = PQCLEAN_SPHINCSSHAKE192FSIMPLE_CLEAN_CRYPTO_PUBLICKEYBYTES;
-            *sk_len = PQCLEAN_SPHINCSSHAKE192FSIMPLE_CLEAN_CRYPTO_SECRETKEYBYTES;
-            *sig_len = PQCLEAN_SPHINCSSHAKE192FSIMPLE_CLEAN_CRYPTO_BYTES;
-            break;
-        case SPHINCS_SHAKE_192S:
-            *pk_len = PQCLEAN_SPHINCSSHAKE192SSIMPLE_CLEAN_CRYPTO_PUBLICKEYBYTES;
-            *sk_len = PQCLEAN_SPHINCSSHAKE192SSIMPLE_CLEAN_CRYPTO_SECRETKEYBYTES;
-            *sig_len = PQCLEAN_SPHINCSSHAKE192SSIMPLE_CLEAN_CRYPTO_BYTES;
-            break;
-        case SPHINCS_SHAKE_256F:
-            *pk_len = PQCLEAN_SPHINCSSHAKE256FSIMPLE_CLEAN_CRYPTO_PUBLICKEYBYTES;
-            *sk_len = PQCLEAN_SPHINCSSHAKE256FSIMPLE_CLEAN_CRYPTO_SECRETKEYBYTES;
-            *sig_len = PQCLEAN_SPHINCSSHAKE256FSIMPLE_CLEAN_CRYPTO_BYTES;
-            break;
-        case SPHINCS_SHAKE_256S:
-            *pk_len = PQCLEAN_SPHINCSSHAKE256SSIMPLE_CLEAN_CRYPTO_PUBLICKEYBYTES;
-            *sk_len = PQCLEAN_SPHINCSSHAKE256SSIMPLE_CLEAN_CRYPTO_SECRETKEYBYTES;
-            *sig_len = PQCLEAN_SPHINCSSHAKE256SSIMPLE_CLEAN_CRYPTO_BYTES;
-            break;
-        default:
-            *pk_len = 0;
-            *sk_len = 0;
-            *sig_len = 0;
-            return; // Unsupported algorithm
+    const struct dsa_descriptor *d = dsa_get_descriptor(algo);
+    if (!d) {
+        *pk_len = 0;
+        *sk_len = 0;
+        *sig_len = 0;
+        return; // Unsupported algorithm
     }
+    *pk_len = d->pk_len;
+    *sk_len = d->sk_len;
+    *sig_len = d->sig_len;
     *pk = (uint8_t *)malloc(*pk_len);
     *sk = (uint8_t *)malloc(*sk_len);
 }
@@ -372,138 +611,18 @@ void free_space_for_dsa(uint8_t *pk, uint8_t *sk) {
 }
 
 size_t get_public_key_length(enum DSA_ALGO algo) {
-    switch (algo) {
-        case FALCON_512:
-            return PQCLEAN_FALCON512_CLEAN_CRYPTO_PUBLICKEYBYTES;
-        case FALCON_1024:
-            return PQCLEAN_FALCON1024_CLEAN_CRYPTO_PUBLICKEYBYTES;
-        case FALCON_PADDED_512:
-            return PQCLEAN_FALCONPADDED512_CLEAN_CRYPTO_PUBLICKEYBYTES;
-        case FALCON_PADDED_1024:
-            return PQCLEAN_FALCONPADDED1024_CLEAN_CRYPTO_PUBLICKEYBYTES;
-        case ML_DSA_44:
-            return PQCLEAN_MLDSA44_CLEAN_CRYPTO_PUBLICKEYBYTES;
-        case ML_DSA_65:
-            return PQCLEAN_MLDSA65_CLEAN_CRYPTO_PUBLICKEYBYTES;
-        case ML_DSA_87:
-            return PQCLEAN_MLDSA87_CLEAN_CRYPTO_PUBLICKEYBYTES;
-        case SPHINCS_SHA2_128F:
-            return PQCLEAN_SPHINCSSHA2128FSIMPLE_CLEAN_CRYPTO_PUBLICKEYBYTES;
-        case SPHINCS_SHA2_128S:
-            return PQCLEAN_SPHINCSSHA2128SSIMPLE_CLEAN_CRYPTO_PUBLICKEYBYTES;
-        case SPHINCS_SHA2_192F:
-            return PQCLEAN_SPHINCSSHA2192FSIMPLE_CLEAN_CRYPTO_PUBLICKEYBYTES;
-        case SPHINCS_SHA2_192S:
-            return PQCLEAN_SPHINCSSHA2192SSIMPLE_CLEAN_CRYPTO_PUBLICKEYBYTES;
-        case SPHINCS_SHA2_256F:
-            return PQCLEAN_SPHINCSSHA2256FSIMPLE_CLEAN_CRYPTO_PUBLICKEYBYTES;
-        case SPHINCS_SHA2_256S:
-            return PQCLEAN_SPHINCSSHA2256SSIMPLE_CLEAN_CRYPTO_PUBLICKEYBYTES;
-        case SPHINCS_SHAKE_128F:
-            return PQCLEAN_SPHINCSSHAKE128FSIMPLE_CLEAN_CRYPTO_PUBLICKEYBYTES;
-        case SPHINCS_SHAKE_128S:
-            return PQCLEAN_SPHINCSSHAKE128SSIMPLE_CLEAN_CRYPTO_PUBLICKEYBYTES;
-        case SPHINCS_SHAKE_192F:
-            return PQCLEAN_SPHINCSSHAKE192FSIMPLE_CLEAN_CRYPTO_PUBLICKEYBYTES;
-        case SPHINCS_SHAKE_192S:
-            return PQCLEAN_SPHINCSSHAKE192SSIMPLE_CLEAN_CRYPTO_PUBLICKEYBYTES;
-        case SPHINCS_SHAKE_256F:
-            return PQCLEAN_SPHINCSSHAKE256FSIMPLE_CLEAN_CRYPTO_PUBLICKEYBYTES;
-        case SPHINCS_SHAKE_256S:
-            return PQCLEAN_SPHINCSSHAKE256SSIMPLE_CLEAN_CRYPTO_PUBLICKEYBYTES;
-        default:
-            return 0; // Unsupported algorithm
-    }
+    const struct dsa_descriptor *d = dsa_get_descriptor(algo);
+    return d ? d->pk_len : 0;
 }
 
 size_t get_secret_key_length(enum DSA_ALGO algo) {
-    switch (algo) {
-        case FALCON_512:
-            return PQCLEAN_FALCON512_CLEAN_CRYPTO_SECRETKEYBYTES;
-        case FALCON_1024:
-            return PQCLEAN_FALCON1024_CLEAN_CRYPTO_SECRETKEYBYTES;
-        case FALCON_PADDED_512:
-            return PQCLEAN_FALCONPADDED512_CLEAN_CRYPTO_SECRETKEYBYTES;
-        case FALCON_PADDED_1024:
-            return PQCLEAN_FALCONPADDED1024_CLEAN_CRYPTO_SECRETKEYBYTES;
-        case ML_DSA_44:
-            return PQCLEAN_MLDSA44_CLEAN_CRYPTO_SECRETKEYBYTES;
-        case ML_DSA_65:
-            return PQCLEAN_MLDSA65_CLEAN_CRYPTO_SECRETKEYBYTES;
-        case ML_DSA_87:
-            return PQCLEAN_MLDSA87_CLEAN_CRYPTO_SECRETKEYBYTES;
-        case SPHINCS_SHA2_128F:
-            return PQCLEAN_SPHINCSSHA2128FSIMPLE_CLEAN_CRYPTO_SECRETKEYBYTES;
-        case SPHINCS_SHA2_128S:
-            return PQCLEAN_SPHINCSSHA2128SSIMPLE_CLEAN_CRYPTO_SECRETKEYBYTES;
-        case SPHINCS_SHA2_192F:
-            return PQCLEAN_SPHINCSSHA2192FSIMPLE_CLEAN_CRYPTO_SECRETKEYBYTES;
-        case SPHINCS_SHA2_192S:
-            return PQCLEAN_SPHINCSSHA2192SSIMPLE_CLEAN_CRYPTO_SECRETKEYBYTES;
-        case SPHINCS_SHA2_256F:
-            return PQCLEAN_SPHINCSSHA2256FSIMPLE_CLEAN_CRYPTO_SECRETKEYBYTES;
-        case SPHINCS_SHA2_256S:
-            return PQCLEAN_SPHINCSSHA2256SSIMPLE_CLEAN_CRYPTO_SECRETKEYBYTES;
-        case SPHINCS_SHAKE_128F:
-            return PQCLEAN_SPHINCSSHAKE128FSIMPLE_CLEAN_CRYPTO_SECRETKEYBYTES;
-        case SPHINCS_SHAKE_128S:
-            return PQCLEAN_SPHINCSSHAKE128SSIMPLE_CLEAN_CRYPTO_SECRETKEYBYTES;
-        case SPHINCS_SHAKE_192F:
-            return PQCLEAN_SPHINCSSHAKE192FSIMPLE_CLEAN_CRYPTO_SECRETKEYBYTES;
-        case SPHINCS_SHAKE_192S:
-            return PQCLEAN_SPHINCSSHAKE192SSIMPLE_CLEAN_CRYPTO_SECRETKEYBYTES;
-        case SPHINCS_SHAKE_256F:
-            return PQCLEAN_SPHINCSSHAKE256FSIMPLE_CLEAN_CRYPTO_SECRETKEYBYTES;
-        case SPHINCS_SHAKE_256S:
-            return PQCLEAN_SPHINCSSHAKE256SSIMPLE_CLEAN_CRYPTO_SECRETKEYBYTES;
-        default:
-            return 0; // Unsupported algorithm
-    }
+    const struct dsa_descriptor *d = dsa_get_descriptor(algo);
+    return d ? d->sk_len : 0;
 }
 
 size_t get_signature_length(enum DSA_ALGO algo) {
-    switch (algo) {
-        case FALCON_512:
-            return PQCLEAN_FALCON512_CLEAN_CRYPTO_BYTES;
-        case FALCON_1024:
-            return PQCLEAN_FALCON1024_CLEAN_CRYPTO_BYTES;
-        case FALCON_PADDED_512:
-            return PQCLEAN_FALCONPADDED512_CLEAN_CRYPTO_BYTES;
-        case FALCON_PADDED_1024:
-            return PQCLEAN_FALCONPADDED1024_CLEAN_CRYPTO_BYTES;
-        case ML_DSA_44:
-            return PQCLEAN_MLDSA44_CLEAN_CRYPTO_BYTES;
-        case ML_DSA_65:
-            return PQCLEAN_MLDSA65_CLEAN_CRYPTO_BYTES;
-        case ML_DSA_87:
-            return PQCLEAN_MLDSA87_CLEAN_CRYPTO_BYTES;
-        case SPHINCS_SHA2_128F:
-            return PQCLEAN_SPHINCSSHA2128FSIMPLE_CLEAN_CRYPTO_BYTES;
-        case SPHINCS_SHA2_128S:
-            return PQCLEAN_SPHINCSSHA2128SSIMPLE_CLEAN_CRYPTO_BYTES;
-        case SPHINCS_SHA2_192F:
-            return PQCLEAN_SPHINCSSHA2192FSIMPLE_CLEAN_CRYPTO_BYTES;
-        case SPHINCS_SHA2_192S:
-            return PQCLEAN_SPHINCSSHA2192SSIMPLE_CLEAN_CRYPTO_BYTES;
-        case SPHINCS_SHA2_256F:
-            return PQCLEAN_SPHINCSSHA2256FSIMPLE_CLEAN_CRYPTO_BYTES;
-        case SPHINCS_SHA2_256S:
-            return PQCLEAN_SPHINCSSHA2256SSIMPLE_CLEAN_CRYPTO_BYTES;
-        case SPHINCS_SHAKE_128F:
-            return PQCLEAN_SPHINCSSHAKE128FSIMPLE_CLEAN_CRYPTO_BYTES;
-        case SPHINCS_SHAKE_128S:
-            return PQCLEAN_SPHINCSSHAKE128SSIMPLE_CLEAN_CRYPTO_BYTES;
-        case SPHINCS_SHAKE_192F:
-            return PQCLEAN_SPHINCSSHAKE192FSIMPLE_CLEAN_CRYPTO_BYTES;
-        case SPHINCS_SHAKE_192S:
-            return PQCLEAN_SPHINCSSHAKE192SSIMPLE_CLEAN_CRYPTO_BYTES;
-        case SPHINCS_SHAKE_256F:
-            return PQCLEAN_SPHINCSSHAKE256FSIMPLE_CLEAN_CRYPTO_BYTES;
-        case SPHINCS_SHAKE_256S:
-            return PQCLEAN_SPHINCSSHAKE256SSIMPLE_CLEAN_CRYPTO_BYTES;
-        default:
-            return 0; // Unsupported algorithm
-    }
+    const struct dsa_descriptor *d = dsa_get_descriptor(algo);
+    return d ? d->sig_len : 0;
 }
 
 bool test_dsa(enum DSA_ALGO algo) {
@@ -576,35 +695,19 @@ bool test_dsa(enum DSA_ALGO algo) {
 }
 
 void test_all_dsa() {
-    enum DSA_ALGO algorithms[] = {
-        FALCON_512,
-        FALCON_1024,
-        FALCON_PADDED_512,
-        FALCON_PADDED_1024,
-        ML_DSA_44,
-        ML_DSA_65,
-        ML_DSA_87,
-        SPHINCS_SHA2_128F,
-        SPHINCS_SHA2_128S,
-        SPHINCS_SHA2_192F,
-        SPHINCS_SHA2_192S,
-        SPHINCS_SHA2_256F,
-        SPHINCS_SHA2_256S,
-        SPHINCS_SHAKE_128F,
-        SPHINCS_SHAKE_128S,
-        SPHINCS_SHAKE_192F,
-        SPHINCS_SHAKE_192S,
-        SPHINCS_SHAKE_256F,
-        SPHINCS_SHAKE_256S
-    };
-    size_t num_algorithms = sizeof(algorithms) / sizeof(algorithms[0]);
-
-    for (size_t i = 0; i < num_algorithms; i++) {
-        if (test_dsa(algorithms[i])) {
-            printf("DSA algorithm %s passed the test.\n", getAlgoName(algorithms[i]));
+    for (int i = 0; i < DSA_ALGO_COUNT; i++) {
+        enum DSA_ALGO algo = (enum DSA_ALGO)i;
+        if (!dsa_get_descriptor(algo)) {
+            continue;
+        }
+        if (test_dsa(algo)) {
+            printf("DSA algorithm %s passed the test.\n", getAlgoName(algo));
         } else {
-            printf("DSA algorithm %s failed the test.\n", getAlgoName(algorithms[i]));
+            printf("DSA algorithm %s failed the test.\n", getAlgoName(algo));
         }
     }
+#ifdef CONFIG_DSA_INSTRUMENTATION
+    dsa_stats_dump_csv(stdout);
+#endif
     printf("All Algo done\n");
-}
\ No newline at end of file
+}
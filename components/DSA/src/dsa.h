@@ -1,28 +1,75 @@
 #ifndef DSA_H
 #define DSA_H
 
+#include "dsa_config.h"
+
+#ifdef CONFIG_DSA_FALCON_512
 #include "falcon-512/api.h"
+#endif
+#ifdef CONFIG_DSA_FALCON_1024
 #include "falcon-1024/api.h"
+#endif
+#ifdef CONFIG_DSA_FALCON_PADDED_512
 #include "falcon-padded-512/api.h"
+#endif
+#ifdef CONFIG_DSA_FALCON_PADDED_1024
 #include "falcon-padded-1024/api.h"
+#endif
+#ifdef CONFIG_DSA_ML_DSA_44
 #include "ml-dsa-44/api.h"
+#endif
+#ifdef CONFIG_DSA_ML_DSA_65
 #include "ml-dsa-65/api.h"
+#endif
+#ifdef CONFIG_DSA_ML_DSA_87
 #include "ml-dsa-87/api.h"
+#endif
+#ifdef CONFIG_DSA_SPHINCS_SHA2_128F
 #include "sphincs-sha2-128f/api.h"
+#endif
+#ifdef CONFIG_DSA_SPHINCS_SHA2_128S
 #include "sphincs-sha2-128s/api.h"
+#endif
+#ifdef CONFIG_DSA_SPHINCS_SHA2_192F
 #include "sphincs-sha2-192f/api.h"
+#endif
+#ifdef CONFIG_DSA_SPHINCS_SHA2_192S
 #include "sphincs-sha2-192s/api.h"
+#endif
+#ifdef CONFIG_DSA_SPHINCS_SHA2_256F
 #include "sphincs-sha2-256f/api.h"
+#endif
+#ifdef CONFIG_DSA_SPHINCS_SHA2_256S
 #include "sphincs-sha2-256s/api.h"
+#endif
+#ifdef CONFIG_DSA_SPHINCS_SHAKE_128F
 #include "sphincs-shake-128f/api.h"
+#endif
+#ifdef CONFIG_DSA_SPHINCS_SHAKE_128S
 #include "sphincs-shake-128s/api.h"
+#endif
+#ifdef CONFIG_DSA_SPHINCS_SHAKE_192F
 #include "sphincs-shake-192f/api.h"
+#endif
+#ifdef CONFIG_DSA_SPHINCS_SHAKE_192S
 #include "sphincs-shake-192s/api.h"
+#endif
+#ifdef CONFIG_DSA_SPHINCS_SHAKE_256F
 #include "sphincs-shake-256f/api.h"
+#endif
+#ifdef CONFIG_DSA_SPHINCS_SHAKE_256S
 #include "sphincs-shake-256s/api.h"
+#endif
 
 #include <stdbool.h>
 
+// Receives a signature piece by piece from dsa_signature_stream(), in order.
+// A non-zero return stops signing and is passed on to the caller.
+typedef int (*dsa_sink_fn)(void *arg, const uint8_t *data, size_t len);
+
+// The enum always lists every parameter set so that values stay the same
+// whatever the build selects; use dsa_get_descriptor() to find out whether
+// one is compiled in.
 enum DSA_ALGO {
     FALCON_512,
     FALCON_1024,
@@ -42,9 +89,88 @@ enum DSA_ALGO {
     SPHINCS_SHAKE_192F,
     SPHINCS_SHAKE_192S,
     SPHINCS_SHAKE_256F,
-    SPHINCS_SHAKE_256S
+    SPHINCS_SHAKE_256S,
+    DSA_ALGO_COUNT // Number of algorithms, not an algorithm
+};
+
+enum DSA_OP {
+    DSA_OP_KEYGEN,
+    DSA_OP_SIGN,
+    DSA_OP_VERIFY,
+    DSA_OP_COUNT
+};
+
+// Everything the dispatch layer knows about one parameter set. The table in
+// dsa.c is indexed by enum DSA_ALGO, so adding a scheme means adding one row.
+struct dsa_descriptor {
+    const char *name;
+    size_t pk_len;
+    size_t sk_len;
+    size_t sig_len;
+    // Peak stack and transient heap of each operation, in bytes, indexed by
+    // enum DSA_OP. Used to size the tasks that run the operations.
+    size_t stack_bytes[DSA_OP_COUNT];
+    size_t heap_bytes[DSA_OP_COUNT];
+    // Peak stack of dsa_signature_stream() (DSA_OP_SIGN) and of a streaming
+    // verification, dsa_verify_stream_new() to final (DSA_OP_VERIFY). There
+    // is no streaming keygen; its entry is 0.
+    size_t stack_stream_bytes[DSA_OP_COUNT];
+    int (*keypair)(uint8_t *pk, uint8_t *sk);
+    int (*sign)(uint8_t *sm, size_t *smlen,
+                const uint8_t *m, size_t mlen, const uint8_t *sk);
+    int (*signature)(uint8_t *sig, size_t *siglen,
+                const uint8_t *m, size_t mlen, const uint8_t *sk);
+    int (*verify)(const uint8_t *sig, size_t siglen,
+                const uint8_t *m, size_t mlen, const uint8_t *pk);
+    int (*open)(uint8_t *m, size_t *mlen,
+                const uint8_t *sm, size_t smlen, const uint8_t *pk);
+    // Variants taking their large temporaries from a caller workspace, and
+    // the workspace size each needs, indexed by enum DSA_OP. NULL for schemes
+    // whose temporaries are already small (SPHINCS+). stack_ws_bytes is the
+    // peak stack of an operation when it runs through dsa_*_ws().
+    size_t (*ws_bytes[DSA_OP_COUNT])(void);
+    size_t stack_ws_bytes[DSA_OP_COUNT];
+    int (*keypair_ws)(uint8_t *pk, uint8_t *sk, void *ws);
+    int (*signature_ws)(uint8_t *sig, size_t *siglen,
+                const uint8_t *m, size_t mlen, const uint8_t *sk, void *ws);
+    int (*verify_ws)(const uint8_t *sig, size_t siglen,
+                const uint8_t *m, size_t mlen, const uint8_t *pk, void *ws);
+    // Signing cache of one key, see dsa_sign_cache_init(). NULL for schemes
+    // without one (all but SPHINCS+).
+    size_t (*sign_cache_bytes)(void);
+    int (*sign_cache_init)(uint8_t *cache, const uint8_t *sk);
+    int (*signature_cached)(uint8_t *sig, size_t *siglen,
+                const uint8_t *m, size_t mlen, const uint8_t *sk,
+                const uint8_t *cache);
+    // Key context, see dsa_key_ctx_new(). NULL for schemes without one
+    // (Falcon).
+    size_t (*key_ctx_bytes)(void);
+    int (*key_ctx_init)(void *key_ctx, const uint8_t *pk, const uint8_t *sk);
+    void (*key_ctx_release)(void *key_ctx);
+    int (*signature_key_ctx)(uint8_t *sig, size_t *siglen,
+                const uint8_t *m, size_t mlen, const uint8_t *sk,
+                const void *key_ctx, const uint8_t *cache);
+    int (*verify_key_ctx)(const uint8_t *sig, size_t siglen,
+                const uint8_t *m, size_t mlen, const uint8_t *pk,
+                const void *key_ctx);
+    // Streaming signature, see dsa_signature_stream(). NULL for schemes
+    // without one (all but SPHINCS+). key_ctx and cache may be NULL.
+    int (*signature_stream)(const uint8_t *m, size_t mlen, const uint8_t *sk,
+                const void *key_ctx, const uint8_t *cache,
+                dsa_sink_fn sink, void *arg);
+    // Incremental verification, see dsa_verify_stream_new(). NULL for schemes
+    // without one (all but SPHINCS+). key_ctx may be NULL.
+    size_t (*verify_state_bytes)(void);
+    void (*verify_init)(void *state, const uint8_t *m, size_t mlen,
+                const uint8_t *pk, const void *key_ctx);
+    int (*verify_update)(void *state, const uint8_t *data, size_t len);
+    int (*verify_final)(void *state);
 };
 
+// Returns NULL for values outside enum DSA_ALGO and for parameter sets that
+// are disabled in the build configuration.
+const struct dsa_descriptor *dsa_get_descriptor(enum DSA_ALGO algo);
+
 const char* getAlgoName(enum DSA_ALGO algo);
 
 int dsa_keygen(enum DSA_ALGO algo, 
@@ -70,6 +196,135 @@ int dsa_open(enum DSA_ALGO algo,
             const uint8_t *sm, size_t smlen,
             const uint8_t *pk);
 
+// Workspace API: the same operations as dsa_keygen(), dsa_signature() and
+// dsa_verify(), but the large temporaries live in `ws` rather than on the
+// calling task's stack, so one heap arena can be shared by several tasks
+// with small stacks (one operation at a time per arena). `ws` must be
+// aligned on DSA_WORKSPACE_ALIGN bytes and hold dsa_workspace_size(algo, op)
+// bytes; the functions return -1 otherwise. A size of 0 means the parameter
+// set needs no workspace, and `ws` may then be NULL.
+#define DSA_WORKSPACE_ALIGN 8
+
+size_t dsa_workspace_size(enum DSA_ALGO algo, enum DSA_OP op);
+
+int dsa_keygen_ws(enum DSA_ALGO algo,
+            uint8_t *pk, uint8_t *sk,
+            void *ws, size_t ws_len);
+
+int dsa_signature_ws(enum DSA_ALGO algo,
+            uint8_t *sig, size_t *siglen,
+            const uint8_t *m, size_t mlen,
+            const uint8_t *sk,
+            void *ws, size_t ws_len);
+
+int dsa_verify_ws(enum DSA_ALGO algo,
+            const uint8_t *sig, size_t siglen,
+            const uint8_t *m, size_t mlen,
+            const uint8_t *pk,
+            void *ws, size_t ws_len);
+
+// Signing cache: the part of every signature that depends on the key alone,
+// computed once per key. dsa_sign_cache_init() fills `cache` for `sk`, and
+// dsa_signature_cached() then signs with `sk` reading it instead of
+// recomputing that part; the signatures are the same as dsa_signature()'s.
+// `cache` must hold dsa_sign_cache_size(algo) bytes; the functions return
+// -1 otherwise, and dsa_sign_cache_init() also if `sk` is inconsistent.
+// Only SPHINCS+ has a cache (the nodes of its top hypertree layer, from a
+// few hundred bytes for the f sets to 16-32 KiB for the s sets); for the
+// other schemes the size is 0, `cache` may be NULL, and
+// dsa_signature_cached() is dsa_signature().
+size_t dsa_sign_cache_size(enum DSA_ALGO algo);
+
+int dsa_sign_cache_init(enum DSA_ALGO algo,
+            void *cache, size_t cache_len,
+            const uint8_t *sk);
+
+int dsa_signature_cached(enum DSA_ALGO algo,
+            uint8_t *sig, size_t *siglen,
+            const uint8_t *m, size_t mlen,
+            const uint8_t *sk,
+            const void *cache, size_t cache_len);
+
+// Key context: a key loaded once for many signatures or verifications. It
+// keeps what the scheme derives from the key before hashing any message
+// (for SPHINCS+, the seeds and the SHA-256 midstate of the public seed that
+// every call otherwise sets up again; for ML-DSA, the matrix A expanded from
+// rho, the NTT-domain s1, s2 and t0 and NTT(t1 * 2^d), which take most of a
+// signature or verification to derive and make the context 32 to 87 KB)
+// and, if `sign_cache` is set, the signing cache of dsa_sign_cache_init().
+// `pk` and `sk` are not copied and must stay valid until dsa_key_ctx_free();
+// `sk` may be NULL for a context that only verifies, and `pk` for one that
+// only signs. Schemes with nothing to prepare (Falcon) simply go through
+// dsa_signature() and dsa_verify().
+// dsa_key_ctx_new() returns NULL if the algorithm is unsupported, there is
+// no memory, the signing cache does not match `sk`, or, for ML-DSA and
+// SPHINCS+, `pk` and `sk` are both given but the public values held in
+// `sk` differ from `pk` (what the context derives from one key serves the
+// other); Falcon takes any pair. The other functions return -1 if the
+// context lacks the key they need.
+struct dsa_key_ctx;
+
+struct dsa_key_ctx *dsa_key_ctx_new(enum DSA_ALGO algo,
+            const uint8_t *pk, const uint8_t *sk,
+            bool sign_cache);
+
+void dsa_key_ctx_free(struct dsa_key_ctx *key_ctx);
+
+int dsa_key_ctx_signature(const struct dsa_key_ctx *key_ctx,
+            uint8_t *sig, size_t *siglen,
+            const uint8_t *m, size_t mlen);
+
+int dsa_key_ctx_verify(const struct dsa_key_ctx *key_ctx,
+            const uint8_t *sig, size_t siglen,
+            const uint8_t *m, size_t mlen);
+
+// Streaming signature: the signature of dsa_signature(), handed to `sink` in
+// order as it is computed rather than written to one buffer, so that it can
+// go out on the transport while the rest is being computed. SPHINCS+ hands
+// over R, then each FORS tree, then each hypertree layer, and never holds
+// more than one layer (at most 2.4 KB, for the 256f sets) instead of the
+// whole signature (up to 49 KB). The other schemes sign into a heap buffer
+// of the signature size and hand it over in one piece. Returns -1 if the
+// algorithm is unsupported or that buffer cannot be allocated, the first
+// non-zero value of `sink`, or the result of signing. SPHINCS+ signs on the
+// calling task here, without the second core of CONFIG_DSA_SPHINCS_PARALLEL.
+int dsa_signature_stream(enum DSA_ALGO algo,
+            const uint8_t *m, size_t mlen,
+            const uint8_t *sk,
+            dsa_sink_fn sink, void *arg);
+
+int dsa_key_ctx_signature_stream(const struct dsa_key_ctx *key_ctx,
+            const uint8_t *m, size_t mlen,
+            dsa_sink_fn sink, void *arg);
+
+// Streaming verification, the other end of dsa_signature_stream(): the
+// signature is fed to dsa_verify_stream_update() in order, in pieces of any
+// size, as it comes in, and dsa_verify_stream_final() returns what
+// dsa_verify() would have and frees the stream. SPHINCS+ folds each FORS
+// tree and hypertree layer into a running root as soon as it is complete,
+// so the stream holds at most one layer instead of the whole signature. The
+// other schemes gather the signature in a heap buffer of the signature size
+// and verify it in final. `m` and `pk` (or `key_ctx`) are not copied and
+// must stay valid until final. dsa_verify_stream_new() returns NULL if the
+// algorithm is unsupported or there is no memory; update returns -1 once
+// the signature is known to be bad (for SPHINCS+ if it is too long or if
+// the root of the last hypertree layer does not match the public key),
+// which is then also the result of final.
+struct dsa_verify_stream;
+
+struct dsa_verify_stream *dsa_verify_stream_new(enum DSA_ALGO algo,
+            const uint8_t *m, size_t mlen,
+            const uint8_t *pk);
+
+struct dsa_verify_stream *dsa_key_ctx_verify_stream_new(
+            const struct dsa_key_ctx *key_ctx,
+            const uint8_t *m, size_t mlen);
+
+int dsa_verify_stream_update(struct dsa_verify_stream *vs,
+            const uint8_t *data, size_t len);
+
+int dsa_verify_stream_final(struct dsa_verify_stream *vs);
+
 void alloc_space_for_dsa(enum DSA_ALGO algo,
             uint8_t **pk, uint8_t **sig,
             size_t *pk_len, size_t *sk_len, size_t *sig_len);
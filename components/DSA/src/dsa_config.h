@@ -0,0 +1,33 @@
+#ifndef DSA_CONFIG_H
+#define DSA_CONFIG_H
+
+// Which parameter sets are compiled in. ESP-IDF builds take the selection
+// from menuconfig (components/DSA/Kconfig); other builds either pass the
+// CONFIG_DSA_* macros themselves and define DSA_CONFIG_EXTERNAL, or get
+// every parameter set.
+
+#if defined(ESP_PLATFORM)
+#include "sdkconfig.h"
+#elif !defined(DSA_CONFIG_EXTERNAL)
+#define CONFIG_DSA_FALCON_512 1
+#define CONFIG_DSA_FALCON_1024 1
+#define CONFIG_DSA_FALCON_PADDED_512 1
+#define CONFIG_DSA_FALCON_PADDED_1024 1
+#define CONFIG_DSA_ML_DSA_44 1
+#define CONFIG_DSA_ML_DSA_65 1
+#define CONFIG_DSA_ML_DSA_87 1
+#define CONFIG_DSA_SPHINCS_SHA2_128F 1
+#define CONFIG_DSA_SPHINCS_SHA2_128S 1
+#define CONFIG_DSA_SPHINCS_SHA2_192F 1
+#define CONFIG_DSA_SPHINCS_SHA2_192S 1
+#define CONFIG_DSA_SPHINCS_SHA2_256F 1
+#define CONFIG_DSA_SPHINCS_SHA2_256S 1
+#define CONFIG_DSA_SPHINCS_SHAKE_128F 1
+#define CONFIG_DSA_SPHINCS_SHAKE_128S 1
+#define CONFIG_DSA_SPHINCS_SHAKE_192F 1
+#define CONFIG_DSA_SPHINCS_SHAKE_192S 1
+#define CONFIG_DSA_SPHINCS_SHAKE_256F 1
+#define CONFIG_DSA_SPHINCS_SHAKE_256S 1
+#endif
+
+#endif // DSA_CONFIG_H
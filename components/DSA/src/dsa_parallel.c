@@ -0,0 +1,77 @@
+#include "dsa_parallel.h"
+
+#if defined(ESP_PLATFORM)
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#else
+#include <pthread.h>
+#endif
+
+struct parallel_job {
+    void (*worker)(void *arg);
+    void *arg;
+#if defined(ESP_PLATFORM)
+    SemaphoreHandle_t done;
+#endif
+};
+
+uint32_t dsa_parallel_next(uint32_t *next) {
+    return __atomic_fetch_add(next, 1, __ATOMIC_RELAXED);
+}
+
+#if defined(ESP_PLATFORM)
+static void helper_task(void *param) {
+    struct parallel_job *job = param;
+
+    job->worker(job->arg);
+    xSemaphoreGive(job->done);
+    vTaskDelete(NULL);
+}
+
+void dsa_parallel_run(void (*worker)(void *arg), void *arg) {
+    StaticSemaphore_t done_buffer;
+    struct parallel_job job = { worker, arg, NULL };
+    BaseType_t started;
+
+    job.done = xSemaphoreCreateBinaryStatic(&done_buffer);
+
+    // Same priority as the caller, on whichever core the caller is not on.
+    started = xTaskCreatePinnedToCore(helper_task, "dsa_parallel",
+                                      CONFIG_DSA_PARALLEL_STACK_SIZE, &job,
+                                      uxTaskPriorityGet(NULL), NULL,
+                                      xPortGetCoreID() == 0 ? 1 : 0);
+
+    worker(arg);
+
+    if (started == pdPASS) {
+        xSemaphoreTake(job.done, portMAX_DELAY);
+    }
+    vSemaphoreDelete(job.done);
+}
+#else
+static void *helper_thread(void *param) {
+    struct parallel_job *job = param;
+
+    job->worker(job->arg);
+    return NULL;
+}
+
+void dsa_parallel_run(void (*worker)(void *arg), void *arg) {
+    struct parallel_job job = { worker, arg };
+    pthread_attr_t attr;
+    pthread_t thread;
+    int started;
+
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, CONFIG_DSA_PARALLEL_STACK_SIZE);
+    started = pthread_create(&thread, &attr, helper_thread, &job) == 0;
+    pthread_attr_destroy(&attr);
+
+    worker(arg);
+
+    if (started) {
+        pthread_join(thread, NULL);
+    }
+}
+#endif
@@ -0,0 +1,35 @@
+#ifndef DSA_PARALLEL_H
+#define DSA_PARALLEL_H
+
+#include "dsa_config.h"
+
+#include <stdint.h>
+
+// Stack of the helper task that dsa_parallel_run() starts, in bytes. It runs
+// a share of the SPHINCS+ signing work (FORS and Merkle tree builds), which
+// needs less than the full signing budget in dsa_stack_budget.h.
+#ifndef CONFIG_DSA_PARALLEL_STACK_SIZE
+#define CONFIG_DSA_PARALLEL_STACK_SIZE 16384
+#endif
+
+// Transient heap taken by dsa_parallel_run() for the helper's stack and task
+// control block, for the heap figures in dsa.c.
+#ifdef CONFIG_DSA_SPHINCS_PARALLEL
+#define DSA_PARALLEL_HEAP_BYTES (CONFIG_DSA_PARALLEL_STACK_SIZE + 512)
+#else
+#define DSA_PARALLEL_HEAP_BYTES 0
+#endif
+
+// Runs worker(arg) on the calling task and, at the same time, on a helper
+// task pinned to the other core (a thread on hosts), and returns once both
+// copies have returned. The worker must take its work items from a counter
+// in arg through dsa_parallel_next(), so that any item is done exactly once
+// however the two copies interleave; if the helper cannot be started, the
+// caller's copy simply does everything.
+void dsa_parallel_run(void (*worker)(void *arg), void *arg);
+
+// Returns *next and increments it, atomically with respect to the other
+// copy of the worker.
+uint32_t dsa_parallel_next(uint32_t *next);
+
+#endif // DSA_PARALLEL_H
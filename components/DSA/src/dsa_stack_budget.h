@@ -0,0 +1,11 @@
+// Stack budgets of the target, see dsa_stack_profile_header(). Replace this
+// file with the header printed by the test application in
+// CONFIG_STACK_PROFILE_MODE to size tasks from measurements on the ESP32.
+// Until then every parameter set uses the host estimates of
+// dsa_stack_budget_host.h.
+#ifndef DSA_STACK_BUDGET_H
+#define DSA_STACK_BUDGET_H
+
+#include "dsa_stack_budget_host.h"
+
+#endif // DSA_STACK_BUDGET_H
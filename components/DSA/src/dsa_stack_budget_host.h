@@ -0,0 +1,204 @@
+// Generated by dsa_stack_profile_header(); do not edit by hand.
+// Target: x86_64 host, 3 runs per operation.
+//
+// Peak stack in bytes of keygen, signature and verify of each parameter set,
+// rounded up to 256 bytes. The _WS figures are for dsa_*_ws(), with the
+// temporaries in a caller workspace, and the _STREAM ones for
+// dsa_signature_stream() and dsa_verify_stream_*().
+// Measured on the host, not on the ESP32: these are estimates, used for every
+// parameter set that dsa_stack_budget.h has not profiled on the target.
+#ifndef DSA_STACK_BUDGET_HOST_H
+#define DSA_STACK_BUDGET_HOST_H
+
+#ifndef DSA_STACK_BUDGET_FALCON_512_KEYGEN
+#define DSA_STACK_BUDGET_FALCON_512_KEYGEN 21248
+#define DSA_STACK_BUDGET_FALCON_512_SIGN 44800
+#define DSA_STACK_BUDGET_FALCON_512_VERIFY 5120
+#define DSA_STACK_BUDGET_FALCON_512_KEYGEN_WS 1792
+#define DSA_STACK_BUDGET_FALCON_512_SIGN_WS 3840
+#define DSA_STACK_BUDGET_FALCON_512_VERIFY_WS 1024
+#define DSA_STACK_BUDGET_FALCON_512_SIGN_STREAM 44800
+#define DSA_STACK_BUDGET_FALCON_512_VERIFY_STREAM 5120
+#endif
+#ifndef DSA_STACK_BUDGET_FALCON_1024_KEYGEN
+#define DSA_STACK_BUDGET_FALCON_1024_KEYGEN 35584
+#define DSA_STACK_BUDGET_FALCON_1024_SIGN 85760
+#define DSA_STACK_BUDGET_FALCON_1024_VERIFY 9216
+#define DSA_STACK_BUDGET_FALCON_1024_KEYGEN_WS 1792
+#define DSA_STACK_BUDGET_FALCON_1024_SIGN_WS 3840
+#define DSA_STACK_BUDGET_FALCON_1024_VERIFY_WS 1024
+#define DSA_STACK_BUDGET_FALCON_1024_SIGN_STREAM 86016
+#define DSA_STACK_BUDGET_FALCON_1024_VERIFY_STREAM 9216
+#endif
+#ifndef DSA_STACK_BUDGET_FALCON_PADDED_512_KEYGEN
+#define DSA_STACK_BUDGET_FALCON_PADDED_512_KEYGEN 18688
+#define DSA_STACK_BUDGET_FALCON_PADDED_512_SIGN 44544
+#define DSA_STACK_BUDGET_FALCON_PADDED_512_VERIFY 5120
+#define DSA_STACK_BUDGET_FALCON_PADDED_512_KEYGEN_WS 1792
+#define DSA_STACK_BUDGET_FALCON_PADDED_512_SIGN_WS 3584
+#define DSA_STACK_BUDGET_FALCON_PADDED_512_VERIFY_WS 1024
+#define DSA_STACK_BUDGET_FALCON_PADDED_512_SIGN_STREAM 44800
+#define DSA_STACK_BUDGET_FALCON_PADDED_512_VERIFY_STREAM 5120
+#endif
+#ifndef DSA_STACK_BUDGET_FALCON_PADDED_1024_KEYGEN
+#define DSA_STACK_BUDGET_FALCON_PADDED_1024_KEYGEN 35584
+#define DSA_STACK_BUDGET_FALCON_PADDED_1024_SIGN 85760
+#define DSA_STACK_BUDGET_FALCON_PADDED_1024_VERIFY 9216
+#define DSA_STACK_BUDGET_FALCON_PADDED_1024_KEYGEN_WS 1792
+#define DSA_STACK_BUDGET_FALCON_PADDED_1024_SIGN_WS 3840
+#define DSA_STACK_BUDGET_FALCON_PADDED_1024_VERIFY_WS 1024
+#define DSA_STACK_BUDGET_FALCON_PADDED_1024_SIGN_STREAM 85760
+#define DSA_STACK_BUDGET_FALCON_PADDED_1024_VERIFY_STREAM 9216
+#endif
+#ifndef DSA_STACK_BUDGET_ML_DSA_44_KEYGEN
+#define DSA_STACK_BUDGET_ML_DSA_44_KEYGEN 43008
+#define DSA_STACK_BUDGET_ML_DSA_44_SIGN 56320
+#define DSA_STACK_BUDGET_ML_DSA_44_VERIFY 40960
+#define DSA_STACK_BUDGET_ML_DSA_44_KEYGEN_WS 6144
+#define DSA_STACK_BUDGET_ML_DSA_44_SIGN_WS 6144
+#define DSA_STACK_BUDGET_ML_DSA_44_VERIFY_WS 6144
+#define DSA_STACK_BUDGET_ML_DSA_44_SIGN_STREAM 56576
+#define DSA_STACK_BUDGET_ML_DSA_44_VERIFY_STREAM 40960
+#endif
+#ifndef DSA_STACK_BUDGET_ML_DSA_65_KEYGEN
+#define DSA_STACK_BUDGET_ML_DSA_65_KEYGEN 65792
+#define DSA_STACK_BUDGET_ML_DSA_65_SIGN 84224
+#define DSA_STACK_BUDGET_ML_DSA_65_VERIFY 62464
+#define DSA_STACK_BUDGET_ML_DSA_65_KEYGEN_WS 6400
+#define DSA_STACK_BUDGET_ML_DSA_65_SIGN_WS 6144
+#define DSA_STACK_BUDGET_ML_DSA_65_VERIFY_WS 6144
+#define DSA_STACK_BUDGET_ML_DSA_65_SIGN_STREAM 84224
+#define DSA_STACK_BUDGET_ML_DSA_65_VERIFY_STREAM 62720
+#endif
+#ifndef DSA_STACK_BUDGET_ML_DSA_87_KEYGEN
+#define DSA_STACK_BUDGET_ML_DSA_87_KEYGEN 102656
+#define DSA_STACK_BUDGET_ML_DSA_87_SIGN 127232
+#define DSA_STACK_BUDGET_ML_DSA_87_VERIFY 97536
+#define DSA_STACK_BUDGET_ML_DSA_87_KEYGEN_WS 6400
+#define DSA_STACK_BUDGET_ML_DSA_87_SIGN_WS 6144
+#define DSA_STACK_BUDGET_ML_DSA_87_VERIFY_WS 6144
+#define DSA_STACK_BUDGET_ML_DSA_87_SIGN_STREAM 127232
+#define DSA_STACK_BUDGET_ML_DSA_87_VERIFY_STREAM 97536
+#endif
+#ifndef DSA_STACK_BUDGET_SPHINCS_SHA2_128F_KEYGEN
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_128F_KEYGEN 4608
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_128F_SIGN 5376
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_128F_VERIFY 2048
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_128F_KEYGEN_WS 4608
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_128F_SIGN_WS 5376
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_128F_VERIFY_WS 2048
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_128F_SIGN_STREAM 5376
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_128F_VERIFY_STREAM 2048
+#endif
+#ifndef DSA_STACK_BUDGET_SPHINCS_SHA2_128S_KEYGEN
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_128S_KEYGEN 4608
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_128S_SIGN 5120
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_128S_VERIFY 2048
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_128S_KEYGEN_WS 4608
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_128S_SIGN_WS 5120
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_128S_VERIFY_WS 2048
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_128S_SIGN_STREAM 5376
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_128S_VERIFY_STREAM 2048
+#endif
+#ifndef DSA_STACK_BUDGET_SPHINCS_SHA2_192F_KEYGEN
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_192F_KEYGEN 6144
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_192F_SIGN 6400
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_192F_VERIFY 3840
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_192F_KEYGEN_WS 6144
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_192F_SIGN_WS 6400
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_192F_VERIFY_WS 3840
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_192F_SIGN_STREAM 6912
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_192F_VERIFY_STREAM 3584
+#endif
+#ifndef DSA_STACK_BUDGET_SPHINCS_SHA2_192S_KEYGEN
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_192S_KEYGEN 6400
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_192S_SIGN 6144
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_192S_VERIFY 3840
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_192S_KEYGEN_WS 6400
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_192S_SIGN_WS 6144
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_192S_VERIFY_WS 3840
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_192S_SIGN_STREAM 7424
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_192S_VERIFY_STREAM 3584
+#endif
+#ifndef DSA_STACK_BUDGET_SPHINCS_SHA2_256F_KEYGEN
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_256F_KEYGEN 9216
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_256F_SIGN 8192
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_256F_VERIFY 5888
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_256F_KEYGEN_WS 9216
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_256F_SIGN_WS 8192
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_256F_VERIFY_WS 5888
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_256F_SIGN_STREAM 9472
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_256F_VERIFY_STREAM 5632
+#endif
+#ifndef DSA_STACK_BUDGET_SPHINCS_SHA2_256S_KEYGEN
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_256S_KEYGEN 9472
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_256S_SIGN 7168
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_256S_VERIFY 5888
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_256S_KEYGEN_WS 9472
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_256S_SIGN_WS 7168
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_256S_VERIFY_WS 5888
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_256S_SIGN_STREAM 9728
+#define DSA_STACK_BUDGET_SPHINCS_SHA2_256S_VERIFY_STREAM 5632
+#endif
+#ifndef DSA_STACK_BUDGET_SPHINCS_SHAKE_128F_KEYGEN
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_128F_KEYGEN 5376
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_128F_SIGN 6144
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_128F_VERIFY 2560
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_128F_KEYGEN_WS 5376
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_128F_SIGN_WS 6144
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_128F_VERIFY_WS 2816
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_128F_SIGN_STREAM 5888
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_128F_VERIFY_STREAM 2560
+#endif
+#ifndef DSA_STACK_BUDGET_SPHINCS_SHAKE_128S_KEYGEN
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_128S_KEYGEN 5376
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_128S_SIGN 5632
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_128S_VERIFY 2560
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_128S_KEYGEN_WS 5376
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_128S_SIGN_WS 5632
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_128S_VERIFY_WS 2816
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_128S_SIGN_STREAM 6144
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_128S_VERIFY_STREAM 2560
+#endif
+#ifndef DSA_STACK_BUDGET_SPHINCS_SHAKE_192F_KEYGEN
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_192F_KEYGEN 6912
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_192F_SIGN 6912
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_192F_VERIFY 4096
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_192F_KEYGEN_WS 6912
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_192F_SIGN_WS 6912
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_192F_VERIFY_WS 4096
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_192F_SIGN_STREAM 7424
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_192F_VERIFY_STREAM 3840
+#endif
+#ifndef DSA_STACK_BUDGET_SPHINCS_SHAKE_192S_KEYGEN
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_192S_KEYGEN 7168
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_192S_SIGN 6656
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_192S_VERIFY 4096
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_192S_KEYGEN_WS 7168
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_192S_SIGN_WS 6656
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_192S_VERIFY_WS 4096
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_192S_SIGN_STREAM 7936
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_192S_VERIFY_STREAM 3840
+#endif
+#ifndef DSA_STACK_BUDGET_SPHINCS_SHAKE_256F_KEYGEN
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_256F_KEYGEN 9216
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_256F_SIGN 8192
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_256F_VERIFY 5888
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_256F_KEYGEN_WS 9216
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_256F_SIGN_WS 8448
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_256F_VERIFY_WS 5888
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_256F_SIGN_STREAM 9472
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_256F_VERIFY_STREAM 5888
+#endif
+#ifndef DSA_STACK_BUDGET_SPHINCS_SHAKE_256S_KEYGEN
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_256S_KEYGEN 9472
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_256S_SIGN 7936
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_256S_VERIFY 5888
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_256S_KEYGEN_WS 9472
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_256S_SIGN_WS 7936
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_256S_VERIFY_WS 5888
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_256S_SIGN_STREAM 9728
+#define DSA_STACK_BUDGET_SPHINCS_SHAKE_256S_VERIFY_STREAM 5888
+#endif
+
+#endif // DSA_STACK_BUDGET_HOST_H
@@ -0,0 +1,397 @@
+#include "dsa_stats.h"
+#include <alloca.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(ESP_PLATFORM)
+#include "esp_cpu.h"
+#include "esp_heap_caps.h"
+#include "esp_rom_sys.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#else
+#include <time.h>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#endif
+
+// Same fill byte FreeRTOS uses for new task stacks, so painting does not
+// disturb uxTaskGetStackHighWaterMark().
+#define DSA_STACK_FILL 0xA5
+
+// Keep this much of the free stack unpainted on target for interrupts and
+// for the probe's own frames.
+#define DSA_STACK_PAINT_MARGIN 512
+
+// Host threads have megabytes of stack; paint enough for the largest set.
+#define DSA_HOST_STACK_PAINT_BYTES (512 * 1024)
+
+static struct dsa_op_stats op_stats[DSA_ALGO_COUNT][DSA_OP_COUNT];
+static struct dsa_call_stats last_call;
+static bool have_last_call;
+
+static uint64_t read_cycles(void) {
+#if defined(ESP_PLATFORM)
+    return esp_cpu_get_cycle_count();
+#elif defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static uint64_t read_wall_ns(void) {
+#if defined(ESP_PLATFORM)
+    return (uint64_t)esp_timer_get_time() * 1000;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+static long read_heap_used(void) {
+#if defined(ESP_PLATFORM)
+    return -(long)heap_caps_get_free_size(MALLOC_CAP_8BIT);
+#elif defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    return (long)mallinfo2().uordblks;
+#else
+    return 0;
+#endif
+}
+
+static size_t paint_depth(void) {
+#if defined(ESP_PLATFORM)
+    // Everything below the deepest point the task ever reached is free, so
+    // painting that much minus a margin stays inside the task stack.
+    size_t free_bytes = uxTaskGetStackHighWaterMark(NULL) * sizeof(StackType_t);
+    return free_bytes > DSA_STACK_PAINT_MARGIN ? free_bytes - DSA_STACK_PAINT_MARGIN : 0;
+#else
+    return DSA_HOST_STACK_PAINT_BYTES;
+#endif
+}
+
+// Fills `depth` bytes of free stack below the caller's frame. The buffer is
+// released on return, so the operation measured next runs over it.
+static __attribute__((noinline)) void paint_stack(struct dsa_probe *probe, size_t depth) {
+    uint8_t *buf = alloca(depth);
+    memset(buf, DSA_STACK_FILL, depth);
+    __asm__ volatile("" : : "r"(buf) : "memory");
+    probe->stack_lo = buf;
+    probe->stack_hi = buf + depth;
+}
+
+static __attribute__((noinline)) size_t scan_stack(const struct dsa_probe *probe) {
+    const volatile uint8_t *p = probe->stack_lo;
+    while (p < probe->stack_hi && *p == DSA_STACK_FILL) {
+        p++;
+    }
+    return (size_t)(probe->stack_hi - (const uint8_t *)p);
+}
+
+void dsa_probe_begin(struct dsa_probe *probe) {
+    paint_stack(probe, paint_depth());
+    probe->heap_used = read_heap_used();
+    probe->wall_ns = read_wall_ns();
+    probe->cycles = read_cycles();
+}
+
+void dsa_probe_end(struct dsa_probe *probe, enum DSA_ALGO algo, enum DSA_OP op, int ret) {
+    uint64_t cycles = read_cycles();
+    uint64_t wall_ns = read_wall_ns() - probe->wall_ns;
+
+#if defined(ESP_PLATFORM)
+    // The Xtensa counter is 32 bits wide and wraps after ~18 s at 240 MHz,
+    // which slow SPHINCS+ signatures exceed; fall back to wall time then.
+    uint64_t ticks_per_us = esp_rom_get_cpu_ticks_per_us();
+    if (wall_ns / 1000 * ticks_per_us > UINT32_MAX) {
+        cycles = wall_ns / 1000 * ticks_per_us;
+    } else {
+        cycles = (uint32_t)((uint32_t)cycles - (uint32_t)probe->cycles);
+    }
+#else
+    cycles -= probe->cycles;
+#endif
+
+    last_call.algo = algo;
+    last_call.op = op;
+    last_call.ret = ret;
+    last_call.cycles = cycles;
+    last_call.wall_ns = wall_ns;
+    last_call.stack_peak = scan_stack(probe);
+    last_call.heap_delta = read_heap_used() - probe->heap_used;
+    have_last_call = true;
+
+    if ((unsigned)algo >= DSA_ALGO_COUNT || (unsigned)op >= DSA_OP_COUNT) {
+        return;
+    }
+    struct dsa_op_stats *s = &op_stats[algo][op];
+    if (s->calls == 0 || cycles < s->cycles_min) {
+        s->cycles_min = cycles;
+    }
+    if (s->calls == 0 || wall_ns < s->wall_ns_min) {
+        s->wall_ns_min = wall_ns;
+    }
+    if (s->calls == 0 || last_call.heap_delta > s->heap_delta_max) {
+        s->heap_delta_max = last_call.heap_delta;
+    }
+    if (cycles > s->cycles_max) {
+        s->cycles_max = cycles;
+    }
+    if (wall_ns > s->wall_ns_max) {
+        s->wall_ns_max = wall_ns;
+    }
+    if (last_call.stack_peak > s->stack_peak) {
+        s->stack_peak = last_call.stack_peak;
+    }
+    s->cycles_total += cycles;
+    s->wall_ns_total += wall_ns;
+    s->calls++;
+    if (ret != 0) {
+        s->failures++;
+    }
+}
+
+const struct dsa_call_stats *dsa_stats_last(void) {
+    return have_last_call ? &last_call : NULL;
+}
+
+int dsa_stats_get(enum DSA_ALGO algo, enum DSA_OP op, struct dsa_op_stats *out) {
+    if ((unsigned)algo >= DSA_ALGO_COUNT || (unsigned)op >= DSA_OP_COUNT) {
+        return -1;
+    }
+    *out = op_stats[algo][op];
+    return 0;
+}
+
+void dsa_stats_reset(void) {
+    memset(op_stats, 0, sizeof(op_stats));
+    have_last_call = false;
+}
+
+const char *dsa_op_name(enum DSA_OP op) {
+    switch (op) {
+        case DSA_OP_KEYGEN: return "keygen";
+        case DSA_OP_SIGN: return "sign";
+        case DSA_OP_VERIFY: return "verify";
+        default: return "unknown";
+    }
+}
+
+void dsa_stats_dump_csv(FILE *out) {
+    fprintf(out, "algorithm,operation,calls,failures,"
+                 "cycles_avg,cycles_min,cycles_max,"
+                 "wall_us_avg,wall_us_min,wall_us_max,"
+                 "stack_peak,heap_delta_max\n");
+    for (int a = 0; a < DSA_ALGO_COUNT; a++) {
+        for (int o = 0; o < DSA_OP_COUNT; o++) {
+            const struct dsa_op_stats *s = &op_stats[a][o];
+            if (s->calls == 0) {
+                continue;
+            }
+            fprintf(out, "%s,%s,%u,%u,%llu,%llu,%llu,%.1f,%.1f,%.1f,%u,%ld\n",
+                    getAlgoName((enum DSA_ALGO)a), dsa_op_name((enum DSA_OP)o),
+                    (unsigned)s->calls, (unsigned)s->failures,
+                    (unsigned long long)(s->cycles_total / s->calls),
+                    (unsigned long long)s->cycles_min,
+                    (unsigned long long)s->cycles_max,
+                    (double)s->wall_ns_total / s->calls / 1000.0,
+                    (double)s->wall_ns_min / 1000.0,
+                    (double)s->wall_ns_max / 1000.0,
+                    (unsigned)s->stack_peak, s->heap_delta_max);
+        }
+    }
+}
+
+#if defined(ESP_PLATFORM)
+#define DSA_STACK_PROFILE_TARGET CONFIG_IDF_TARGET
+#elif defined(__x86_64__)
+#define DSA_STACK_PROFILE_TARGET "x86_64 host"
+#elif defined(__aarch64__)
+#define DSA_STACK_PROFILE_TARGET "aarch64 host"
+#else
+#define DSA_STACK_PROFILE_TARGET "host"
+#endif
+
+#define DSA_STACK_BUDGET_ROUNDING 256
+
+static size_t round_budget(size_t bytes) {
+    return (bytes + DSA_STACK_BUDGET_ROUNDING - 1) / DSA_STACK_BUDGET_ROUNDING * DSA_STACK_BUDGET_ROUNDING;
+}
+
+static void profile_update(struct dsa_probe *probe, size_t *peak) {
+    size_t used = scan_stack(probe);
+    if (used > *peak) {
+        *peak = used;
+    }
+}
+
+// Sink of the profiled dsa_signature_stream(): gathers the pieces into the
+// signature buffer, which the streaming verification then checks.
+struct profile_sink {
+    uint8_t *sig;
+    size_t len;
+    size_t cap;
+};
+
+static int profile_sink(void *arg, const uint8_t *data, size_t len) {
+    struct profile_sink *sink = arg;
+    if (len > sink->cap - sink->len) {
+        return -1;
+    }
+    memcpy(sink->sig + sink->len, data, len);
+    sink->len += len;
+    return 0;
+}
+
+// Feeds the signature to the streaming verification in pieces of
+// DSA_STACK_PROFILE_PIECE bytes, as a transport would.
+#define DSA_STACK_PROFILE_PIECE 2048
+
+static int profile_verify_stream(enum DSA_ALGO algo, const uint8_t *sig, size_t siglen,
+                                 const uint8_t *m, size_t mlen, const uint8_t *pk) {
+    struct dsa_verify_stream *vs = dsa_verify_stream_new(algo, m, mlen, pk);
+    if (!vs) {
+        return -1;
+    }
+    for (size_t off = 0; off < siglen; off += DSA_STACK_PROFILE_PIECE) {
+        size_t n = siglen - off < DSA_STACK_PROFILE_PIECE ? siglen - off : DSA_STACK_PROFILE_PIECE;
+        dsa_verify_stream_update(vs, sig + off, n);
+    }
+    return dsa_verify_stream_final(vs);
+}
+
+// Fills peak[] with the stack of the plain operations, peak_ws[] with that
+// of the dsa_*_ws() variants running on a heap workspace and peak_stream[]
+// with that of dsa_signature_stream() and the dsa_verify_stream_*() calls.
+static int profile_algo(enum DSA_ALGO algo, const struct dsa_descriptor *d, int iterations,
+                        size_t peak[DSA_OP_COUNT], size_t peak_ws[DSA_OP_COUNT],
+                        size_t peak_stream[DSA_OP_COUNT]) {
+    static const uint8_t m[32] = {0};
+    struct dsa_probe probe;
+    size_t siglen = 0;
+    size_t ws_len = 0;
+    int ret = 0;
+
+    for (int o = 0; o < DSA_OP_COUNT; o++) {
+        size_t len = dsa_workspace_size(algo, (enum DSA_OP)o);
+        if (len > ws_len) {
+            ws_len = len;
+        }
+    }
+
+    uint8_t *pk = malloc(d->pk_len);
+    uint8_t *sk = malloc(d->sk_len);
+    uint8_t *sig = malloc(d->sig_len);
+    void *ws = ws_len ? malloc(ws_len) : NULL;
+    if (!pk || !sk || !sig || (ws_len && !ws)) {
+        ret = -1;
+    }
+
+    for (int i = 0; i < iterations && ret == 0; i++) {
+        dsa_probe_begin(&probe);
+        ret |= d->keypair(pk, sk);
+        profile_update(&probe, &peak[DSA_OP_KEYGEN]);
+
+        dsa_probe_begin(&probe);
+        ret |= d->signature(sig, &siglen, m, sizeof(m), sk);
+        profile_update(&probe, &peak[DSA_OP_SIGN]);
+
+        dsa_probe_begin(&probe);
+        ret |= d->verify(sig, siglen, m, sizeof(m), pk);
+        profile_update(&probe, &peak[DSA_OP_VERIFY]);
+
+        dsa_probe_begin(&probe);
+        ret |= dsa_keygen_ws(algo, pk, sk, ws, ws_len);
+        profile_update(&probe, &peak_ws[DSA_OP_KEYGEN]);
+
+        dsa_probe_begin(&probe);
+        ret |= dsa_signature_ws(algo, sig, &siglen, m, sizeof(m), sk, ws, ws_len);
+        profile_update(&probe, &peak_ws[DSA_OP_SIGN]);
+
+        dsa_probe_begin(&probe);
+        ret |= dsa_verify_ws(algo, sig, siglen, m, sizeof(m), pk, ws, ws_len);
+        profile_update(&probe, &peak_ws[DSA_OP_VERIFY]);
+
+        struct profile_sink sink = {sig, 0, d->sig_len};
+        dsa_probe_begin(&probe);
+        ret |= dsa_signature_stream(algo, m, sizeof(m), sk, profile_sink, &sink);
+        profile_update(&probe, &peak_stream[DSA_OP_SIGN]);
+
+        dsa_probe_begin(&probe);
+        ret |= profile_verify_stream(algo, sig, sink.len, m, sizeof(m), pk);
+        profile_update(&probe, &peak_stream[DSA_OP_VERIFY]);
+    }
+
+    free(pk);
+    free(sk);
+    free(sig);
+    free(ws);
+    return ret ? -1 : 0;
+}
+
+int dsa_stack_profile_header(FILE *out, int iterations) {
+    static const char *const op_suffix[DSA_OP_COUNT] = {"KEYGEN", "SIGN", "VERIFY"};
+    int ret = 0;
+
+    fprintf(out, "// Generated by dsa_stack_profile_header(); do not edit by hand.\n");
+    fprintf(out, "// Target: %s, %d run%s per operation.\n", DSA_STACK_PROFILE_TARGET,
+            iterations, iterations == 1 ? "" : "s");
+    fprintf(out, "//\n");
+    fprintf(out, "// Peak stack in bytes of keygen, signature and verify of each parameter set,\n");
+    fprintf(out, "// rounded up to %d bytes. The _WS figures are for dsa_*_ws(), with the\n",
+            DSA_STACK_BUDGET_ROUNDING);
+    fprintf(out, "// temporaries in a caller workspace, and the _STREAM ones for\n");
+    fprintf(out, "// dsa_signature_stream() and dsa_verify_stream_*().\n");
+#ifdef ESP_PLATFORM
+    fprintf(out, "// Parameter sets that were not compiled in fall back to the host estimates\n");
+    fprintf(out, "// of dsa_stack_budget_host.h.\n");
+    fprintf(out, "#ifndef DSA_STACK_BUDGET_H\n#define DSA_STACK_BUDGET_H\n\n");
+#else
+    fprintf(out, "// Measured on the host, not on the ESP32: these are estimates, used for every\n");
+    fprintf(out, "// parameter set that dsa_stack_budget.h has not profiled on the target.\n");
+    fprintf(out, "#ifndef DSA_STACK_BUDGET_HOST_H\n#define DSA_STACK_BUDGET_HOST_H\n\n");
+#endif
+    for (int a = 0; a < DSA_ALGO_COUNT; a++) {
+        const struct dsa_descriptor *d = dsa_get_descriptor((enum DSA_ALGO)a);
+        size_t peak[DSA_OP_COUNT] = {0};
+        size_t peak_ws[DSA_OP_COUNT] = {0};
+        size_t peak_stream[DSA_OP_COUNT] = {0};
+        if (!d) {
+            continue;
+        }
+        if (profile_algo((enum DSA_ALGO)a, d, iterations, peak, peak_ws, peak_stream) != 0) {
+            fprintf(out, "#error \"%s failed while profiling\"\n", d->name);
+            ret = -1;
+            continue;
+        }
+        // Guarded as a whole, so that a header profiled on the target takes
+        // precedence over the host estimates it includes.
+        fprintf(out, "#ifndef DSA_STACK_BUDGET_%s_KEYGEN\n", d->name);
+        for (int o = 0; o < DSA_OP_COUNT; o++) {
+            fprintf(out, "#define DSA_STACK_BUDGET_%s_%s %u\n", d->name, op_suffix[o],
+                    (unsigned)round_budget(peak[o]));
+        }
+        for (int o = 0; o < DSA_OP_COUNT; o++) {
+            fprintf(out, "#define DSA_STACK_BUDGET_%s_%s_WS %u\n", d->name, op_suffix[o],
+                    (unsigned)round_budget(peak_ws[o]));
+        }
+        for (int o = DSA_OP_SIGN; o < DSA_OP_COUNT; o++) {
+            fprintf(out, "#define DSA_STACK_BUDGET_%s_%s_STREAM %u\n", d->name, op_suffix[o],
+                    (unsigned)round_budget(peak_stream[o]));
+        }
+        fprintf(out, "#endif\n");
+    }
+#ifdef ESP_PLATFORM
+    fprintf(out, "\n#include \"dsa_stack_budget_host.h\"\n");
+    fprintf(out, "\n#endif // DSA_STACK_BUDGET_H\n");
+#else
+    fprintf(out, "\n#endif // DSA_STACK_BUDGET_HOST_H\n");
+#endif
+    return ret;
+}
@@ -0,0 +1,91 @@
+#ifndef DSA_STATS_H
+#define DSA_STATS_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "dsa.h"
+
+// Optional per-call instrumentation of dsa_keygen, dsa_sign/dsa_signature and
+// dsa_verify/dsa_open, enabled with CONFIG_DSA_INSTRUMENTATION (menuconfig on
+// target, -DCONFIG_DSA_INSTRUMENTATION=ON on host). Each call records:
+//  - cycles: CPU cycle counter on ESP32, TSC on x86 hosts, 0 elsewhere.
+//    The ESP32 counter is per core, so tasks being measured must be pinned.
+//  - wall time in nanoseconds (esp_timer on target, CLOCK_MONOTONIC on host).
+//  - peak stack, found by painting the free stack below the caller before
+//    the call and scanning it afterwards.
+//  - heap delta: bytes still allocated after the call minus before it, so
+//    anything but 0 points at a leak.
+// The bookkeeping is not thread-safe; measure from one task at a time.
+
+struct dsa_call_stats {
+    enum DSA_ALGO algo;
+    enum DSA_OP op;
+    int ret;
+    uint64_t cycles;
+    uint64_t wall_ns;
+    size_t stack_peak;
+    long heap_delta;
+};
+
+// Aggregate over every call recorded for one (algorithm, operation) pair.
+struct dsa_op_stats {
+    uint32_t calls;
+    uint32_t failures;
+    uint64_t cycles_total;
+    uint64_t cycles_min;
+    uint64_t cycles_max;
+    uint64_t wall_ns_total;
+    uint64_t wall_ns_min;
+    uint64_t wall_ns_max;
+    size_t stack_peak;
+    long heap_delta_max;
+};
+
+// State carried from dsa_probe_begin() to dsa_probe_end().
+struct dsa_probe {
+    uint64_t cycles;
+    uint64_t wall_ns;
+    long heap_used;
+    uint8_t *stack_lo;
+    uint8_t *stack_hi;
+};
+
+void dsa_probe_begin(struct dsa_probe *probe);
+
+void dsa_probe_end(struct dsa_probe *probe, enum DSA_ALGO algo, enum DSA_OP op, int ret);
+
+// Returns the most recent call, or NULL if nothing was recorded yet.
+const struct dsa_call_stats *dsa_stats_last(void);
+
+// Returns 0 and fills *out, or -1 for an invalid algorithm or operation.
+int dsa_stats_get(enum DSA_ALGO algo, enum DSA_OP op, struct dsa_op_stats *out);
+
+void dsa_stats_reset(void);
+
+// One header line, then one line per (algorithm, operation) with calls.
+void dsa_stats_dump_csv(FILE *out);
+
+const char *dsa_op_name(enum DSA_OP op);
+
+// Stack profiling mode: runs keygen, signature and verify of every
+// compiled-in parameter set `iterations` times, plain, through dsa_*_ws()
+// and streamed, independently of CONFIG_DSA_INSTRUMENTATION, and writes the
+// worst case of each as the C header that dsa.c takes its stack budgets
+// from. On the ESP32 that is src/dsa_stack_budget.h, which falls back to the
+// host estimates of src/dsa_stack_budget_host.h for the parameter sets it
+// lacks; on a host build it is src/dsa_stack_budget_host.h. Run it from a
+// task with plenty of stack. Returns 0, or -1 if an operation failed or
+// memory ran out.
+int dsa_stack_profile_header(FILE *out, int iterations);
+
+#ifdef CONFIG_DSA_INSTRUMENTATION
+#define DSA_PROBE_BEGIN(probe) \
+    struct dsa_probe probe;    \
+    dsa_probe_begin(&probe)
+#define DSA_PROBE_END(probe, algo, op, ret) dsa_probe_end(&probe, algo, op, ret)
+#else
+#define DSA_PROBE_BEGIN(probe)
+#define DSA_PROBE_END(probe, algo, op, ret) ((void)0)
+#endif
+
+#endif // DSA_STATS_H
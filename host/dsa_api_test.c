@@ -0,0 +1,342 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dsa.h"
+
+// Checks the dsa.h entry points beyond plain keygen, sign and open on every
+// compiled-in parameter set: each other way of signing must give the
+// signature of dsa_signature() byte for byte, and each way of verifying must
+// accept it and reject it tampered with, truncated or with a byte appended.
+// randombytes() is replaced by a generator that can be restarted, so that
+// randomized signing gives the same signature every time. Exits non-zero on
+// any failure.
+
+static uint64_t rng_state;
+
+static void rng_restart(uint64_t seed) {
+    rng_state = seed | 1;
+}
+
+int PQCLEAN_randombytes(uint8_t *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        rng_state ^= rng_state << 13;
+        rng_state ^= rng_state >> 7;
+        rng_state ^= rng_state << 17;
+        out[i] = (uint8_t)(rng_state >> 24);
+    }
+    return 0;
+}
+
+#define SIGN_SEED 0x5EED
+
+static const uint8_t message[] = "Test message for the DSA API";
+#define MLEN (sizeof(message) - 1)
+
+static int failures;
+
+static void check(int ok, const char *name, const char *what) {
+    if (!ok) {
+        printf("%-20s FAILED %s\n", name, what);
+        failures++;
+    }
+}
+
+struct keys {
+    uint8_t *pk, *sk;
+};
+
+static void keys_new(struct keys *k, const struct dsa_descriptor *d, enum DSA_ALGO algo,
+                     uint64_t seed) {
+    k->pk = malloc(d->pk_len);
+    k->sk = malloc(d->sk_len);
+    rng_restart(seed);
+    dsa_keygen(algo, k->pk, k->sk);
+}
+
+static void keys_free(struct keys *k) {
+    free(k->pk);
+    free(k->sk);
+}
+
+// The signature of dsa_signature(), for the others to match
+struct reference {
+    uint8_t *sig;
+    size_t siglen;
+};
+
+static void check_signature(const char *name, const char *what, int ret,
+                            const uint8_t *sig, size_t siglen, const struct reference *ref) {
+    check(ret == 0 && siglen == ref->siglen && memcmp(sig, ref->sig, siglen) == 0, name, what);
+}
+
+typedef int (*verify_fn)(const void *arg, const uint8_t *sig, size_t siglen);
+
+// Runs one way of verifying on the reference signature, on a copy with one
+// bit flipped, on all but its last byte and on it with a zero byte appended.
+static void check_verify(const char *name, const char *what, verify_fn verify,
+                         const void *arg, const struct reference *ref) {
+    char text[96];
+    uint8_t *sig = malloc(ref->siglen + 1);
+
+    memcpy(sig, ref->sig, ref->siglen);
+    sig[ref->siglen] = 0;
+    snprintf(text, sizeof(text), "%s of a valid signature", what);
+    check(verify(arg, sig, ref->siglen) == 0, name, text);
+
+    sig[ref->siglen / 2] ^= 0x10;
+    snprintf(text, sizeof(text), "%s of a tampered signature", what);
+    check(verify(arg, sig, ref->siglen) != 0, name, text);
+    sig[ref->siglen / 2] ^= 0x10;
+
+    snprintf(text, sizeof(text), "%s of a truncated signature", what);
+    check(verify(arg, sig, ref->siglen - 1) != 0, name, text);
+    snprintf(text, sizeof(text), "%s of an overlong signature", what);
+    check(verify(arg, sig, ref->siglen + 1) != 0, name, text);
+    free(sig);
+}
+
+// A key context takes either key alone or a matching pair, but not the
+// secret key of one pair with the public key of another.
+static void test_key_ctx_pair(enum DSA_ALGO algo, const struct dsa_descriptor *d,
+                              const struct keys *k, const struct keys *other) {
+    struct dsa_key_ctx *kc;
+
+    kc = dsa_key_ctx_new(algo, k->pk, k->sk, false);
+    check(kc != NULL, d->name, "key context of a key pair");
+    dsa_key_ctx_free(kc);
+    if (!d->key_ctx_bytes) {
+        return; // Nothing derived from the keys to mix up
+    }
+    kc = dsa_key_ctx_new(algo, other->pk, k->sk, false);
+    check(kc == NULL, d->name, "key context of a mismatched pair");
+    dsa_key_ctx_free(kc);
+}
+
+struct ws_args {
+    enum DSA_ALGO algo;
+    const uint8_t *pk;
+    void *ws;
+    size_t ws_len;
+};
+
+static int verify_ws(const void *arg, const uint8_t *sig, size_t siglen) {
+    const struct ws_args *w = arg;
+    return dsa_verify_ws(w->algo, sig, siglen, message, MLEN, w->pk, w->ws, w->ws_len);
+}
+
+static void test_workspace(enum DSA_ALGO algo, const struct dsa_descriptor *d,
+                           const struct keys *k, const struct reference *ref) {
+    struct ws_args w = { algo, k->pk, NULL, 0 };
+    uint8_t *pk = malloc(d->pk_len), *sk = malloc(d->sk_len), *sig = malloc(d->sig_len);
+    size_t siglen = 0;
+    void *ws[DSA_OP_COUNT];
+    size_t ws_len[DSA_OP_COUNT];
+
+    for (int op = 0; op < DSA_OP_COUNT; op++) {
+        ws_len[op] = dsa_workspace_size(algo, op);
+        ws[op] = ws_len[op] ? malloc(ws_len[op]) : NULL;
+    }
+
+    rng_restart(1);
+    int ret = dsa_keygen_ws(algo, pk, sk, ws[DSA_OP_KEYGEN], ws_len[DSA_OP_KEYGEN]);
+    check(ret == 0 && memcmp(pk, k->pk, d->pk_len) == 0 && memcmp(sk, k->sk, d->sk_len) == 0,
+          d->name, "dsa_keygen_ws() gives the keys of dsa_keygen()");
+
+    rng_restart(SIGN_SEED);
+    ret = dsa_signature_ws(algo, sig, &siglen, message, MLEN, k->sk,
+                           ws[DSA_OP_SIGN], ws_len[DSA_OP_SIGN]);
+    check_signature(d->name, "dsa_signature_ws()", ret, sig, siglen, ref);
+
+    w.ws = ws[DSA_OP_VERIFY];
+    w.ws_len = ws_len[DSA_OP_VERIFY];
+    check_verify(d->name, "dsa_verify_ws()", verify_ws, &w, ref);
+
+    if (ws_len[DSA_OP_SIGN] > 0) {
+        ret = dsa_signature_ws(algo, sig, &siglen, message, MLEN, k->sk,
+                               ws[DSA_OP_SIGN], ws_len[DSA_OP_SIGN] - 1);
+        check(ret != 0, d->name, "dsa_signature_ws() with a short workspace");
+    }
+
+    for (int op = 0; op < DSA_OP_COUNT; op++) {
+        free(ws[op]);
+    }
+    free(pk);
+    free(sk);
+    free(sig);
+}
+
+static void test_sign_cache(enum DSA_ALGO algo, const struct dsa_descriptor *d,
+                            const struct keys *k, const struct reference *ref) {
+    size_t cache_len = dsa_sign_cache_size(algo);
+    uint8_t *cache = cache_len ? malloc(cache_len) : NULL;
+    uint8_t *sig = malloc(d->sig_len);
+    size_t siglen = 0;
+
+    check(dsa_sign_cache_init(algo, cache, cache_len, k->sk) == 0, d->name,
+          "dsa_sign_cache_init()");
+    rng_restart(SIGN_SEED);
+    int ret = dsa_signature_cached(algo, sig, &siglen, message, MLEN, k->sk, cache, cache_len);
+    check_signature(d->name, "dsa_signature_cached()", ret, sig, siglen, ref);
+
+    free(cache);
+    free(sig);
+}
+
+static int verify_key_ctx(const void *arg, const uint8_t *sig, size_t siglen) {
+    return dsa_key_ctx_verify(arg, sig, siglen, message, MLEN);
+}
+
+static void test_key_ctx(enum DSA_ALGO algo, const struct dsa_descriptor *d,
+                         const struct keys *k, const struct reference *ref) {
+    uint8_t *sig = malloc(d->sig_len);
+    size_t siglen = 0;
+    int ret;
+
+    for (int cache = 0; cache < 2; cache++) {
+        struct dsa_key_ctx *kc = dsa_key_ctx_new(algo, NULL, k->sk, cache);
+        check(kc != NULL, d->name, "signing key context");
+        if (kc) {
+            rng_restart(SIGN_SEED);
+            ret = dsa_key_ctx_signature(kc, sig, &siglen, message, MLEN);
+            check_signature(d->name, cache ? "dsa_key_ctx_signature() with the signing cache"
+                                           : "dsa_key_ctx_signature()",
+                            ret, sig, siglen, ref);
+            check(dsa_key_ctx_verify(kc, ref->sig, ref->siglen, message, MLEN) != 0,
+                  d->name, "dsa_key_ctx_verify() without pk");
+        }
+        dsa_key_ctx_free(kc);
+    }
+
+    struct dsa_key_ctx *kc = dsa_key_ctx_new(algo, k->pk, NULL, false);
+    check(kc != NULL, d->name, "verifying key context");
+    if (kc) {
+        check_verify(d->name, "dsa_key_ctx_verify()", verify_key_ctx, kc, ref);
+        check(dsa_key_ctx_signature(kc, sig, &siglen, message, MLEN) != 0,
+              d->name, "dsa_key_ctx_signature() without sk");
+    }
+    dsa_key_ctx_free(kc);
+
+    free(sig);
+}
+
+struct gather {
+    uint8_t *sig;
+    size_t siglen, max;
+};
+
+static int gather_piece(void *arg, const uint8_t *data, size_t len) {
+    struct gather *g = arg;
+    if (len > g->max - g->siglen) {
+        return -1;
+    }
+    memcpy(g->sig + g->siglen, data, len);
+    g->siglen += len;
+    return 0;
+}
+
+static int stop_at_first_piece(void *arg, const uint8_t *data, size_t len) {
+    (void)arg;
+    (void)data;
+    (void)len;
+    return 7;
+}
+
+static void test_signature_stream(enum DSA_ALGO algo, const struct dsa_descriptor *d,
+                                  const struct keys *k, const struct reference *ref) {
+    struct gather g = { malloc(d->sig_len), 0, d->sig_len };
+
+    rng_restart(SIGN_SEED);
+    int ret = dsa_signature_stream(algo, message, MLEN, k->sk, gather_piece, &g);
+    check_signature(d->name, "dsa_signature_stream()", ret, g.sig, g.siglen, ref);
+
+    struct dsa_key_ctx *kc = dsa_key_ctx_new(algo, NULL, k->sk, true);
+    if (kc) {
+        g.siglen = 0;
+        rng_restart(SIGN_SEED);
+        ret = dsa_key_ctx_signature_stream(kc, message, MLEN, gather_piece, &g);
+        check_signature(d->name, "dsa_key_ctx_signature_stream()", ret, g.sig, g.siglen, ref);
+    }
+    dsa_key_ctx_free(kc);
+
+    ret = dsa_signature_stream(algo, message, MLEN, k->sk, stop_at_first_piece, NULL);
+    check(ret == 7, d->name, "dsa_signature_stream() passes on the sink's error");
+    free(g.sig);
+}
+
+// Feeds the signature in pieces of 1, 2, 3, ... bytes, so that pieces
+// start and end everywhere within the parts the scheme verifies.
+static int feed_verify_stream(struct dsa_verify_stream *vs, const uint8_t *sig, size_t siglen) {
+    size_t piece = 1;
+    for (size_t pos = 0; pos < siglen; pos += piece, piece++) {
+        if (piece > siglen - pos) {
+            piece = siglen - pos;
+        }
+        if (dsa_verify_stream_update(vs, sig + pos, piece) != 0) {
+            break; // Bad already; final has to agree
+        }
+    }
+    return dsa_verify_stream_final(vs);
+}
+
+struct stream_args {
+    enum DSA_ALGO algo;
+    const uint8_t *pk;
+    const struct dsa_key_ctx *kc;
+};
+
+static int verify_stream(const void *arg, const uint8_t *sig, size_t siglen) {
+    const struct stream_args *s = arg;
+    struct dsa_verify_stream *vs = s->kc ? dsa_key_ctx_verify_stream_new(s->kc, message, MLEN)
+                                         : dsa_verify_stream_new(s->algo, message, MLEN, s->pk);
+    return vs ? feed_verify_stream(vs, sig, siglen) : -2;
+}
+
+static void test_verify_stream(enum DSA_ALGO algo, const struct dsa_descriptor *d,
+                               const struct keys *k, const struct reference *ref) {
+    struct stream_args s = { algo, k->pk, NULL };
+
+    check_verify(d->name, "streaming verification", verify_stream, &s, ref);
+
+    s.kc = dsa_key_ctx_new(algo, k->pk, NULL, false);
+    if (s.kc) {
+        check_verify(d->name, "streaming verification with a key context", verify_stream, &s, ref);
+    }
+    dsa_key_ctx_free((struct dsa_key_ctx *)s.kc);
+
+    // In one piece, as the non-streaming schemes receive it
+    struct dsa_verify_stream *vs = dsa_verify_stream_new(algo, message, MLEN, k->pk);
+    check(vs && dsa_verify_stream_update(vs, ref->sig, ref->siglen) == 0
+          && dsa_verify_stream_final(vs) == 0, d->name, "streaming verification in one piece");
+}
+
+int main(void) {
+    for (int a = 0; a < DSA_ALGO_COUNT; a++) {
+        const struct dsa_descriptor *d = dsa_get_descriptor(a);
+        if (!d) {
+            continue;
+        }
+        struct keys k, other;
+        keys_new(&k, d, a, 1);
+        keys_new(&other, d, a, 2);
+        int before = failures;
+
+        test_key_ctx_pair(a, d, &k, &other);
+
+        struct reference ref = { malloc(d->sig_len), 0 };
+        rng_restart(SIGN_SEED);
+        check(dsa_signature(a, ref.sig, &ref.siglen, message, MLEN, k.sk) == 0
+              && dsa_verify(a, ref.sig, ref.siglen, message, MLEN, k.pk) == 0,
+              d->name, "dsa_signature() and dsa_verify()");
+        test_workspace(a, d, &k, &ref);
+        test_sign_cache(a, d, &k, &ref);
+        test_key_ctx(a, d, &k, &ref);
+        test_signature_stream(a, d, &k, &ref);
+        test_verify_stream(a, d, &k, &ref);
+
+        printf("%-20s %s\n", d->name, failures == before ? "ok" : "FAILED");
+        free(ref.sig);
+        keys_free(&k);
+        keys_free(&other);
+    }
+    return failures != 0;
+}
@@ -0,0 +1,275 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "dsa.h"
+#include "dsa_stats.h"
+
+// Times keygen, signature and verify of every compiled-in parameter set (or
+// of the ones named on the command line) and prints one line per set.
+// Exits non-zero if any operation fails, so it doubles as a smoke test.
+// With --csv (needs -DCONFIG_DSA_INSTRUMENTATION=ON) the per-call counters
+// of dsa_stats.h are dumped as CSV afterwards. --stack-header runs the stack
+// profiling mode instead and prints src/dsa_stack_budget_host.h.
+// --ws runs the operations through dsa_*_ws() on one heap workspace sized
+// for the largest of them. --cache signs through dsa_signature_cached(), with
+// the cache built as part of keygen. --key-ctx signs and verifies through a
+// dsa_key_ctx, also created as part of keygen (with the signing cache if
+// --cache is given too).
+
+struct op_timing {
+    double total_us;
+    double min_us;
+};
+
+static double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec / 1e3;
+}
+
+static void record(struct op_timing *t, double start) {
+    double elapsed = now_us() - start;
+    t->total_us += elapsed;
+    if (t->min_us == 0 || elapsed < t->min_us) {
+        t->min_us = elapsed;
+    }
+}
+
+static void *ws;
+static size_t ws_len;
+static void *cache;
+static size_t cache_len;
+static bool use_key_ctx;
+static struct dsa_key_ctx *key_ctx;
+
+static int keygen(enum DSA_ALGO algo, uint8_t *pk, uint8_t *sk) {
+    int ret = ws ? dsa_keygen_ws(algo, pk, sk, ws, ws_len) : dsa_keygen(algo, pk, sk);
+    if (ret == 0 && use_key_ctx) {
+        dsa_key_ctx_free(key_ctx);
+        key_ctx = dsa_key_ctx_new(algo, pk, sk, cache != NULL);
+        ret = key_ctx ? 0 : -1;
+    } else if (ret == 0 && cache) {
+        ret = dsa_sign_cache_init(algo, cache, cache_len, sk);
+    }
+    return ret;
+}
+
+static int signature(enum DSA_ALGO algo, uint8_t *sig, size_t *siglen,
+                     const uint8_t *m, size_t mlen, const uint8_t *sk) {
+    if (key_ctx) {
+        return dsa_key_ctx_signature(key_ctx, sig, siglen, m, mlen);
+    }
+    if (cache) {
+        return dsa_signature_cached(algo, sig, siglen, m, mlen, sk, cache, cache_len);
+    }
+    return ws ? dsa_signature_ws(algo, sig, siglen, m, mlen, sk, ws, ws_len)
+              : dsa_signature(algo, sig, siglen, m, mlen, sk);
+}
+
+static int verify(enum DSA_ALGO algo, const uint8_t *sig, size_t siglen,
+                  const uint8_t *m, size_t mlen, const uint8_t *pk) {
+    if (key_ctx) {
+        return dsa_key_ctx_verify(key_ctx, sig, siglen, m, mlen);
+    }
+    return ws ? dsa_verify_ws(algo, sig, siglen, m, mlen, pk, ws, ws_len)
+              : dsa_verify(algo, sig, siglen, m, mlen, pk);
+}
+
+static bool bench_algo(enum DSA_ALGO algo, int iterations, size_t mlen) {
+    const struct dsa_descriptor *d = dsa_get_descriptor(algo);
+    struct op_timing t[DSA_OP_COUNT] = {0};
+    bool ok = true;
+
+    uint8_t *pk = malloc(d->pk_len);
+    uint8_t *sk = malloc(d->sk_len);
+    uint8_t *sig = malloc(d->sig_len);
+    uint8_t *m = malloc(mlen ? mlen : 1);
+    if (!pk || !sk || !sig || !m) {
+        printf("%-20s out of memory\n", d->name);
+        free(pk);
+        free(sk);
+        free(sig);
+        free(m);
+        return false;
+    }
+    for (size_t i = 0; i < mlen; i++) {
+        m[i] = (uint8_t)i;
+    }
+
+    for (int i = 0; i < iterations && ok; i++) {
+        size_t siglen = 0;
+        double start = now_us();
+        if (keygen(algo, pk, sk) != 0) {
+            printf("%-20s keygen failed\n", d->name);
+            ok = false;
+            break;
+        }
+        record(&t[DSA_OP_KEYGEN], start);
+
+        start = now_us();
+        if (signature(algo, sig, &siglen, m, mlen, sk) != 0) {
+            printf("%-20s signature failed\n", d->name);
+            ok = false;
+            break;
+        }
+        record(&t[DSA_OP_SIGN], start);
+
+        start = now_us();
+        if (verify(algo, sig, siglen, m, mlen, pk) != 0) {
+            printf("%-20s verify failed\n", d->name);
+            ok = false;
+            break;
+        }
+        record(&t[DSA_OP_VERIFY], start);
+    }
+
+    if (ok) {
+        printf("%-20s %12.1f %12.1f %12.1f %12.1f %12.1f %12.1f\n", d->name,
+               t[DSA_OP_KEYGEN].total_us / iterations, t[DSA_OP_KEYGEN].min_us,
+               t[DSA_OP_SIGN].total_us / iterations, t[DSA_OP_SIGN].min_us,
+               t[DSA_OP_VERIFY].total_us / iterations, t[DSA_OP_VERIFY].min_us);
+    }
+
+    dsa_key_ctx_free(key_ctx);
+    key_ctx = NULL;
+    free(pk);
+    free(sk);
+    free(sig);
+    free(m);
+    return ok;
+}
+
+static bool find_algo(const char *name, enum DSA_ALGO *algo) {
+    for (int i = 0; i < DSA_ALGO_COUNT; i++) {
+        const struct dsa_descriptor *d = dsa_get_descriptor((enum DSA_ALGO)i);
+        if (d && strcmp(d->name, name) == 0) {
+            *algo = (enum DSA_ALGO)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void usage(const char *prog) {
+    printf("usage: %s [-n iterations] [-m message_bytes] [--csv] [--ws] [--cache] [--key-ctx] [--stack-header] [ALGO...]\n", prog);
+    printf("algorithms:");
+    for (int i = 0; i < DSA_ALGO_COUNT; i++) {
+        const struct dsa_descriptor *d = dsa_get_descriptor((enum DSA_ALGO)i);
+        if (d) {
+            printf(" %s", d->name);
+        }
+    }
+    printf("\n");
+}
+
+int main(int argc, char **argv) {
+    int iterations = 5;
+    size_t mlen = 32;
+    enum DSA_ALGO selected[DSA_ALGO_COUNT];
+    size_t num_selected = 0;
+    bool csv = false;
+    bool stack_header = false;
+    bool use_ws = false;
+    bool use_cache = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            iterations = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
+            mlen = (size_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--csv") == 0) {
+            csv = true;
+        } else if (strcmp(argv[i], "--ws") == 0) {
+            use_ws = true;
+        } else if (strcmp(argv[i], "--cache") == 0) {
+            use_cache = true;
+        } else if (strcmp(argv[i], "--key-ctx") == 0) {
+            use_key_ctx = true;
+        } else if (strcmp(argv[i], "--stack-header") == 0) {
+            stack_header = true;
+        } else if (num_selected < DSA_ALGO_COUNT && find_algo(argv[i], &selected[num_selected])) {
+            num_selected++;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (iterations <= 0) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (stack_header) {
+        return dsa_stack_profile_header(stdout, iterations) == 0 ? 0 : 1;
+    }
+#ifndef CONFIG_DSA_INSTRUMENTATION
+    if (csv) {
+        printf("--csv needs a build with -DCONFIG_DSA_INSTRUMENTATION=ON\n");
+        return 2;
+    }
+#endif
+    if (num_selected == 0) {
+        for (int i = 0; i < DSA_ALGO_COUNT; i++) {
+            if (dsa_get_descriptor((enum DSA_ALGO)i)) {
+                selected[num_selected++] = (enum DSA_ALGO)i;
+            }
+        }
+    }
+
+    if (use_ws) {
+        for (size_t i = 0; i < num_selected; i++) {
+            for (int o = 0; o < DSA_OP_COUNT; o++) {
+                size_t len = dsa_workspace_size(selected[i], (enum DSA_OP)o);
+                if (len > ws_len) {
+                    ws_len = len;
+                }
+            }
+        }
+        // Sets without a workspace still go through dsa_*_ws().
+        ws = malloc(ws_len ? ws_len : DSA_WORKSPACE_ALIGN);
+        if (!ws) {
+            printf("out of memory\n");
+            return 1;
+        }
+    }
+
+    if (use_cache) {
+        for (size_t i = 0; i < num_selected; i++) {
+            size_t len = dsa_sign_cache_size(selected[i]);
+            if (len > cache_len) {
+                cache_len = len;
+            }
+        }
+        cache = malloc(cache_len ? cache_len : 1);
+        if (!cache) {
+            printf("out of memory\n");
+            free(ws);
+            return 1;
+        }
+    }
+
+    printf("%d iterations, %zu byte message, times in microseconds", iterations, mlen);
+    if (use_ws) {
+        printf(", %zu byte workspace", ws_len);
+    }
+    if (use_cache) {
+        printf(", %zu byte signing cache", cache_len);
+    }
+    printf("\n");
+    printf("%-20s %12s %12s %12s %12s %12s %12s\n", "algorithm",
+           "keygen avg", "keygen min", "sign avg", "sign min", "verify avg", "verify min");
+
+    int failures = 0;
+    for (size_t i = 0; i < num_selected; i++) {
+        if (!bench_algo(selected[i], iterations, mlen)) {
+            failures++;
+        }
+    }
+    if (csv) {
+        printf("\n");
+        dsa_stats_dump_csv(stdout);
+    }
+    free(ws);
+    free(cache);
+    return failures ? 1 : 0;
+}
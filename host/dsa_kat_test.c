@@ -0,0 +1,332 @@
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dsa.h"
+#include "sha2.h"
+
+// Known-answer test of every compiled-in parameter set. Each set runs the
+// PQClean nistkat procedure: the NIST AES-256 CTR-DRBG seeded with bytes
+// 0..47 stands in for randombytes(), draws a 48-byte seed and a 33-byte
+// message, is reseeded with the seed, and then keygen and crypto_sign run
+// on it. The .rsp text this produces is hashed with SHA-256 and compared
+// with the hash recorded from the unmodified PQClean sources, so any change
+// to the output of keygen or signing fails here, as does a signature that
+// crypto_sign_open() rejects. Exits non-zero on any mismatch.
+
+struct kat_hash {
+    const char *name;
+    const char *sha256;
+};
+
+static const struct kat_hash expected[] = {
+    {"FALCON_512",
+     "8dac6d5dc897b3e9d58fc29a7a0cc7cc390083d7b769996282fe09de20e6bcbb"},
+    {"FALCON_1024",
+     "435cd603ebf0f334dd5f1ba70f237f905a8c75da299df1293f4df60b68bdc09b"},
+    {"FALCON_PADDED_512",
+     "e1a2024f3f4ef98d1163c66ef92f5c8c24b460cc6f1b9029b2b81a9102a1c0b8"},
+    {"FALCON_PADDED_1024",
+     "f885bb2d287e70d84c02ba62e0be9485c4103291623eff80315ef1e62c29ce76"},
+    {"ML_DSA_44",
+     "47f207a0efeb4d8b5831002f99df0ebf93f209b51d331b1edaa48e68d011abaa"},
+    {"ML_DSA_65",
+     "f7d1c9dc16f1da1ee6eb33a6e538a241bea62ba4ed8b64bbd09f14c6caca04e8"},
+    {"ML_DSA_87",
+     "2e9b91a3cc7166b5d56e49a99d2d0a006b11c10eecc1e27fe1518b23f48404a3"},
+    {"SPHINCS_SHA2_128F",
+     "55b77222ed89b6a1bf4f35760400725bf0a0002bea594ff471df6850f482acd3"},
+    {"SPHINCS_SHA2_128S",
+     "4e7092aad717e8f14539d18216b7a917e1159fa8355118dd7f9f05371a2f66fc"},
+    {"SPHINCS_SHA2_192F",
+     "5efab18cac985300bcf5efe85e1e778201f0c97946df4f3e43f4369cfa03448b"},
+    {"SPHINCS_SHA2_192S",
+     "c9271f03d165130afcc456590ee6ed14f7f424e33009b20547714443e82d6eee"},
+    {"SPHINCS_SHA2_256F",
+     "889433d156ce920b362cbc88964d43c5c09aae3a56a41dcf919f8ac50d267e75"},
+    {"SPHINCS_SHA2_256S",
+     "6fec8ab602c01c28e396c8e6270d8137a01a6f7b4aa1d34197ad3faf1d6f3da7"},
+    {"SPHINCS_SHAKE_128F",
+     "a1ec7f9a25cc49c06a6b5605876a261fd267bee3d4a93ac70c196a65d53d6a57"},
+    {"SPHINCS_SHAKE_128S",
+     "471f0f71699423f8375bdb3123e9c8a60f8303669594f569ca8efc499a13c89f"},
+    {"SPHINCS_SHAKE_192F",
+     "013905b4db0071412e7a0de4396d6ceccc85109829fd3fae7e15b92347151afc"},
+    {"SPHINCS_SHAKE_192S",
+     "534539fe5bf111480c95da5970984bcc83556160adaa0f12ae331a4a8a0668a5"},
+    {"SPHINCS_SHAKE_256F",
+     "f54c3b4d45075418dab8f9392956aaf9e0049f69f7a6f17946a0a3b42e533f2f"},
+    {"SPHINCS_SHAKE_256S",
+     "f8c9dceca4ab985df8343caa256367716a4b20aabe10cb9d48606129d0b03cc9"},
+};
+
+#define KAT_MLEN 33
+
+// AES-256 encryption of one block, as the DRBG needs it.
+
+static const uint8_t aes_sbox[256] = {
+    0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+    0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+    0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+    0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+    0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+    0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+    0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+    0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+    0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+    0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+    0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+    0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+    0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+    0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+    0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+    0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16,
+};
+
+static uint8_t xtime(uint8_t x) {
+    return (uint8_t)((x << 1) ^ ((x >> 7) * 0x1b));
+}
+
+static void aes256_ecb(const uint8_t key[32], const uint8_t in[16], uint8_t out[16]) {
+    uint8_t rk[240];
+    uint8_t s[16], t[16];
+    uint8_t rcon = 1;
+    int i, r, c;
+
+    memcpy(rk, key, 32);
+    for (i = 32; i < 240; i += 4) {
+        uint8_t w[4] = {rk[i - 4], rk[i - 3], rk[i - 2], rk[i - 1]};
+        if (i % 32 == 0) {
+            uint8_t w0 = w[0];
+            w[0] = aes_sbox[w[1]] ^ rcon;
+            w[1] = aes_sbox[w[2]];
+            w[2] = aes_sbox[w[3]];
+            w[3] = aes_sbox[w0];
+            rcon = xtime(rcon);
+        } else if (i % 32 == 16) {
+            for (c = 0; c < 4; c++) {
+                w[c] = aes_sbox[w[c]];
+            }
+        }
+        for (c = 0; c < 4; c++) {
+            rk[i + c] = rk[i - 32 + c] ^ w[c];
+        }
+    }
+
+    for (i = 0; i < 16; i++) {
+        s[i] = in[i] ^ rk[i];
+    }
+    for (r = 1; r <= 14; r++) {
+        // SubBytes and ShiftRows; the state is column-major
+        for (i = 0; i < 16; i++) {
+            t[i] = aes_sbox[s[(i + 4 * (i % 4)) % 16]];
+        }
+        if (r < 14) {
+            for (c = 0; c < 4; c++) {
+                uint8_t *col = &t[4 * c];
+                uint8_t all = col[0] ^ col[1] ^ col[2] ^ col[3];
+                uint8_t c0 = col[0];
+                col[0] ^= all ^ xtime(col[0] ^ col[1]);
+                col[1] ^= all ^ xtime(col[1] ^ col[2]);
+                col[2] ^= all ^ xtime(col[2] ^ col[3]);
+                col[3] ^= all ^ xtime(col[3] ^ c0);
+            }
+        }
+        for (i = 0; i < 16; i++) {
+            s[i] = t[i] ^ rk[16 * r + i];
+        }
+    }
+    memcpy(out, s, 16);
+}
+
+// The NIST AES-256 CTR-DRBG of the PQC KAT generators, without
+// derivation function or prediction resistance.
+
+static struct {
+    uint8_t key[32];
+    uint8_t v[16];
+} drbg;
+
+static void drbg_increment_v(void) {
+    for (int j = 15; j >= 0; j--) {
+        if (++drbg.v[j] != 0) {
+            break;
+        }
+    }
+}
+
+static void drbg_update(const uint8_t provided[48]) {
+    uint8_t temp[48];
+
+    for (int i = 0; i < 3; i++) {
+        drbg_increment_v();
+        aes256_ecb(drbg.key, drbg.v, &temp[16 * i]);
+    }
+    if (provided) {
+        for (int i = 0; i < 48; i++) {
+            temp[i] ^= provided[i];
+        }
+    }
+    memcpy(drbg.key, temp, 32);
+    memcpy(drbg.v, temp + 32, 16);
+}
+
+static void drbg_init(const uint8_t entropy[48]) {
+    memset(&drbg, 0, sizeof(drbg));
+    drbg_update(entropy);
+}
+
+// Replaces the randombytes() of the component for this executable.
+int PQCLEAN_randombytes(uint8_t *out, size_t n) {
+    uint8_t block[16];
+
+    while (n > 0) {
+        size_t take = n < 16 ? n : 16;
+        drbg_increment_v();
+        aes256_ecb(drbg.key, drbg.v, block);
+        memcpy(out, block, take);
+        out += take;
+        n -= take;
+    }
+    drbg_update(NULL);
+    return 0;
+}
+
+// The .rsp text, gathered in memory to be hashed.
+
+struct rsp {
+    char *buf;
+    size_t len;
+    size_t cap;
+};
+
+static void rsp_printf(struct rsp *rsp, const char *fmt, ...) {
+    va_list ap;
+    int n;
+
+    va_start(ap, fmt);
+    n = vsnprintf(NULL, 0, fmt, ap);
+    va_end(ap);
+    if (rsp->len + (size_t)n + 1 > rsp->cap) {
+        rsp->cap = (rsp->len + (size_t)n + 1) * 2;
+        rsp->buf = realloc(rsp->buf, rsp->cap);
+        if (!rsp->buf) {
+            fprintf(stderr, "out of memory\n");
+            exit(1);
+        }
+    }
+    va_start(ap, fmt);
+    vsnprintf(rsp->buf + rsp->len, (size_t)n + 1, fmt, ap);
+    va_end(ap);
+    rsp->len += (size_t)n;
+}
+
+static void rsp_bytes(struct rsp *rsp, const char *label, const uint8_t *p, size_t len) {
+    rsp_printf(rsp, "%s", label);
+    for (size_t i = 0; i < len; i++) {
+        rsp_printf(rsp, "%02X", p[i]);
+    }
+    if (len == 0) {
+        rsp_printf(rsp, "00");
+    }
+    rsp_printf(rsp, "\n");
+}
+
+// Writes the .rsp text of one parameter set; returns -1 if an operation
+// fails or crypto_sign_open() does not give the message back.
+static int run_kat(const struct dsa_descriptor *d, struct rsp *rsp) {
+    uint8_t entropy[48];
+    uint8_t seed[48];
+    uint8_t m[KAT_MLEN];
+    uint8_t *pk = malloc(d->pk_len);
+    uint8_t *sk = malloc(d->sk_len);
+    uint8_t *sm = malloc(d->sig_len + KAT_MLEN);
+    uint8_t *m1 = malloc(d->sig_len + KAT_MLEN);
+    size_t smlen = 0, mlen1 = 0;
+    int ret = -1;
+
+    if (!pk || !sk || !sm || !m1) {
+        goto out;
+    }
+    for (int i = 0; i < 48; i++) {
+        entropy[i] = (uint8_t)i;
+    }
+    drbg_init(entropy);
+
+    rsp_printf(rsp, "# %s\n\n", d->name);
+    rsp_printf(rsp, "count = 0\n");
+    PQCLEAN_randombytes(seed, sizeof(seed));
+    rsp_bytes(rsp, "seed = ", seed, sizeof(seed));
+    rsp_printf(rsp, "mlen = %u\n", KAT_MLEN);
+    PQCLEAN_randombytes(m, sizeof(m));
+    rsp_bytes(rsp, "msg = ", m, sizeof(m));
+
+    drbg_init(seed);
+    if (d->keypair(pk, sk) != 0) {
+        goto out;
+    }
+    rsp_bytes(rsp, "pk = ", pk, d->pk_len);
+    rsp_bytes(rsp, "sk = ", sk, d->sk_len);
+    if (d->sign(sm, &smlen, m, sizeof(m), sk) != 0) {
+        goto out;
+    }
+    rsp_printf(rsp, "smlen = %zu\n", smlen);
+    rsp_bytes(rsp, "sm = ", sm, smlen);
+    rsp_printf(rsp, "\n");
+
+    if (d->open(m1, &mlen1, sm, smlen, pk) != 0 || mlen1 != sizeof(m) ||
+            memcmp(m1, m, sizeof(m)) != 0) {
+        goto out;
+    }
+    ret = 0;
+out:
+    free(pk);
+    free(sk);
+    free(sm);
+    free(m1);
+    return ret;
+}
+
+static const char *expected_hash(const char *name) {
+    for (size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); i++) {
+        if (strcmp(expected[i].name, name) == 0) {
+            return expected[i].sha256;
+        }
+    }
+    return NULL;
+}
+
+int main(void) {
+    int failed = 0;
+
+    for (int a = 0; a < DSA_ALGO_COUNT; a++) {
+        const struct dsa_descriptor *d = dsa_get_descriptor((enum DSA_ALGO)a);
+        struct rsp rsp = {0};
+        uint8_t digest[32];
+        char hex[65];
+        const char *want;
+
+        if (!d) {
+            continue;
+        }
+        if (run_kat(d, &rsp) != 0) {
+            printf("%-20s FAILED (keygen, sign or open)\n", d->name);
+            failed = 1;
+            free(rsp.buf);
+            continue;
+        }
+        sha256(digest, (const uint8_t *)rsp.buf, rsp.len);
+        free(rsp.buf);
+        for (int i = 0; i < 32; i++) {
+            snprintf(&hex[2 * i], 3, "%02x", digest[i]);
+        }
+        want = expected_hash(d->name);
+        if (!want || strcmp(hex, want) != 0) {
+            printf("%-20s FAILED %s, expected %s\n", d->name, hex, want ? want : "(none)");
+            failed = 1;
+        } else {
+            printf("%-20s ok %s\n", d->name, hex);
+        }
+    }
+    return failed;
+}
@@ -0,0 +1,68 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fips202.h"
+#include "test_util.h"
+
+// Checks the 4-way Keccak of common/fips202.c (AVX2 where the host has it)
+// against the single-instance permutation it falls back to, on random
+// states, and the 4-way SHAKE functions against four single-instance calls
+// on random inputs.
+
+#define TEST_MAX_INLEN 500
+#define TEST_MAX_OUTLEN 700
+
+static void test_permute(void) {
+    keccakx4_state x4;
+    uint64_t single[4][25];
+
+    for (int r = 0; r < TEST_ROUNDS; r++) {
+        rng_fill(single, sizeof(single));
+        for (int i = 0; i < 25; i++) {
+            for (int j = 0; j < 4; j++) {
+                x4.s[4 * i + j] = single[j][i];
+            }
+        }
+        keccakf1600x4_permute(&x4);
+        for (int j = 0; j < 4; j++) {
+            keccakf1600_permute(single[j]);
+        }
+        int ok = 1;
+        for (int i = 0; i < 25; i++) {
+            for (int j = 0; j < 4; j++) {
+                ok &= x4.s[4 * i + j] == single[j][i];
+            }
+        }
+        check(ok, "keccakf1600x4_permute", r);
+    }
+    printf("Keccak-f[1600] x4: %d rounds\n", TEST_ROUNDS);
+}
+
+typedef void (*shake_fn)(uint8_t *output, size_t outlen, const uint8_t *input, size_t inlen);
+typedef void (*shake_x4_fn)(uint8_t *out0, uint8_t *out1, uint8_t *out2, uint8_t *out3,
+                            size_t outlen, const uint8_t *in0, const uint8_t *in1,
+                            const uint8_t *in2, const uint8_t *in3, size_t inlen);
+
+static void test_shake(const char *what, shake_fn one, shake_x4_fn four) {
+    static uint8_t in[4][TEST_MAX_INLEN];
+    static uint8_t out[4][TEST_MAX_OUTLEN], want[4][TEST_MAX_OUTLEN];
+
+    for (int r = 0; r < TEST_ROUNDS; r++) {
+        size_t inlen = (size_t)(rng_next() % (TEST_MAX_INLEN + 1));
+        size_t outlen = (size_t)(rng_next() % (TEST_MAX_OUTLEN + 1));
+        rng_fill(in, sizeof(in));
+        four(out[0], out[1], out[2], out[3], outlen, in[0], in[1], in[2], in[3], inlen);
+        for (int j = 0; j < 4; j++) {
+            one(want[j], outlen, in[j], inlen);
+            check(memcmp(out[j], want[j], outlen) == 0, what, r);
+        }
+    }
+    printf("%s: %d rounds\n", what, TEST_ROUNDS);
+}
+
+int main(void) {
+    test_permute();
+    test_shake("shake128x4", shake128, shake128x4);
+    test_shake("shake256x4", shake256, shake256x4);
+    return failures != 0;
+}
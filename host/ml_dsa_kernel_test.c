@@ -0,0 +1,186 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Checks the NTT and polynomial kernels of one ML-DSA parameter set, whose
+// directory is on the include path, on random inputs: the merged-layer
+// NTT and inverse NTT with 32-bit Montgomery multiplications against the
+// layer-by-layer PQClean reference, the AVX2 NTT, inverse NTT and
+// pointwise product against their portable versions, all of them equal
+// exactly, and the uniform rejection sampler against the PQClean loop.
+// The sources are included so that the static kernels can be called.
+#include "ntt.c"
+#include "poly.c"
+
+#define TEST_ROUNDS 500
+#include "test_util.h"
+
+// Coefficients in (-bound, bound)
+static void rng_poly(int32_t a[N], int32_t bound) {
+    for (int i = 0; i < N; i++) {
+        a[i] = (int32_t)(rng_next() % (uint64_t)(2 * bound - 1)) - (bound - 1);
+    }
+}
+
+// The PQClean reference: 64-bit Montgomery reduction, one layer at a time.
+
+static int32_t ref_montgomery_reduce(int64_t a) {
+    int32_t t = (int32_t)((uint64_t)a * (uint64_t)QINV);
+    return (int32_t)((a - (int64_t)t * Q) >> 32);
+}
+
+static void ref_ntt(int32_t a[N]) {
+    unsigned int len, start, j, k = 0;
+    int32_t zeta, t;
+
+    for (len = 128; len > 0; len >>= 1) {
+        for (start = 0; start < N; start = j + len) {
+            zeta = zetas[++k];
+            for (j = start; j < start + len; ++j) {
+                t = ref_montgomery_reduce((int64_t)zeta * a[j + len]);
+                a[j + len] = a[j] - t;
+                a[j] = a[j] + t;
+            }
+        }
+    }
+}
+
+static void ref_invntt_tomont(int32_t a[N]) {
+    unsigned int start, len, j, k = 256;
+    int32_t t, zeta;
+    const int32_t f = 41978;
+
+    for (len = 1; len < N; len <<= 1) {
+        for (start = 0; start < N; start = j + len) {
+            zeta = -zetas[--k];
+            for (j = start; j < start + len; ++j) {
+                t = a[j];
+                a[j] = t + a[j + len];
+                a[j + len] = t - a[j + len];
+                a[j + len] = ref_montgomery_reduce((int64_t)zeta * a[j + len]);
+            }
+        }
+    }
+    for (j = 0; j < N; ++j) {
+        a[j] = ref_montgomery_reduce((int64_t)f * a[j]);
+    }
+}
+
+static unsigned int ref_rej_uniform(int32_t *a, unsigned int len,
+                                    const uint8_t *buf, unsigned int buflen) {
+    unsigned int ctr = 0, pos = 0;
+    uint32_t t;
+
+    while (ctr < len && pos + 3 <= buflen) {
+        t = buf[pos++];
+        t |= (uint32_t)buf[pos++] << 8;
+        t |= (uint32_t)buf[pos++] << 16;
+        t &= 0x7FFFFF;
+        if (t < Q) {
+            a[ctr++] = (int32_t)t;
+        }
+    }
+    return ctr;
+}
+
+static void test_ntt(void) {
+    int32_t in[N], want[N], got[N];
+
+    for (int r = 0; r < TEST_ROUNDS; r++) {
+        rng_poly(in, Q);
+        memcpy(want, in, sizeof(in));
+        memcpy(got, in, sizeof(in));
+        ref_ntt(want);
+        ntt_portable(got);
+        check(memcmp(want, got, sizeof(want)) == 0, "merged NTT", r);
+
+        memcpy(want, in, sizeof(in));
+        memcpy(got, in, sizeof(in));
+        ref_invntt_tomont(want);
+        invntt_portable(got);
+        check(memcmp(want, got, sizeof(want)) == 0, "merged inverse NTT", r);
+    }
+    printf("merged NTT and inverse NTT: %d rounds\n", TEST_ROUNDS);
+}
+
+#ifdef NTT_AVX2
+static void test_ntt_avx2(void) {
+    int32_t in[N], want[N], got[N];
+
+    if (!cpu_has_avx2()) {
+        printf("AVX2 NTT: skipped, not supported by this CPU\n");
+        return;
+    }
+    for (int r = 0; r < TEST_ROUNDS; r++) {
+        rng_poly(in, Q);
+        memcpy(want, in, sizeof(in));
+        memcpy(got, in, sizeof(in));
+        ntt_portable(want);
+        ntt_avx2(got);
+        check(memcmp(want, got, sizeof(want)) == 0, "AVX2 NTT", r);
+
+        memcpy(want, in, sizeof(in));
+        memcpy(got, in, sizeof(in));
+        invntt_portable(want);
+        invntt_avx2(got);
+        check(memcmp(want, got, sizeof(want)) == 0, "AVX2 inverse NTT", r);
+    }
+    printf("AVX2 NTT and inverse NTT: %d rounds\n", TEST_ROUNDS);
+}
+#endif
+
+#ifdef POLY_AVX2
+static void test_pointwise_avx2(void) {
+    poly a, b, want, got;
+
+    if (!cpu_has_avx2()) {
+        printf("AVX2 pointwise product: skipped, not supported by this CPU\n");
+        return;
+    }
+    for (int r = 0; r < TEST_ROUNDS; r++) {
+        // Up to the 9 Q an unreduced NTT output can reach
+        int32_t bound = r % 2 ? 9 * Q : Q;
+        rng_poly(a.coeffs, bound);
+        rng_poly(b.coeffs, bound);
+        pointwise_montgomery_portable(&want, &a, &b);
+        pointwise_montgomery_avx2(&got, &a, &b);
+        check(memcmp(&want, &got, sizeof(want)) == 0, "AVX2 pointwise product", r);
+    }
+    printf("AVX2 pointwise product: %d rounds\n", TEST_ROUNDS);
+}
+#endif
+
+static void test_rej_uniform(void) {
+    uint8_t buf[5 * 168 + 2];
+    int32_t want[N], got[N];
+
+    for (int r = 0; r < TEST_ROUNDS; r++) {
+        unsigned int len = 1 + (unsigned int)(rng_next() % N);
+        unsigned int buflen = (unsigned int)(rng_next() % (sizeof(buf) + 1));
+        rng_fill(buf, sizeof(buf));
+        // Push some candidates to Q and above, so that rejections occur
+        for (unsigned int i = 2; i < buflen; i += 3 * (1 + (unsigned int)(rng_next() % 4))) {
+            buf[i] |= 0x7F;
+        }
+        memset(want, 0, sizeof(want));
+        memset(got, 0, sizeof(got));
+        unsigned int ctr_want = ref_rej_uniform(want, len, buf, buflen);
+        unsigned int ctr_got = rej_uniform(got, len, buf, buflen);
+        check(ctr_want == ctr_got && memcmp(want, got, sizeof(want)) == 0,
+              "uniform rejection sampling", r);
+    }
+    printf("uniform rejection sampling: %d rounds\n", TEST_ROUNDS);
+}
+
+int main(void) {
+    printf("ML-DSA, K = %d, L = %d\n", K, L);
+    test_ntt();
+#ifdef NTT_AVX2
+    test_ntt_avx2();
+#endif
+#ifdef POLY_AVX2
+    test_pointwise_avx2();
+#endif
+    test_rej_uniform();
+    return failures != 0;
+}
@@ -0,0 +1,160 @@
+#include <stdio.h>
+
+// Checks the SHA-256 compression kernels of common/sha2.c against its
+// portable compression on random inputs: the SHA extensions and the eight
+// AVX2 lanes directly, where the host has them, and the midstate API (which
+// picks a kernel at run time) against a digest computed with the portable
+// compression alone. The source is included so that the static kernels can
+// be called; this executable does not link the component.
+#include "sha2.c"
+#include "test_util.h"
+
+#define TEST_MAX_BLOCKS 8
+
+// SHA-256 of prefix || in with the portable compression only.
+static void ref_sha256(uint8_t out[32], const uint8_t *prefix, size_t prefixlen,
+                       const uint8_t *in, size_t inlen) {
+    uint8_t *msg = malloc(prefixlen + inlen + 128);
+    uint32_t state[8];
+    size_t len = prefixlen + inlen;
+    size_t padded = (len + 9 + 63) / 64 * 64;
+
+    memcpy(msg, prefix, prefixlen);
+    memcpy(msg + prefixlen, in, inlen);
+    memset(msg + len, 0, padded - len);
+    msg[len] = 0x80;
+    for (int i = 0; i < 8; i++) {
+        msg[padded - 1 - i] = (uint8_t)((uint64_t)len << 3 >> (8 * i));
+    }
+    for (int i = 0; i < 8; i++) {
+        state[i] = load_bigendian_32(iv_256 + 4 * i);
+    }
+    hashblocks_sha256_portable(state, msg, padded);
+    for (int i = 0; i < 8; i++) {
+        store_bigendian_32(out + 4 * i, state[i]);
+    }
+    free(msg);
+}
+
+#ifdef SHA2_SHANI
+static void test_shani(void) {
+    uint8_t in[64 * TEST_MAX_BLOCKS + 63];
+    uint32_t want[8], got[8];
+
+    if (!cpu_has_shani()) {
+        printf("SHA-NI compression: skipped, not supported by this CPU\n");
+        return;
+    }
+    for (int r = 0; r < TEST_ROUNDS; r++) {
+        size_t inlen = (size_t)(rng_next() % sizeof(in));
+        rng_fill(want, sizeof(want));
+        memcpy(got, want, sizeof(got));
+        rng_fill(in, inlen);
+        size_t left_want = hashblocks_sha256_portable(want, in, inlen);
+        size_t left_got = hashblocks_sha256_shani(got, in, inlen);
+        check(left_want == left_got && memcmp(want, got, sizeof(want)) == 0,
+              "SHA-NI compression", r);
+    }
+    printf("SHA-NI compression: %d rounds\n", TEST_ROUNDS);
+}
+#endif
+
+#ifdef SHA2_AVX2
+static void test_avx2_x8(void) {
+    uint8_t in[8][64 * TEST_MAX_BLOCKS];
+    const uint8_t *p[8];
+    uint32_t want[8][8], got[8][8];
+
+    if (!cpu_has_avx2()) {
+        printf("AVX2 x8 compression: skipped, not supported by this CPU\n");
+        return;
+    }
+    for (int l = 0; l < 8; l++) {
+        p[l] = in[l];
+    }
+    for (int r = 0; r < TEST_ROUNDS; r++) {
+        size_t lanes = 1 + (size_t)(rng_next() % 8);
+        size_t inlen = 64 * (size_t)(rng_next() % (TEST_MAX_BLOCKS + 1));
+        rng_fill(in, sizeof(in));
+        rng_fill(want, sizeof(want));
+        memcpy(got, want, sizeof(got));
+        for (size_t l = 0; l < lanes; l++) {
+            hashblocks_sha256_portable(want[l], in[l], inlen);
+        }
+        hashblocks_sha256x8_avx2(got, p, lanes, inlen);
+        check(memcmp(want, got, sizeof(want[0]) * lanes) == 0, "AVX2 x8 compression", r);
+    }
+    printf("AVX2 x8 compression: %d rounds\n", TEST_ROUNDS);
+}
+#endif
+
+static void test_midstate(void) {
+    uint8_t prefix[64 * 2];
+    uint8_t in[8][200];
+    uint8_t block[8][64];
+    uint8_t out[8][32], want[8][32];
+    uint8_t *outp[8];
+    const uint8_t *inp[8], *blockp[8];
+    uint32_t midstate[8];
+
+    for (int l = 0; l < 8; l++) {
+        outp[l] = out[l];
+        inp[l] = in[l];
+        blockp[l] = block[l];
+    }
+    for (int r = 0; r < TEST_ROUNDS; r++) {
+        size_t prefixblocks = (size_t)(rng_next() % 3);
+        size_t prefixlen = 64 * prefixblocks;
+        size_t inlen = (size_t)(rng_next() % sizeof(in[0]));
+        size_t shortlen = (size_t)(rng_next() % 56);
+
+        rng_fill(prefix, sizeof(prefix));
+        rng_fill(in, sizeof(in));
+        sha256_midstate_init(midstate, prefix, prefixblocks);
+
+        sha256_midstate_finalize(out[0], midstate, prefixlen, in[0], inlen);
+        ref_sha256(want[0], prefix, prefixlen, in[0], inlen);
+        check(memcmp(out[0], want[0], 32) == 0, "sha256_midstate_finalize", r);
+
+        sha256x4_midstate_finalize(outp, midstate, prefixlen, inp, inlen);
+        for (int l = 0; l < 4; l++) {
+            ref_sha256(want[l], prefix, prefixlen, in[l], inlen);
+        }
+        check(memcmp(out, want, 4 * 32) == 0, "sha256x4_midstate_finalize", r);
+
+        sha256x8_midstate_finalize(outp, midstate, prefixlen, inp, inlen);
+        for (int l = 0; l < 8; l++) {
+            ref_sha256(want[l], prefix, prefixlen, in[l], inlen);
+        }
+        check(memcmp(out, want, 8 * 32) == 0, "sha256x8_midstate_finalize", r);
+
+        memcpy(block[0], in[0], shortlen);
+        sha256_midstate_finalize_block(out[0], midstate, prefixlen, block[0], shortlen);
+        ref_sha256(want[0], prefix, prefixlen, in[0], shortlen);
+        check(memcmp(out[0], want[0], 32) == 0, "sha256_midstate_finalize_block", r);
+
+        for (int l = 0; l < 4; l++) {
+            memcpy(block[l], in[l], shortlen);
+            sha256_midstate_pad_block(block[l], shortlen, prefixlen);
+            ref_sha256(want[l], prefix, prefixlen, in[l], shortlen);
+        }
+        sha256_midstate_compress_block(out[0], 32, midstate, block[0]);
+        check(memcmp(out[0], want[0], 32) == 0, "sha256_midstate_compress_block", r);
+        sha256x4_midstate_compress_block(outp, 16, midstate, blockp);
+        for (int l = 0; l < 4; l++) {
+            check(memcmp(out[l], want[l], 16) == 0, "sha256x4_midstate_compress_block", r);
+        }
+    }
+    printf("SHA-256 midstate API: %d rounds\n", TEST_ROUNDS);
+}
+
+int main(void) {
+#ifdef SHA2_SHANI
+    test_shani();
+#endif
+#ifdef SHA2_AVX2
+    test_avx2_x8();
+#endif
+    test_midstate();
+    return failures != 0;
+}
@@ -0,0 +1,43 @@
+#ifndef TEST_UTIL_H
+#define TEST_UTIL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Shared by the kernel tests, which compare an optimized kernel with the
+// code it replaces on TEST_ROUNDS random inputs. Each mismatch is reported
+// by check() and counted in failures, and main() returns failures != 0,
+// so a test exits non-zero on any mismatch.
+
+#ifndef TEST_ROUNDS
+#define TEST_ROUNDS 200
+#endif
+
+// xorshift64, with a fixed seed so that a failing round can be repeated
+static uint64_t rng_state = 0x9E3779B97F4A7C15ull;
+
+static uint64_t rng_next(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static void rng_fill(void *p, size_t len) {
+    uint8_t *b = p;
+    for (size_t i = 0; i < len; i++) {
+        b[i] = (uint8_t)(rng_next() >> 24);
+    }
+}
+
+static int failures;
+
+static void check(int ok, const char *what, int round) {
+    if (!ok) {
+        printf("FAILED %s, round %d\n", what, round);
+        failures++;
+    }
+}
+
+#endif
@@ -101,7 +101,9 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_
                     .content = msg_buf,
                     .size = msg_len
                 };
-                if (xQueueSend(receive_queue, &msg, pdMS_TO_TICKS(50)) != pdTRUE) {
+                // Bounded, as this runs on the MQTT client task
+                if (xQueueSend(receive_queue, &msg, pdMS_TO_TICKS(RECEIVE_QUEUE_TIMEOUT_MS)) != pdTRUE) {
+                    printf("Receive queue full, dropped a %d byte frame\n", msg_len);
                     free(msg_buf);
                 }
                 hdr_bytes = 0;
@@ -141,7 +143,7 @@ static void wifi_event_handler(void *event_handler_arg, esp_event_base_t event_b
     else if (event_id == IP_EVENT_STA_GOT_IP) {
         printf("Wifi got IP...\n\n");
         // Start MQTT client
-        receive_queue = xQueueCreate(2, sizeof(message_struct_t));
+        receive_queue = xQueueCreate(RECEIVE_QUEUE_LENGTH, sizeof(message_struct_t));
 
         esp_mqtt_client_config_t mqtt_cfg = {
             .broker.address.uri = BROKER_URI,
@@ -18,7 +18,7 @@ QueueHandle_t uart_queue;
 bool initialized = false;
 
 void setup_transport(){
-    receive_queue = xQueueCreate(5, sizeof(message_struct_t));
+    receive_queue = xQueueCreate(RECEIVE_QUEUE_LENGTH, sizeof(message_struct_t));
 
     ESP_ERROR_CHECK(uart_driver_install(uart_num, uart_buffer_size, 0, 10, &uart_queue, 0));
     uart_config_t uart_config = {
@@ -96,7 +96,8 @@ void receive_task(void *arg){
         if((uint16_t)data_read != len) printf("Wrong read. Read %d, Expected %d", (uint16_t)data_read, len);
 
         message_struct_t msg = { .content = data, .size = len };
-        if (xQueueSend(receive_queue, &msg, pdMS_TO_TICKS(50)) != pdTRUE) {
+        if (xQueueSend(receive_queue, &msg, pdMS_TO_TICKS(RECEIVE_QUEUE_TIMEOUT_MS)) != pdTRUE) {
+            printf("Receive queue full, dropped a %u byte frame\n", len);
             free(data);
         }
     }
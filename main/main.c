@@ -2,6 +2,7 @@
 #include <string.h>
 #include <stdbool.h>
 #include "dsa.h"
+#include "dsa_stats.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
@@ -14,6 +15,10 @@
     #define ROLE_BOB
 #endif
 
+// The profiling mode has to fit every algorithm before any budget is known.
+#define STACK_PROFILE_TASK_STACK_SIZE 130000
+#define STACK_PROFILE_ITERATIONS 3
+
 static const char* message = "Test message for DSA";
 static const char* ready_message = "ready";
 static const char* ack_message = "ack";
@@ -25,67 +30,298 @@ enum ROLE {
 };
 
 enum DSA_ALGO algorithms[] = {
+#ifdef CONFIG_DSA_FALCON_512
     FALCON_512,
+#endif
+#ifdef CONFIG_DSA_FALCON_1024
     FALCON_1024,
+#endif
+#ifdef CONFIG_DSA_FALCON_PADDED_512
     FALCON_PADDED_512,
+#endif
+#ifdef CONFIG_DSA_FALCON_PADDED_1024
     FALCON_PADDED_1024,
+#endif
+#ifdef CONFIG_DSA_ML_DSA_44
     ML_DSA_44,
+#endif
+#ifdef CONFIG_DSA_ML_DSA_65
     ML_DSA_65,
+#endif
+#ifdef CONFIG_DSA_ML_DSA_87
     ML_DSA_87,
+#endif
+#ifdef CONFIG_DSA_SPHINCS_SHA2_128F
     SPHINCS_SHA2_128F,
+#endif
+#ifdef CONFIG_DSA_SPHINCS_SHA2_128S
     SPHINCS_SHA2_128S,
+#endif
+#ifdef CONFIG_DSA_SPHINCS_SHA2_192F
     SPHINCS_SHA2_192F,
+#endif
+#ifdef CONFIG_DSA_SPHINCS_SHA2_192S
     SPHINCS_SHA2_192S,
+#endif
+#ifdef CONFIG_DSA_SPHINCS_SHA2_256F
     SPHINCS_SHA2_256F,
+#endif
+#ifdef CONFIG_DSA_SPHINCS_SHA2_256S
     SPHINCS_SHA2_256S,
+#endif
+#ifdef CONFIG_DSA_SPHINCS_SHAKE_128F
     SPHINCS_SHAKE_128F,
+#endif
+#ifdef CONFIG_DSA_SPHINCS_SHAKE_128S
     SPHINCS_SHAKE_128S,
+#endif
+#ifdef CONFIG_DSA_SPHINCS_SHAKE_192F
     SPHINCS_SHAKE_192F,
+#endif
+#ifdef CONFIG_DSA_SPHINCS_SHAKE_192S
     SPHINCS_SHAKE_192S,
+#endif
+#ifdef CONFIG_DSA_SPHINCS_SHAKE_256F
     SPHINCS_SHAKE_256F,
-    SPHINCS_SHAKE_256S
+#endif
+#ifdef CONFIG_DSA_SPHINCS_SHAKE_256S
+    SPHINCS_SHAKE_256S,
+#endif
 };
 size_t num_algorithms = sizeof(algorithms) / sizeof(algorithms[0]);
 
 
-int crypto_sign_message(
-    uint8_t* sm, size_t* smlen,
-    const uint8_t* m, size_t mlen, const uint8_t* sk, 
-    enum DSA_ALGO algo) {
-        uint8_t* signature = malloc(get_signature_length(algo));
-        size_t signature_len = 0;
-        if (!signature) return -1;
-
-        uint8_t hdr[2] = {(uint16_t)mlen >> 8, (uint16_t)mlen & 0xFF };
-        dsa_signature(algo, signature, &signature_len, m, mlen, sk);
-
-        memcpy(sm, hdr, 2);
-        memcpy(sm + 2, m, mlen);
-        memcpy(sm + 2 + mlen, signature, signature_len);
-        free(signature);
-        *smlen = 2 + mlen + signature_len;
-        return 0;
+// Signatures go out in frames of up to SIGNATURE_FRAME_BYTES: the pieces
+// handed over by the signer are gathered into frame buffers, which a sender
+// task transmits while the signer fills the next one, since send_message()
+// blocks until a frame is out (and pauses after it on UART). With
+// CONFIG_TEST_STREAM_SIGNATURES the pieces come from dsa_signature_stream()
+// as they are computed, so neither side ever holds a whole SPHINCS+
+// signature; otherwise the signature is computed first with dsa_signature(),
+// which can use both cores (CONFIG_DSA_SPHINCS_PARALLEL), and then framed.
+// Alice sends the message in one frame, then the signature frames, which
+// Bob verifies as they arrive.
+#define SIGNATURE_FRAME_BUFFERS 2
+#define SENDER_TASK_STACK_SIZE 4096
+
+struct frame {
+    uint8_t *data;
+    size_t len;                 // 0 tells the sender task to stop
+};
+
+struct frame_sink {
+    QueueHandle_t free_frames;  // empty buffers, for the signer
+    QueueHandle_t full_frames;  // frames waiting for the sender task
+    TaskHandle_t signer;
+    struct frame frame;         // being filled by the signer
+    size_t total;
+    volatile bool failed;       // set by the sender task
+};
+
+static void frame_sender_task(void *arg) {
+    struct frame_sink *sink = arg;
+    struct frame frame;
+    for (;;) {
+        xQueueReceive(sink->full_frames, &frame, portMAX_DELAY);
+        if (frame.len == 0) {
+            break;
+        }
+        if (!sink->failed && send_message(frame.data, frame.len) < 0) {
+            sink->failed = true;
+        }
+        xQueueSend(sink->free_frames, &frame, portMAX_DELAY);
     }
+    xTaskNotifyGive(sink->signer);
+    vTaskDelete(NULL);
+}
 
-int crypto_open_message(
-    uint8_t* m, size_t* mlen,
-    const uint8_t* sm, size_t smlen, const uint8_t* pk,
-    enum DSA_ALGO algo) {
-        *mlen = ((size_t)sm[0] << 8) | sm[1];
+// Hands the frame being filled to the sender task and takes an empty one,
+// waiting for the sender if every other buffer is still queued.
+static int flush_frame(struct frame_sink *sink) {
+    if (sink->frame.len > 0) {
+        xQueueSend(sink->full_frames, &sink->frame, portMAX_DELAY);
+        xQueueReceive(sink->free_frames, &sink->frame, portMAX_DELAY);
+        sink->frame.len = 0;
+    }
+    return sink->failed ? -1 : 0;
+}
+
+static void frame_sink_free(struct frame_sink *sink) {
+    struct frame frame;
+    if (sink->free_frames) {
+        while (xQueueReceive(sink->free_frames, &frame, 0) == pdTRUE) {
+            free(frame.data);
+        }
+        vQueueDelete(sink->free_frames);
+    }
+    if (sink->full_frames) {
+        vQueueDelete(sink->full_frames);
+    }
+    free(sink->frame.data);
+}
 
-        uint8_t* signature = malloc(get_signature_length(algo));
-        size_t signature_len = smlen - *mlen - 2;
-        if (!signature) return -1;
+static int frame_sink_start(struct frame_sink *sink) {
+    memset(sink, 0, sizeof(*sink));
+    sink->signer = xTaskGetCurrentTaskHandle();
+    sink->free_frames = xQueueCreate(SIGNATURE_FRAME_BUFFERS, sizeof(struct frame));
+    sink->full_frames = xQueueCreate(SIGNATURE_FRAME_BUFFERS, sizeof(struct frame));
+    sink->frame.data = malloc(SIGNATURE_FRAME_BYTES);
+    if (!sink->free_frames || !sink->full_frames || !sink->frame.data) {
+        frame_sink_free(sink);
+        return -1;
+    }
+    for (int i = 1; i < SIGNATURE_FRAME_BUFFERS; i++) {
+        struct frame frame = { malloc(SIGNATURE_FRAME_BYTES), 0 };
+        if (!frame.data) {
+            frame_sink_free(sink);
+            return -1;
+        }
+        xQueueSend(sink->free_frames, &frame, 0);
+    }
+    // The test task runs on core 0
+    if (xTaskCreatePinnedToCore(&frame_sender_task, "frame_sender_task", SENDER_TASK_STACK_SIZE,
+            sink, 2, NULL, 1) != pdPASS) {
+        frame_sink_free(sink);
+        return -1;
+    }
+    return 0;
+}
 
-        memcpy(signature, sm + 2 + *mlen, signature_len);
+// Sends what is left, stops the sender task once every frame is out and
+// frees the buffers.
+static int frame_sink_finish(struct frame_sink *sink) {
+    int ret = flush_frame(sink);
+    struct frame stop = { NULL, 0 };
+    xQueueSend(sink->full_frames, &stop, portMAX_DELAY);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    if (sink->failed) {
+        ret = -1;
+    }
+    frame_sink_free(sink);
+    return ret;
+}
 
-        if (dsa_verify(algo, signature, signature_len, sm + 2, *mlen, pk) < 0) {
-            free(signature);
+static int send_signature_piece(void *arg, const uint8_t *data, size_t len) {
+    struct frame_sink *sink = arg;
+    sink->total += len;
+    while (len > 0) {
+        size_t n = SIGNATURE_FRAME_BYTES - sink->frame.len;
+        if (n > len) {
+            n = len;
+        }
+        memcpy(sink->frame.data + sink->frame.len, data, n);
+        sink->frame.len += n;
+        data += n;
+        len -= n;
+        if (sink->frame.len == SIGNATURE_FRAME_BYTES && flush_frame(sink) != 0) {
             return -1;
         }
+    }
+    return 0;
+}
+
+#ifndef CONFIG_TEST_STREAM_SIGNATURES
+// Signs into a heap buffer, then hands the signature over like
+// dsa_signature_stream() would.
+static int sign_then_send(const uint8_t* m, size_t mlen, const uint8_t* sk,
+    enum DSA_ALGO algo, struct frame_sink* sink) {
+        size_t siglen = 0;
+        uint8_t* sig = malloc(get_signature_length(algo));
+        if (!sig) return -1;
+
+        int ret = dsa_signature(algo, sig, &siglen, m, mlen, sk);
+        if (ret == 0) {
+            ret = send_signature_piece(sink, sig, siglen);
+        }
+        free(sig);
+        return ret;
+    }
+#endif
 
-        memcpy(m, sm + 2, *mlen);
-        free(signature);
+// Sends m, then its signature; the number of signature bytes sent goes to
+// *siglen.
+int send_signed_message(const uint8_t* m, size_t mlen, size_t* siglen,
+    const uint8_t* sk, enum DSA_ALGO algo) {
+        struct frame_sink sink;
+        *siglen = 0;
+        if (frame_sink_start(&sink) != 0) return -1;
+
+        int ret = send_message(m, mlen) < 0 ? -1 : 0;
+        if (ret == 0) {
+#ifdef CONFIG_TEST_STREAM_SIGNATURES
+            ret = dsa_signature_stream(algo, m, mlen, sk, send_signature_piece, &sink);
+#else
+            ret = sign_then_send(m, mlen, sk, algo, &sink);
+#endif
+        }
+        *siglen = sink.total;
+        if (frame_sink_finish(&sink) != 0) {
+            ret = -1;
+        }
+        return ret;
+    }
+
+// How long Bob waits for the next frame of a signed message. Alice may
+// compute a whole SPHINCS+ signature, or one hypertree layer of it, between
+// two frames, which takes seconds on the ESP32.
+#define SIGNED_MESSAGE_FRAME_TIMEOUT_MS 120000
+
+static bool receive_frame(message_struct_t* frame) {
+    return xQueueReceive(receive_queue, frame, pdMS_TO_TICKS(SIGNED_MESSAGE_FRAME_TIMEOUT_MS)) == pdTRUE;
+}
+
+// Receives a message and its signature frames, and verifies them as they
+// come in (dsa_verify_stream_update()), so that Bob holds one frame rather
+// than the whole signature. The signature ends with a frame shorter than
+// SIGNATURE_FRAME_BYTES (Falcon signatures are shorter than the maximum of
+// the algorithm) or once the maximum has arrived. Fails if Alice stops
+// sending for SIGNED_MESSAGE_FRAME_TIMEOUT_MS. On success the message is
+// returned in *m, to be freed by the caller.
+int receive_signed_message(uint8_t** m, size_t* mlen, const uint8_t* pk,
+    enum DSA_ALGO algo) {
+        message_struct_t frame;
+        size_t sig_len = get_signature_length(algo);
+        size_t received = 0;
+
+        *m = NULL;
+        if (!receive_frame(&frame)) {
+            printf("Timed out waiting for the message\n");
+            return -1;
+        }
+        *m = frame.content;
+        *mlen = frame.size;
+        printf("Received message of size %zu\n", *mlen);
+
+        struct dsa_verify_stream* vs = dsa_verify_stream_new(algo, *m, *mlen, pk);
+        if (!vs) {
+            free(*m);
+            *m = NULL;
+            return -1;
+        }
+
+        while (received < sig_len) {
+            if (!receive_frame(&frame)) {
+                printf("Timed out after %zu signature bytes\n", received);
+                dsa_verify_stream_final(vs);
+                free(*m);
+                *m = NULL;
+                return -1;
+            }
+            if (dsa_verify_stream_update(vs, frame.content, frame.size) != 0) {
+                printf("Signature rejected after %zu bytes\n", received + frame.size);
+            }
+            received += frame.size;
+            free(frame.content);
+            if (frame.size < SIGNATURE_FRAME_BYTES) {
+                break;
+            }
+        }
+
+        if (dsa_verify_stream_final(vs) != 0) {
+            free(*m);
+            *m = NULL;
+            return -1;
+        }
         return 0;
     }
 
@@ -162,26 +398,14 @@ bool test_dsa_Alice(enum DSA_ALGO algo){
     int sent = send_message(pk, pk_len);
     //printf("Pk sent %d\n", sent);
 
-    // Sign message
-    uint8_t* signed_message = malloc(strlen(message) + sig_len);
-    if(!signed_message) {
-        printf("Failed to allocate memory for signed_message\n");
-        free_space_for_dsa(pk, sk);
-        free(signed_message);
-        return false;
-    }
-
-    size_t actual_sm_size = strlen(message) + sig_len;
-    if(crypto_sign_message(signed_message, &actual_sm_size, (const uint8_t*)message, strlen(message), sk, algo) != 0) {
+    // Send message, then its signature as it is computed
+    size_t actual_sig_size = 0;
+    if(send_signed_message((const uint8_t*)message, strlen(message), &actual_sig_size, sk, algo) != 0) {
         printf("Failed to sign message\n");
         free_space_for_dsa(pk, sk);
-        free(signed_message);
         return false;
     }
-
-    // Send signed message
-    sent = send_message(signed_message, actual_sm_size);
-    //printf("sm : %d\n", sent);
+    //printf("sig : %zu\n", actual_sig_size);
 
     // Wait for message
     bool isMessageReceived = false;
@@ -194,27 +418,21 @@ bool test_dsa_Alice(enum DSA_ALGO algo){
 
     // Verify message
     if(strlen(message) != messageReceived.size || memcmp(message, messageReceived.content, messageReceived.size) != 0) {
-        printf("sm :");
-        for(int i = 0; i < actual_sm_size; i++) {
-            printf("%02x", signed_message[i]);
-        }
-        printf("\n");
+        printf("Got back %zu bytes after a %zu byte signature\n", messageReceived.size, actual_sig_size);
 
         free_space_for_dsa(pk, sk);
-        free(signed_message);
         free(messageReceived.content);
         return false;
     }
 
     free_space_for_dsa(pk, sk);
-    free(signed_message);
     free(messageReceived.content);
     return true;
 }
 
 void test_dsa_Bob(enum DSA_ALGO algo){
     uint8_t *pk = NULL;
-    size_t pk_len = get_public_key_length(algo), sm_actual_len = 0;
+    size_t pk_len = get_public_key_length(algo);
     
     // Wait for pk
     printf("Waiting for public key\n");
@@ -233,43 +451,14 @@ void test_dsa_Bob(enum DSA_ALGO algo){
         }
     }
 
-    uint8_t* signed_message;
-
-    // Wait for signed message
+    // Wait for the message and its signature, and verify them
     printf("Waiting for signed message\n");
-    isMessageReceived = false;
-    while(!isMessageReceived){
-        if(xQueueReceive(receive_queue, &messageReceived, pdMS_TO_TICKS(1000)) == pdTRUE){
-            signed_message = messageReceived.content;
-            sm_actual_len = messageReceived.size;
-            isMessageReceived = true;
-            printf("Received sm of size %zu\n", sm_actual_len);
-        }
-    }
-
-    // Decrypt message
-    printf("Decrypting message\n");
-    uint8_t* message_to_send = malloc(strlen(message) + 20);
-    if(!message_to_send) {
-        send_message((uint8_t*)failed_message, strlen(failed_message));
-        printf("Unable to allocate space\n");
-        free(pk);
-        free(signed_message);
-        free(message_to_send);
-        return;
-    }
+    uint8_t* message_to_send = NULL;
     size_t message_len = 0;
-    if(crypto_open_message(message_to_send, &message_len, signed_message, sm_actual_len, pk, algo) != 0) {
+    if(receive_signed_message(&message_to_send, &message_len, pk, algo) != 0) {
         send_message((uint8_t*)failed_message, strlen(failed_message));
-        printf("Sm :");
-        for(int i = 0; i < sm_actual_len; i++) {
-            printf("%02x", signed_message[i]);
-        }
-        printf("\n");
         free(pk);
-        free(signed_message);
-        free(message_to_send);
-        printf("failed to decrypt message\n");
+        printf("failed to verify message\n");
         return;
     }
 
@@ -278,7 +467,6 @@ void test_dsa_Bob(enum DSA_ALGO algo){
     send_message(message_to_send, message_len);
 
     free(pk);
-    free(signed_message);
     free(message_to_send);
 
     return;
@@ -341,12 +529,51 @@ void task_test_all_dsa(void *pvParameter)
     vTaskDelay(1000 / portTICK_PERIOD_MS);
     for(;;){
         test_dsa_all_alice_bob();
+        printf("Test task stack: %u bytes never used\n",
+            (unsigned)uxTaskGetStackHighWaterMark(NULL));
         vTaskDelete(NULL);
     }
 }
 
+#ifdef CONFIG_STACK_PROFILE_MODE
+void task_stack_profile(void *pvParameter)
+{
+    vTaskDelay(1000 / portTICK_PERIOD_MS);
+    printf("Stack profile, copy into components/DSA/src/dsa_stack_budget.h:\n");
+    if (dsa_stack_profile_header(stdout, STACK_PROFILE_ITERATIONS) != 0) {
+        printf("Stack profiling failed\n");
+    }
+    vTaskDelete(NULL);
+}
+#endif
+
+// Largest stack budget of the algorithms under test, plain or streamed,
+// plus room for printf and the transport (CONFIG_TEST_TASK_STACK_MARGIN).
+static uint32_t test_task_stack_size(void)
+{
+    size_t budget = 0;
+    for (size_t i = 0; i < num_algorithms; i++) {
+        const struct dsa_descriptor *d = dsa_get_descriptor(algorithms[i]);
+        for (int op = 0; d && op < DSA_OP_COUNT; op++) {
+            if (d->stack_bytes[op] > budget) {
+                budget = d->stack_bytes[op];
+            }
+            if (d->stack_stream_bytes[op] > budget) {
+                budget = d->stack_stream_bytes[op];
+            }
+        }
+    }
+    return budget + CONFIG_TEST_TASK_STACK_MARGIN;
+}
+
 void app_main(void)
 {    
+#ifdef CONFIG_STACK_PROFILE_MODE
+    if(xTaskCreatePinnedToCore(&task_stack_profile, "task_stack_profile", STACK_PROFILE_TASK_STACK_SIZE, NULL, 1, NULL, 0) != pdPASS) {
+        printf("Couldn't create task\n");
+    }
+    return;
+#endif
     setup_transport();
     while (!initialized) {
         vTaskDelay(pdMS_TO_TICKS(100));
@@ -355,7 +582,7 @@ void app_main(void)
     if(xTaskCreatePinnedToCore(&receive_task, "receive_task", 2048, NULL, 5, NULL, 1) != pdPASS) {
         printf("Couldn't create receive task\n");
     }
-    if(xTaskCreatePinnedToCore(&task_test_all_dsa, "task_test_all_dsa", 130000, NULL, 1, NULL, 0) != pdPASS) {
+    if(xTaskCreatePinnedToCore(&task_test_all_dsa, "task_test_all_dsa", test_task_stack_size(), NULL, 1, NULL, 0) != pdPASS) {
         printf("Couldn't create task\n");
     }
 }
\ No newline at end of file
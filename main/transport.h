@@ -11,6 +11,16 @@ typedef struct {
     size_t size; //total size of frame content
 } message_struct_t;
 
+// Signatures travel in frames of up to SIGNATURE_FRAME_BYTES after the
+// message frame. The receive queue only holds a few of them, so that the
+// receiver never buffers a whole SPHINCS+ signature: while a streaming
+// verify is busy with one frame, the next ones wait in the queue, and once
+// it is full the transport waits up to RECEIVE_QUEUE_TIMEOUT_MS for room
+// before it drops a frame (which fails that verification).
+#define SIGNATURE_FRAME_BYTES 2048
+#define RECEIVE_QUEUE_LENGTH 4
+#define RECEIVE_QUEUE_TIMEOUT_MS 2000
+
 extern QueueHandle_t receive_queue;
 extern bool initialized;
 